@@ -0,0 +1,119 @@
+/**
+ * BenchmarkAcquisition.cpp
+ *
+ * Host version of the acquisition benchmark of the settings page.
+ * Runs the acquire, compute and draw cycle with the simulated ADC / DMA for each timebase
+ * and prints acquisitions per second, trigger hit rate and cycles per sample.
+ *
+ * Acquisitions per second are computed with the simulated time, which only advances with the sample period.
+ * So they are the upper limit given by the sampling and the trigger timeout, not the value of the target.
+ * Cycles are cycles of the time stamp counter of the host.
+ *
+ * Usage: BenchmarkAcquisition [-w sine|square|noise|burst] [-f <frequency in Hz>] [-n <noise amplitude>] [-c <csv file>]
+ * Without -f the frequency is adjusted to 2.5 divisions per period for each timebase.
+ *
+ * @date 17.10.2026
+ * @copyright LGPL v3 (http://www.gnu.org/licenses/lgpl.html)
+ */
+
+#include "HostTarget.h"
+#include "Waveforms.h"
+#include "Pages.h"
+#include "TouchDSO.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCHMARK_MIN_ACQUISITIONS_PER_TIMEBASE 3
+
+/**
+ * Host version of runAcquisitionBenchmarkLoop() of TouchDSOGui.cpp
+ * Like on target the acquisition is stopped at the end, so the timebase is never changed during an acquisition.
+ */
+static void runAcquisitionBenchmarkLoop(void) {
+    resetAcquisitionStatistics();
+    startAcquisition();
+    do {
+        hostRunAcquisitionCycle();
+    } while (getMillisSinceBoot() - AcquisitionInfo.StartMillis <= BENCHMARK_MILLIS_PER_TIMEBASE
+            || AcquisitionInfo.AcquisitionCount < BENCHMARK_MIN_ACQUISITIONS_PER_TIMEBASE);
+    ADC_StopConversion(DSO_ADC_ID );
+    ADC_disableEOCInterrupt(DSO_ADC_ID );
+}
+
+static void printUsage(void) {
+    fprintf(stderr,
+            "Usage: BenchmarkAcquisition [-w sine|square|noise|burst] [-f <frequency in Hz>] [-n <noise amplitude>] [-c <csv file>]\n");
+}
+
+int main(int argc, char *argv[]) {
+    uint8_t tWaveformType = WAVEFORM_SINE;
+    float tFrequency = 0;
+    uint16_t tNoiseAmplitude = 0;
+    const char * tCSVFilename = NULL;
+    for (int i = 1; i < argc - 1; i += 2) {
+        if (strcmp(argv[i], "-w") == 0) {
+            for (tWaveformType = 0; tWaveformType < WAVEFORM_CSV; ++tWaveformType) {
+                if (strcmp(argv[i + 1], WaveformNames[tWaveformType]) == 0) {
+                    break;
+                }
+            }
+        } else if (strcmp(argv[i], "-f") == 0) {
+            tFrequency = atof(argv[i + 1]);
+        } else if (strcmp(argv[i], "-n") == 0) {
+            tNoiseAmplitude = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "-c") == 0) {
+            tCSVFilename = argv[i + 1];
+        } else {
+            tWaveformType = WAVEFORM_CSV;
+        }
+    }
+    if (tWaveformType == WAVEFORM_CSV || (argc % 2) == 0) {
+        printUsage();
+        return 1;
+    }
+
+    hostSetSignalSource(&getWaveformValue);
+    hostInitDSO();
+    AcquisitionInfo.isBenchmarkActive = true;
+
+    printf("Waveform %s\n", tCSVFilename != NULL ? tCSVFilename : WaveformNames[tWaveformType]);
+    printf("Timebase  Mode     Acq/s Trigger Cycles/Sample Packed Stat\n");
+    for (int i = 0; i < TIMEBASE_NUMBER_OF_ENTRIES; ++i) {
+        float tDivMicros = getTimebaseExactValueMicros(i);
+        setWaveform(tWaveformType, (tFrequency != 0) ? tFrequency : 1000000 / (2.5 * tDivMicros), 2048, 1500, tNoiseAmplitude);
+        if (tCSVFilename != NULL && !readWaveformCSV(tCSVFilename)) {
+            fprintf(stderr, "Cannot read %s\n", tCSVFilename);
+            return 1;
+        }
+        MeasurementControl.TimebaseNewIndex = i;
+        changeTimeBase(false);
+        MeasurementControl.isDeepMemoryMode = false;
+        runAcquisitionBenchmarkLoop();
+        computeAcquisitionStatistics(&AcquisitionBenchmarkResults[i]);
+
+        AcquisitionBenchmarkResults[i].PackedCyclesPerSample = 0;
+        if (i >= TIMEBASE_FAST_MODES && i < BENCHMARK_PACKED_TIMEBASE_INDEX_END) {
+            // packing is only done for the last acquisition
+            AcquisitionBenchmarkResultStruct tPackedResult;
+            MeasurementControl.isDeepMemoryMode = true;
+            MeasurementControl.StopRequested = true;
+            runAcquisitionBenchmarkLoop();
+            MeasurementControl.StopRequested = false;
+            computeAcquisitionStatistics(&tPackedResult);
+            AcquisitionBenchmarkResults[i].PackedCyclesPerSample = tPackedResult.CyclesPerSample;
+            MeasurementControl.isDeepMemoryMode = false;
+        }
+
+        char tUnitChar = getTimebaseUnitChar(i);
+        if (tUnitChar == (char) 0xB5) {
+            // micro of display font is no valid UTF-8
+            tUnitChar = 'u';
+        }
+        printf("%4u%cs   %-5s %10.1f %6u%% %13u %6u %4u\n", TimebaseDivValues[i], tUnitChar,
+                (i < TIMEBASE_FAST_MODES) ? "DMA" : "ISR", AcquisitionBenchmarkResults[i].AcquisitionsPerSecond,
+                AcquisitionBenchmarkResults[i].TriggerHitPercent, AcquisitionBenchmarkResults[i].CyclesPerSample,
+                AcquisitionBenchmarkResults[i].PackedCyclesPerSample, AcquisitionBenchmarkResults[i].StatisticsCyclesPerSample);
+    }
+    return 0;
+}
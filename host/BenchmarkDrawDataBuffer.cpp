@@ -0,0 +1,230 @@
+/**
+ * BenchmarkDrawDataBuffer.cpp
+ *
+ * Compares drawDataBuffer(), which selects a fill function specialized for the X scale class
+ * and a draw function specialized for line mode and clear before drawing once per call,
+ * with the generic loop of the baseline drawDataBuffer(), which checks X scale and draw mode for each column.
+ * The generic loop is taken with the RawToDisplayTable loads, so only the specialization differs.
+ * Both draw a 320 column frame into the frame buffer of the host for pixel and line mode, with and without clearing
+ * the old values, at the X scales of all scale classes.
+ * For compress factors greater than 1.5 drawDataBuffer() draws the min / max envelope with lines,
+ * the baseline draws the average, so these rows compare different work.
+ *
+ * Cycles are cycles of the time stamp counter of the host, the minimum of several batches is printed.
+ *
+ * @date 17.10.2026
+ * @copyright LGPL v3 (http://www.gnu.org/licenses/lgpl.html)
+ */
+
+#include "HostTarget.h"
+#include "Waveforms.h"
+#include "Pages.h"
+#include "TouchDSO.h"
+#include <stdio.h>
+
+#define BENCHMARK_BATCHES 20
+#define BENCHMARK_REPETITIONS 50
+#define TRIGGER_HIGH_DISPLAY_OFFSET 7 // from TouchDSODisplay.cpp
+
+uint32_t hostReadCycleCounter(void);
+
+extern uint8_t DisplayBuffer2[DSO_DISPLAY_WIDTH];
+
+static const int BenchmarkXScales[] = { -10, -2, -1, 0, 1, 2, 8, 31 };
+
+/**
+ * drawDataBuffer() of the baseline with RawToDisplayTable instead of getDisplayFrowRawInputValue()
+ */
+static void drawDataBufferGeneric(uint16_t *aDataBufferPointer, int aLength, uint16_t aColor, uint16_t aClearBeforeColor) {
+    int i;
+    int j = 0;
+    int tValue;
+
+    int tLastValue;
+    int tLastValueClear = DisplayBuffer[0];
+
+    uint8_t *ScreenBufferReadPointer = &DisplayBuffer[0];
+    uint8_t *ScreenBufferWritePointer1 = &DisplayBuffer[0];
+    uint8_t *ScreenBufferWritePointer2 = &DisplayBuffer2[0]; // for trigger state line
+    int tXScale = DisplayControl.XScale;
+    int tXScaleCounter = tXScale;
+    int tTriggerValue = getDisplayFrowRawInputValue(MeasurementControl.RawTriggerLevel);
+    if (tXScale <= 0) {
+        tXScaleCounter = -tXScale;
+    }
+
+    for (i = 0; i < aLength; ++i) {
+        if (aDataBufferPointer == NULL) {
+            // get data from screen buffer in order to erase it
+            tValue = *ScreenBufferReadPointer++;
+        } else {
+            tValue = RawToDisplayTable[*aDataBufferPointer];
+            /*
+             * get data from data buffer and perform X scaling
+             */
+            if (tXScale == 0) {
+                aDataBufferPointer++;
+            } else if (tXScale < -1) {
+                // compress - get average of multiple values
+                int tAdcValue = 0;
+                for (int k = 0; k < tXScaleCounter; ++k) {
+                    tAdcValue += *aDataBufferPointer++;
+                }
+                tValue = RawToDisplayTable[tAdcValue / tXScaleCounter];
+            } else if (tXScale == -1) {
+                // compress by factor 1.5 - every second value is the average of the next two values
+                aDataBufferPointer++;
+                tXScaleCounter--;
+                if (tXScaleCounter < 0) {
+                    if (tValue != DISPLAYBUFFER_INVISIBLE_VALUE) {
+                        // get average of actual and next value
+                        tValue += RawToDisplayTable[*aDataBufferPointer++];
+                        tValue /= 2;
+                    }
+                    tXScaleCounter = 1;
+                }
+            } else if (tXScale == 1) {
+                aDataBufferPointer++;
+                // expand by factor 1.5 - every second value will be shown 2 times
+                tXScaleCounter--; // starts with 1
+                if (tXScaleCounter < 0) {
+                    aDataBufferPointer--;
+                    tXScaleCounter = 2;
+                }
+            } else {
+                // expand - show value several times
+                if (tXScaleCounter == 0) {
+                    aDataBufferPointer++;
+                    tXScaleCounter = tXScale;
+                }
+                tXScaleCounter--;
+            }
+        }
+
+        // draw trigger state line (aka Digital mode)
+        if (DisplayControl.DisplayBufferDrawMode & DRAW_MODE_TRIGGER) {
+            if (aClearBeforeColor > 0) {
+                LocalDisplay.drawPixel(i, *ScreenBufferWritePointer2, aClearBeforeColor);
+            }
+            if (tValue > tTriggerValue) {
+                LocalDisplay.drawPixel(i, tTriggerValue - TRIGGER_HIGH_DISPLAY_OFFSET, COLOR_DATA_TRIGGER);
+                *ScreenBufferWritePointer2++ = tTriggerValue - TRIGGER_HIGH_DISPLAY_OFFSET;
+            }
+        }
+
+        if (!(DisplayControl.DisplayBufferDrawMode & DRAW_MODE_LINE) || i == 0) {
+            /*
+             * Pixel Mode or first value of chart
+             */
+            if (aDataBufferPointer == NULL && j == TIMING_GRID_WIDTH) {
+                // Restore grid pixel instead of clearing it
+                j = 0;
+                if (tValue != DISPLAYBUFFER_INVISIBLE_VALUE) {
+                    LocalDisplay.drawPixel(i, tValue, COLOR_GRID_LINES);
+                }
+            } else {
+                j++;
+                if (aClearBeforeColor > 0) {
+                    int tValueClear = *ScreenBufferReadPointer++;
+                    if (tValueClear != DISPLAYBUFFER_INVISIBLE_VALUE) {
+                        LocalDisplay.drawPixel(i, tValueClear, aClearBeforeColor);
+                    }
+                    if (DisplayControl.DisplayBufferDrawMode & DRAW_MODE_LINE) {
+                        // erase first line in advance and set pointer
+                        tLastValueClear = tValueClear;
+                        tValueClear = *ScreenBufferReadPointer++;
+                        if (tValueClear != DISPLAYBUFFER_INVISIBLE_VALUE) {
+                            if (tLastValueClear != DISPLAYBUFFER_INVISIBLE_VALUE) {
+                                // Normal mode - clear line
+                                LocalDisplay.drawLineFastOneX(i, tLastValueClear, tValueClear, aClearBeforeColor);
+                            } else {
+                                // first visible value just clear start pixel
+                                LocalDisplay.drawPixel(i, tValueClear, aClearBeforeColor);
+                            }
+                        }
+                        tLastValueClear = tValueClear;
+                    }
+                }
+                if (tValue != DISPLAYBUFFER_INVISIBLE_VALUE) {
+                    LocalDisplay.drawPixel(i, tValue, aColor);
+                }
+            }
+        } else {
+            /*
+             * Line mode here
+             */
+            if (aClearBeforeColor > 0 && i != DSO_DISPLAY_WIDTH - 1) {
+                // erase one x value in advance in order not to overwrite the x+1 part of line just drawn before
+                int tValueClear = *ScreenBufferReadPointer++;
+                if (tLastValueClear != DISPLAYBUFFER_INVISIBLE_VALUE && tValueClear != DISPLAYBUFFER_INVISIBLE_VALUE) {
+                    LocalDisplay.drawLineFastOneX(i, tLastValueClear, tValueClear, aClearBeforeColor);
+                }
+                tLastValueClear = tValueClear;
+            }
+            // is initialized on i == 0
+            if (tValue != DISPLAYBUFFER_INVISIBLE_VALUE) {
+                if (tLastValue != DISPLAYBUFFER_INVISIBLE_VALUE) {
+                    // Normal mode - draw line
+                    if (tLastValue == tValue && (tValue == DISPLAY_VALUE_FOR_ZERO || tValue == 0)) {
+                        // clipping occurs draw red line
+                        LocalDisplay.drawLineFastOneX(i - 1, tLastValue, tValue, COLOR_DATA_RUN_CLIPPING);
+                    } else {
+                        LocalDisplay.drawLineFastOneX(i - 1, tLastValue, tValue, aColor);
+                    }
+                } else {
+                    // first visible value just draw start pixel
+                    LocalDisplay.drawPixel(i, tValue, aColor);
+                }
+            }
+        }
+        tLastValue = tValue;
+        // store data in screen buffer
+        *ScreenBufferWritePointer1++ = tValue;
+    }
+}
+
+/**
+ * @return host cycles per frame - minimum of BENCHMARK_BATCHES batches to suppress interrupts and frequency changes of the host
+ */
+static uint32_t measureFrame(void (*aDrawFunction)(uint16_t *, int, uint16_t, uint16_t), uint16_t aClearBeforeColor) {
+    uint32_t tMinCycles = UINT32_MAX;
+    for (int tBatch = 0; tBatch < BENCHMARK_BATCHES; ++tBatch) {
+        uint32_t tStartCycles = hostReadCycleCounter();
+        for (int i = 0; i < BENCHMARK_REPETITIONS; ++i) {
+            aDrawFunction(&DataBufferControl.DataBuffer[0], DSO_DISPLAY_WIDTH, COLOR_DATA_RUN, aClearBeforeColor);
+        }
+        uint32_t tCycles = (hostReadCycleCounter() - tStartCycles) / BENCHMARK_REPETITIONS;
+        if (tCycles < tMinCycles) {
+            tMinCycles = tCycles;
+        }
+    }
+    return tMinCycles;
+}
+
+int main(void) {
+    hostInitDSO();
+    // running acquisition, so compressed data is not taken from the min / max pyramid
+    MeasurementControl.isRunning = true;
+    // 10 periods in the buffer
+    setWaveform(WAVEFORM_SINE, 1000000.0 / (DATABUFFER_SIZE / 10), 2048, 1500, 20);
+    for (int i = 0; i < DATABUFFER_SIZE; ++i) {
+        DataBufferControl.DataBuffer[i] = getWaveformValue(i);
+    }
+
+    printf("Mode  Clear XScale Generic Specialized Speedup\n");
+    for (int tLineMode = 0; tLineMode < 2; ++tLineMode) {
+        DisplayControl.DisplayBufferDrawMode = tLineMode ? DRAW_MODE_LINE : 0;
+        for (int tClear = 0; tClear < 2; ++tClear) {
+            uint16_t tClearBeforeColor = tClear ? DisplayControl.EraseColor : 0;
+            for (unsigned int i = 0; i < sizeof(BenchmarkXScales) / sizeof(BenchmarkXScales[0]); ++i) {
+                DisplayControl.XScale = BenchmarkXScales[i];
+                uint32_t tGenericCycles = measureFrame(&drawDataBufferGeneric, tClearBeforeColor);
+                uint32_t tSpecializedCycles = measureFrame(&drawDataBuffer, tClearBeforeColor);
+                printf("%-5s %-5s %6d %7u %11u %7.1f%s\n", tLineMode ? "line" : "pixel", tClear ? "yes" : "no",
+                        BenchmarkXScales[i], tGenericCycles, tSpecializedCycles, (float) tGenericCycles / tSpecializedCycles,
+                        BenchmarkXScales[i] < -1 ? " envelope" : "");
+            }
+        }
+    }
+    return 0;
+}
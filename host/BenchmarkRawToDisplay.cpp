@@ -0,0 +1,176 @@
+/**
+ * BenchmarkRawToDisplay.cpp
+ *
+ * Compares the conversion of the raw values of a 320 column frame to display values for each X scale
+ * with computeDisplayFromRawInputValue() for each value, as done before RawToDisplayTable was introduced,
+ * and with one load from RawToDisplayTable for each value.
+ * Both use the X scaling loop of the baseline drawDataBuffer(), so only the conversion differs,
+ * and both must give the same display values.
+ * The mapping is measured for DC and for AC mode with an input range other than the display range,
+ * which is the most expensive computation.
+ *
+ * Cycles are cycles of the time stamp counter of the host, the minimum of several batches is printed.
+ *
+ * @date 17.10.2026
+ * @copyright LGPL v3 (http://www.gnu.org/licenses/lgpl.html)
+ */
+
+#include "HostTarget.h"
+#include "Waveforms.h"
+#include "Pages.h"
+#include "TouchDSO.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BENCHMARK_BATCHES 20
+#define BENCHMARK_REPETITIONS 100
+#define BENCHMARK_XSCALE_MIN (-DATABUFFER_DISPLAY_RESOLUTION_FACTOR)
+#define BENCHMARK_XSCALE_MAX 31 // xScaleForTimebase[0]
+#define BENCHMARK_INVISIBLE_VALUES 32 // invisible values of pre trigger area at start of buffer
+
+uint32_t hostReadCycleCounter(void);
+
+static uint8_t BaselineValues[DSO_DISPLAY_WIDTH];
+static uint8_t TableValues[DSO_DISPLAY_WIDTH];
+
+/**
+ * computeDisplayFromRawInputValue() of TouchDSODisplay.cpp, which was getDisplayFrowRawInputValue() of the baseline
+ */
+static int computeBaselineDisplayFromRawInputValue(int aAdcValue) {
+    if (aAdcValue == DATABUFFER_INVISIBLE_RAW_VALUE) {
+        return DISPLAYBUFFER_INVISIBLE_VALUE;
+    }
+    if (MeasurementControl.isACMode) {
+        aAdcValue -= MeasurementControl.RawDSOReadingACZero;
+    }
+    if (MeasurementControl.InputRangeIndexOtherThanDisplayRange) {
+        aAdcValue = aAdcValue * FactorFromInputToDisplayRangeShift12;
+        aAdcValue >>= DSO_INPUT_TO_DISPLAY_SHIFT;
+    }
+    aAdcValue = aAdcValue - MeasurementControl.RawOffsetValueForDisplayRange;
+    if (aAdcValue < 0) {
+        return DISPLAY_VALUE_FOR_ZERO;
+    }
+    aAdcValue *= ScaleFactorRawToDisplayShift18[MeasurementControl.DisplayRangeIndex];
+    aAdcValue >>= DSO_SCALE_FACTOR_SHIFT;
+    if (aAdcValue > DISPLAY_VALUE_FOR_ZERO) {
+        aAdcValue = 0;
+    } else {
+        aAdcValue = (DISPLAY_VALUE_FOR_ZERO) - aAdcValue;
+    }
+    return aAdcValue;
+}
+
+static inline int getBaselineDisplayValue(int aAdcValue) {
+    return computeBaselineDisplayFromRawInputValue(aAdcValue);
+}
+
+static inline int getTableDisplayValue(int aAdcValue) {
+    return RawToDisplayTable[aAdcValue];
+}
+
+/**
+ * X scaling of the baseline drawDataBuffer() without drawing, GetDisplayValue is inlined for each instantiation
+ */
+template<int (*GetDisplayValue)(int)>
+static void fillBaselineDisplayValues(uint16_t * aDataBufferPointer, uint8_t * aDisplayValues, int aLength, int aXScale) {
+    int tXScaleCounter = aXScale;
+    if (aXScale <= 0) {
+        tXScaleCounter = -aXScale;
+    }
+    for (int i = 0; i < aLength; ++i) {
+        int tValue = GetDisplayValue(*aDataBufferPointer);
+        if (aXScale == 0) {
+            aDataBufferPointer++;
+        } else if (aXScale < -1) {
+            // getDisplayFrowMultipleRawValues() of the baseline
+            int tAdcValue = 0;
+            for (int j = 0; j < tXScaleCounter; ++j) {
+                tAdcValue += *aDataBufferPointer++;
+            }
+            tValue = GetDisplayValue(tAdcValue / tXScaleCounter);
+        } else if (aXScale == -1) {
+            aDataBufferPointer++;
+            tXScaleCounter--;
+            if (tXScaleCounter < 0) {
+                if (tValue != DISPLAYBUFFER_INVISIBLE_VALUE) {
+                    tValue += GetDisplayValue(*aDataBufferPointer++);
+                    tValue /= 2;
+                }
+                tXScaleCounter = 1;
+            }
+        } else if (aXScale == 1) {
+            aDataBufferPointer++;
+            tXScaleCounter--;
+            if (tXScaleCounter < 0) {
+                aDataBufferPointer--;
+                tXScaleCounter = 2;
+            }
+        } else {
+            if (tXScaleCounter == 0) {
+                aDataBufferPointer++;
+                tXScaleCounter = aXScale;
+            }
+            tXScaleCounter--;
+        }
+        *aDisplayValues++ = tValue;
+    }
+}
+
+/**
+ * @return host cycles per frame - minimum of BENCHMARK_BATCHES batches to suppress interrupts and frequency changes of the host
+ */
+static uint32_t measureFrame(void (*aFillFunction)(uint16_t *, uint8_t *, int, int), uint8_t * aDisplayValues, int aXScale) {
+    uint32_t tMinCycles = UINT32_MAX;
+    for (int tBatch = 0; tBatch < BENCHMARK_BATCHES; ++tBatch) {
+        uint32_t tStartCycles = hostReadCycleCounter();
+        for (int i = 0; i < BENCHMARK_REPETITIONS; ++i) {
+            aFillFunction(&DataBufferControl.DataBuffer[0], aDisplayValues, DSO_DISPLAY_WIDTH, aXScale);
+            // keep the compiler from merging the repetitions
+            __asm__ volatile("" ::: "memory");
+        }
+        uint32_t tCycles = (hostReadCycleCounter() - tStartCycles) / BENCHMARK_REPETITIONS;
+        if (tCycles < tMinCycles) {
+            tMinCycles = tCycles;
+        }
+    }
+    return tMinCycles;
+}
+
+/**
+ * @return number of X scales with different display values
+ */
+static int runBenchmark(const char * aMappingName) {
+    initRawToDisplayTable();
+    printf("%s\nXScale Computed Table  Speedup\n", aMappingName);
+    int tDifferentCount = 0;
+    for (int tXScale = BENCHMARK_XSCALE_MIN; tXScale <= BENCHMARK_XSCALE_MAX; ++tXScale) {
+        uint32_t tBaselineCycles = measureFrame(&fillBaselineDisplayValues<getBaselineDisplayValue>, BaselineValues, tXScale);
+        uint32_t tTableCycles = measureFrame(&fillBaselineDisplayValues<getTableDisplayValue>, TableValues, tXScale);
+        bool tEqual = memcmp(BaselineValues, TableValues, DSO_DISPLAY_WIDTH) == 0;
+        if (!tEqual) {
+            tDifferentCount++;
+        }
+        printf("%6d %8u %5u %7.1f%s\n", tXScale, tBaselineCycles, tTableCycles, (float) tBaselineCycles / tTableCycles,
+                tEqual ? "" : " values differ");
+    }
+    return tDifferentCount;
+}
+
+int main(void) {
+    hostInitDSO();
+    // 10 periods in the buffer, clipped at top and bottom
+    setWaveform(WAVEFORM_SINE, 1000000.0 / (DATABUFFER_SIZE / 10), 2048, 2500, 20);
+    for (int i = 0; i < DATABUFFER_SIZE; ++i) {
+        DataBufferControl.DataBuffer[i] = (i < BENCHMARK_INVISIBLE_VALUES) ? DATABUFFER_INVISIBLE_RAW_VALUE : getWaveformValue(i);
+    }
+
+    int tDifferentCount = runBenchmark("DC, input range is display range");
+
+    MeasurementControl.isACMode = true;
+    MeasurementControl.RawDSOReadingACZero = 2048;
+    MeasurementControl.InputRangeIndexOtherThanDisplayRange = true;
+    FactorFromInputToDisplayRangeShift12 = (5 << DSO_INPUT_TO_DISPLAY_SHIFT) / 2;
+    tDifferentCount += runBenchmark("\nAC, input range is not display range");
+    return tDifferentCount;
+}
@@ -0,0 +1,403 @@
+/**
+ * HostTarget.cpp
+ *
+ * Simulated peripherals, system functions and display for the host build of the DSO sources.
+ * See HostTarget.h
+ *
+ * @date 17.10.2026
+ * @copyright LGPL v3 (http://www.gnu.org/licenses/lgpl.html)
+ */
+
+#include "HostTarget.h"
+#include "Pages.h"
+#include "TouchDSO.h"
+#include "Chart.h"
+#include <string.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#if !(defined(__x86_64__) || defined(__i386__))
+#include <time.h>
+#endif
+
+/*
+ * Registers
+ */
+ADC_TypeDef HostADC1;
+DMA_Channel_TypeDef HostDMA1Channel1;
+SysTick_Type HostSysTick;
+GPIO_TypeDef HostGPIO;
+DWT_Type HostDWT;
+CoreDebug_Type HostCoreDebug;
+
+double HostMicros = 0;
+
+static uint16_t (*sSignalSource)(double aMicros);
+static double sSamplePeriodMicros = 1;
+static bool sConversionRunning;
+static bool sEOCInterruptEnabled;
+static uint32_t sSamplesOfAcquisition;
+
+struct HostDMAStruct {
+    uint16_t * Destination;
+    uint16_t Count;
+    uint16_t Position;
+    bool Enabled;
+    uint32_t PendingFlags;
+};
+static HostDMAStruct sDMA;
+
+// interrupt handlers of TouchDSOAcquisition.cpp
+extern "C" void DMA1_Channel1_IRQHandler(void);
+extern "C" void ADC1_2_IRQHandler(void);
+
+/*
+ * Globals of modules which are not compiled for host
+ */
+char StringBuffer[SIZEOF_STRINGBUFFER];
+uint16_t FourDisplayLinesBuffer[SIZEOF_DISPLAYLINE_BUFFER];
+const int FUNCTION_TAG_DRAW_CHART = 0x64;
+float ADCToVoltFactor = 3.0 / 4096;
+unsigned int sADCScaleFactorShift18 = (240 << ADC_SCALE_FACTOR_SHIFT) / 4096;
+uint16_t sReading3Volt = 4096;
+const char * const ADCInputMUXChannelStrings[ADC_CHANNEL_COUNT] = { "Ch 1", "Ch 2", "Ch 3", "Temp", "VBat", "VRef" };
+char ADCInputMUXChannelChars[ADC_CHANNEL_COUNT] = { '1', '2', '3', 'T', 'B', 'R' };
+uint8_t ADCInputMUXChannels[ADC_CHANNEL_COUNT] = { ADC1_INPUT1_CHANNEL, ADC1_INPUT2_CHANNEL, ADC1_INPUT3_CHANNEL, 0x10, 0x11, 0x12 };
+const char * const ADS7846ChannelStrings[ADS7846_CHANNEL_COUNT] = { "X", "Y", "Z1", "Z2", "Temp", "Temp1", "VBat", "Aux" };
+const char ADS7846ChannelChars[ADS7846_CHANNEL_COUNT] = { 'X', 'Y', 'z', 'Z', 't', 'T', 'B', 'A' };
+unsigned char ADS7846ChannelMapping[ADS7846_CHANNEL_COUNT] = { 0xD0, 0x90, 0xB0, 0xC0, 0x80, 0xF0, 0xA0, 0xE0 };
+
+/*
+ * Cycle counter and time
+ */
+uint32_t hostReadCycleCounter(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    struct timespec tTime;
+    clock_gettime(CLOCK_MONOTONIC, &tTime);
+    return tTime.tv_sec * 1000000000UL + tTime.tv_nsec;
+#endif
+}
+
+uint32_t getMillisSinceBoot(void) {
+    return HostMicros / 1000;
+}
+
+void delayMillis(int32_t aTimeMillis) {
+    HostMicros += aTimeMillis * 1000.0;
+}
+
+/*
+ * ADC, timer 6 and DMA
+ */
+void hostSetSignalSource(uint16_t (*aSignalSource)(double aMicros)) {
+    sSignalSource = aSignalSource;
+}
+
+/**
+ * One conversion at the next timer 6 edge
+ */
+static uint16_t convertNextSample(void) {
+    HostMicros += sSamplePeriodMicros;
+    sSamplesOfAcquisition++;
+    uint16_t tValue = sSignalSource(HostMicros);
+    if (tValue > ADC_MAX_CONVERSION_VALUE) {
+        tValue = ADC_MAX_CONVERSION_VALUE;
+    }
+    return tValue;
+}
+
+static void transferDMASample(void) {
+    sDMA.Destination[sDMA.Position++] = convertNextSample();
+    if (sDMA.Position == sDMA.Count / 2) {
+        sDMA.PendingFlags |= DMA1_IT_HT1;
+    }
+    if (sDMA.Position == sDMA.Count) {
+        sDMA.PendingFlags |= DMA1_IT_TC1;
+        sDMA.Enabled = false;
+    }
+}
+
+uint32_t hostReadDMACount(void) {
+    for (int i = 0; i < HOST_DMA_SAMPLES_PER_COUNT_READ && sDMA.Enabled; ++i) {
+        transferDMASample();
+    }
+    return sDMA.Count - sDMA.Position;
+}
+
+void ADC_SetTimer6Period(uint16_t aDivider, uint16_t aPrescaler) {
+    sSamplePeriodMicros = ((double) aDivider * aPrescaler) / (SYSCLK_VALUE / 1000000);
+}
+
+void ADC_DMA_start(uint32_t aMemoryBaseAddr, uint16_t aBufferSize) {
+    // host executable is linked with -no-pie, so the address of the data buffer fits in 32 bit
+    sDMA.Destination = (uint16_t *) (uintptr_t) aMemoryBaseAddr;
+    sDMA.Count = aBufferSize;
+    sDMA.Position = 0;
+    sDMA.Enabled = true;
+    sConversionRunning = true;
+}
+
+extern "C" ITStatus DMA_GetITStatus(uint32_t aFlag) {
+    return (sDMA.PendingFlags & aFlag) ? SET : RESET;
+}
+
+extern "C" void DMA_ClearITPendingBit(uint32_t aFlag) {
+    sDMA.PendingFlags &= ~aFlag;
+}
+
+extern "C" void ADC_StartConversion(ADC_TypeDef* ADCx) {
+    sConversionRunning = true;
+}
+
+extern "C" void ADC_StopConversion(ADC_TypeDef* ADCx) {
+    sConversionRunning = false;
+    sDMA.Enabled = false;
+}
+
+void ADC_enableEOCInterrupt(ADC_TypeDef* aADCId) {
+    sEOCInterruptEnabled = true;
+}
+
+void ADC_disableEOCInterrupt(ADC_TypeDef* aADCId) {
+    sEOCInterruptEnabled = false;
+}
+
+void ADC_startTimer6() {
+}
+void ADC_SetChannelSampleTime(ADC_TypeDef* aADCId, uint8_t aChannelNumber, bool aFastMode) {
+}
+void ADC_SetClockPrescaler(uint32_t aValue) {
+}
+void ADC_enableAndWait(ADC_TypeDef* aADCId) {
+}
+void ADC_disableAndWait(ADC_TypeDef* aADCId) {
+}
+void ADC_setRawToVoltFactor(void) {
+}
+uint16_t ADC1_getChannelValue(uint8_t aChannel) {
+    return ADC_MAX_CONVERSION_VALUE / 2;
+}
+
+static bool sACMode;
+void DSO_setACMode(bool aValue) {
+    sACMode = aValue;
+}
+bool DSO_getACMode(void) {
+    return sACMode;
+}
+void DSO_setAttenuator(uint8_t aValue) {
+}
+
+/**
+ * Converts samples and calls the interrupt handlers until the data buffer is full
+ * @return false if acquisition was not started or did not end after HOST_MAX_SAMPLES_PER_ACQUISITION samples
+ */
+bool hostRunAcquisition(void) {
+    sSamplesOfAcquisition = 0;
+    while (!DataBufferControl.DataBufferFull) {
+        if (sDMA.PendingFlags) {
+            DMA1_Channel1_IRQHandler();
+        } else if (sDMA.Enabled) {
+            transferDMASample();
+        } else if (sConversionRunning && sEOCInterruptEnabled) {
+            HostADC1.DR = convertNextSample();
+            ADC1_2_IRQHandler();
+        } else {
+            return false;
+        }
+        if (sSamplesOfAcquisition > HOST_MAX_SAMPLES_PER_ACQUISITION) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Converts aCount samples with the sample period of the actual timebase without running the interrupt handlers
+ */
+void hostConvertSamples(uint16_t * aBuffer, int aCount) {
+    for (int i = 0; i < aCount; ++i) {
+        aBuffer[i] = convertNextSample();
+    }
+}
+
+uint32_t hostGetSamplesOfLastAcquisition(void) {
+    return sSamplesOfAcquisition;
+}
+
+/**
+ * Settings of initDSO() and startDSO() without GUI. Range is fixed, trigger is automatic.
+ */
+void hostInitDSO(void) {
+    DisplayControl.EraseColors[0] = COLOR_BACKGROUND_DSO;
+    DisplayControl.EraseColors[1] = COLOR_DATA_ERASE_LOW;
+    DisplayControl.EraseColors[2] = COLOR_DATA_ERASE_MID;
+    DisplayControl.EraseColors[3] = COLOR_DATA_ERASE_HIGH;
+    DisplayControl.ShowFFT = false;
+    DisplayControl.FFTSize = FFT_SIZE;
+    DisplayControl.FFTWindowType = FFT_WINDOW_HANN;
+    DisplayControl.FFTAverageMode = FFT_AVERAGE_OFF;
+    DisplayControl.FFTShowDB = false;
+    DisplayControl.ShowHarmonics = false;
+    DisplayControl.FilterType = FILTER_TYPE_NONE;
+    DisplayControl.DatabufferPreTriggerDisplaySize = (2 * DATABUFFER_DISPLAY_RESOLUTION);
+    // initAcquisition() divides by the display factors which are computed later by resetAcquisition().
+    // The Cortex-M4 returns 0 for a division by zero, x86 raises an exception.
+    initRawToDisplayFactors();
+    initAcquisition();
+    resetAcquisition();
+
+    DisplayControl.DisplayPage = CHART;
+    DisplayControl.DisplayBufferDrawMode = DRAW_MODE_LINE;
+    DisplayControl.EraseColor = DisplayControl.EraseColors[0];
+    DisplayControl.EraseColorIndex = 0;
+    DisplayControl.XScale = 0;
+    DisplayControl.DisplayIncrementPixel = DATABUFFER_DISPLAY_INCREMENT;
+    MeasurementControl.RangeAutomatic = false;
+    MeasurementControl.isRunning = true;
+}
+
+/**
+ * Acquire, compute and draw cycle of loopDSO() for running acquisition without draw while acquire
+ * Acquisition must have been started before.
+ */
+void hostRunAcquisitionCycle(void) {
+    hostRunAcquisition();
+    if (MeasurementControl.RollModeActive) {
+        linearizeRollBuffer();
+    }
+    computeMinMaxAverageAndPeriodFrequency();
+    countAcquisitionForStatistics();
+    if (!(MeasurementControl.TimebaseFastDMAMode || DataBufferControl.DrawWhileAcquire)) {
+        setPreTriggerRing();
+    }
+    computeAutoTrigger();
+    computeAutoInputRange();
+    copyDataBufferDisplayRegion();
+    if (MeasurementControl.TimebaseIndex == TIMEBASE_INDEX_EQUIVALENT_TIME) {
+        foldEquivalentTimeSamples();
+        getEquivalentTimeValues(&DisplayDataBufferControl.DataBuffer[0]);
+    }
+    startAcquisition();
+    computeAutoDisplayRange();
+    drawDataBuffer(getFilteredDataBufferPointer(&DisplayDataBufferControl.DataBuffer[0], DSO_DISPLAY_WIDTH),
+            DSO_DISPLAY_WIDTH, COLOR_DATA_RUN, DisplayControl.EraseColor);
+}
+
+/*
+ * Error handling of assert.h
+ */
+extern "C" bool assertFailedParamMessage(uint8_t* aFile, uint32_t aLine, uint32_t aLinkRegister, int aWrongParameter,
+        const char * aMessage) {
+    fprintf(stderr, "%s:%u: %s 0x%X\n", aFile, (unsigned int) aLine, aMessage, aWrongParameter);
+    exit(1);
+}
+
+/*
+ * Display - draws into HostFrameBuffer
+ */
+uint16_t HostFrameBuffer[HOST_FRAME_BUFFER_HEIGHT][HOST_FRAME_BUFFER_WIDTH];
+
+static void fillFrameBuffer(int aXStart, int aYStart, int aXEnd, int aYEnd, uint16_t aColor) {
+    if (aXEnd >= HOST_FRAME_BUFFER_WIDTH) {
+        aXEnd = HOST_FRAME_BUFFER_WIDTH - 1;
+    }
+    if (aYEnd >= HOST_FRAME_BUFFER_HEIGHT) {
+        aYEnd = HOST_FRAME_BUFFER_HEIGHT - 1;
+    }
+    for (int y = aYStart; y <= aYEnd; ++y) {
+        for (int x = aXStart; x <= aXEnd; ++x) {
+            HostFrameBuffer[y][x] = aColor;
+        }
+    }
+}
+
+static void drawFrameBufferLineOneX(uint16_t aX, uint16_t aY0, uint16_t aY1, uint16_t aColor) {
+    if (aY0 > aY1) {
+        uint16_t tTemp = aY0;
+        aY0 = aY1;
+        aY1 = tTemp;
+    }
+    fillFrameBuffer(aX, aY0, aX, aY1, aColor);
+}
+
+BlueDisplay BlueDisplay1;
+BlueDisplay::BlueDisplay() {
+}
+void BlueDisplay::clearDisplay(uint16_t aColor) {
+    fillFrameBuffer(0, 0, HOST_FRAME_BUFFER_WIDTH - 1, HOST_FRAME_BUFFER_HEIGHT - 1, aColor);
+}
+void BlueDisplay::drawPixel(uint16_t aXPos, uint16_t aYPos, uint16_t aColor) {
+    fillFrameBuffer(aXPos, aYPos, aXPos, aYPos, aColor);
+}
+void BlueDisplay::fillRect(uint16_t aXStart, uint16_t aYStart, uint16_t aXEnd, uint16_t aYEnd, uint16_t aColor) {
+    fillFrameBuffer(aXStart, aYStart, aXEnd, aYEnd, aColor);
+}
+void BlueDisplay::fillRectRel(uint16_t aXStart, uint16_t aYStart, uint16_t aWidth, uint16_t aHeight, uint16_t aColor) {
+    fillFrameBuffer(aXStart, aYStart, aXStart + aWidth - 1, aYStart + aHeight - 1, aColor);
+}
+uint16_t BlueDisplay::drawText(uint16_t aXStart, uint16_t aYStart, const char *aStringPtr, uint8_t aFontSize, uint16_t aColor,
+        uint16_t aBGColor) {
+    return aXStart + strlen(aStringPtr) * aFontSize / 2;
+}
+void BlueDisplay::drawLineRel(uint16_t aXStart, uint16_t aYStart, uint16_t aXDelta, uint16_t aYDelta, uint16_t aColor) {
+    fillFrameBuffer(aXStart, aYStart, aXStart + aXDelta, aYStart + aYDelta, aColor);
+}
+void BlueDisplay::drawLineFastOneX(uint16_t x0, uint16_t y0, uint16_t y1, uint16_t color) {
+    drawFrameBufferLineOneX(x0, y0, y1, color);
+}
+void BlueDisplay::drawChartByteBuffer(uint16_t aXOffset, uint16_t aYOffset, uint16_t aColor, uint16_t aClearBeforeColor,
+        uint8_t *aByteBuffer, uint16_t aByteBufferLength) {
+}
+uint16_t BlueDisplay::getDisplayWidth(void) {
+    return HOST_FRAME_BUFFER_WIDTH;
+}
+uint16_t BlueDisplay::getDisplayHeight(void) {
+    return HOST_FRAME_BUFFER_HEIGHT;
+}
+
+MI0283QT2 LocalDisplay;
+MI0283QT2::MI0283QT2() {
+}
+void MI0283QT2::drawPixel(uint16_t aXPos, uint16_t aYPos, uint16_t aColor) {
+    fillFrameBuffer(aXPos, aYPos, aXPos, aYPos, aColor);
+}
+void MI0283QT2::drawLineFastOneX(uint16_t x0, uint16_t y0, uint16_t y1, uint16_t color) {
+    drawFrameBufferLineOneX(x0, y0, y1, color);
+}
+void MI0283QT2::drawIndexedLines(uint16_t aXStart, uint16_t aYStart, uint8_t *aIndexes, uint16_t aLength, uint8_t aPixelPerIndex,
+        uint16_t aHeight, const uint16_t *aPalette, uint8_t aIndexShift) {
+    for (int i = 0; i < aLength; ++i) {
+        fillFrameBuffer(aXStart + i * aPixelPerIndex, aYStart, aXStart + (i + 1) * aPixelPerIndex - 1, aYStart + aHeight - 1,
+                aPalette[aIndexes[i] >> aIndexShift]);
+    }
+}
+
+ADS7846 TouchPanel;
+ADS7846::ADS7846() {
+}
+uint16_t ADS7846::readChannel(uint8_t channel, bool use12Bit, bool useDiffMode, int numberOfReadingsToIntegrate) {
+    return 0;
+}
+
+bool USART_isBluetoothPaired(void) {
+    return false;
+}
+
+extern "C" void sendUSART5ArgsAndByteBuffer(uint8_t aFunctionTag, uint16_t aXStart, uint16_t aYStart, uint16_t aXEnd,
+        uint16_t aYEnd, uint16_t aColor, uint8_t * aBuffer, int aBufferLength) {
+}
+
+/*
+ * Used by utils.cpp
+ */
+bool RTC_DateIsValid = false;
+uint8_t RTC_getSecond(void) {
+    return 0;
+}
+int RTC_getTimeString(char * aStringBuffer) {
+    aStringBuffer[0] = '\0';
+    return 0;
+}
@@ -0,0 +1,44 @@
+/**
+ * HostTarget.h
+ *
+ * Simulated target for the host build of TouchDSOAcquisition.cpp and TouchDSODisplay.cpp.
+ * ADC, timer 6 and DMA are replaced by a sample source which advances a simulated time by the sample period
+ * of the actual timer 6 setting. The interrupt handlers are called in the order the hardware would call them.
+ * The display functions draw into a frame buffer in host memory.
+ *
+ * @date 17.10.2026
+ * @copyright LGPL v3 (http://www.gnu.org/licenses/lgpl.html)
+ */
+
+#ifndef HOSTTARGET_H_
+#define HOSTTARGET_H_
+
+#include <stdint.h>
+
+/*
+ * Samples transferred by the simulated DMA for each read of CNDTR in the trigger search of the half transfer interrupt.
+ * 32 samples are app. the samples the DMA transfers at the fastest timebases while the trigger search checks 32 samples.
+ */
+#define HOST_DMA_SAMPLES_PER_COUNT_READ 32
+// an acquisition which needs more samples is aborted by hostRunAcquisition()
+#define HOST_MAX_SAMPLES_PER_ACQUISITION 10000000
+
+#define HOST_FRAME_BUFFER_HEIGHT 240
+#define HOST_FRAME_BUFFER_WIDTH 320
+extern uint16_t HostFrameBuffer[HOST_FRAME_BUFFER_HEIGHT][HOST_FRAME_BUFFER_WIDTH];
+
+// simulated time since boot
+extern double HostMicros;
+
+/*
+ * Source of the ADC values - is called once for each conversion with the simulated time of the conversion
+ */
+void hostSetSignalSource(uint16_t (*aSignalSource)(double aMicros));
+
+void hostInitDSO(void);
+bool hostRunAcquisition(void);
+void hostRunAcquisitionCycle(void);
+uint32_t hostGetSamplesOfLastAcquisition(void);
+void hostConvertSamples(uint16_t * aBuffer, int aCount);
+
+#endif /* HOSTTARGET_H_ */
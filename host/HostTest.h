@@ -0,0 +1,43 @@
+/**
+ * HostTest.h
+ *
+ * Checks for the tests of the host build. A failed check is printed and counted,
+ * the test returns the count as exit code, so "make test" stops at the first failing test.
+ *
+ * @date 17.10.2026
+ * @copyright LGPL v3 (http://www.gnu.org/licenses/lgpl.html)
+ */
+
+#ifndef HOSTTEST_H_
+#define HOSTTEST_H_
+
+#include <stdio.h>
+
+static int sHostTestFailCount = 0;
+
+/**
+ * @return true if |aActual - aExpected| <= aTolerance
+ */
+static inline bool checkValue(const char * aName, double aActual, double aExpected, double aTolerance) {
+    double tDelta = aActual - aExpected;
+    if (tDelta < 0) {
+        tDelta = -tDelta;
+    }
+    if (!(tDelta <= aTolerance)) {
+        printf("FAIL %s: %g expected %g +/- %g\n", aName, aActual, aExpected, aTolerance);
+        sHostTestFailCount++;
+        return false;
+    }
+    return true;
+}
+
+static inline int printTestResult(const char * aTestName) {
+    if (sHostTestFailCount == 0) {
+        printf("%s passed\n", aTestName);
+    } else {
+        printf("%s: %d checks failed\n", aTestName, sHostTestFailCount);
+    }
+    return sHostTestFailCount;
+}
+
+#endif /* HOSTTEST_H_ */
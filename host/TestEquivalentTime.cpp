@@ -0,0 +1,104 @@
+/**
+ * TestEquivalentTime.cpp
+ *
+ * Runs the acquisition cycle at the equivalent time timebase with sines of 0.7 and 1.23 MHz,
+ * which have 7.3 and 4.2 samples per period.
+ * The frequencies are no simple fraction of the sample rate, so the trigger crossings have many different phases
+ * relative to the samples, like on target, where the ADC clock is not synchronized to the signal.
+ * With a manual trigger at the middle of the rising edge, the phase of the sine at the trigger crossing is known,
+ * so each pixel of the reconstructed display must show the value of the sine at its time relative to the trigger.
+ * Checks the coverage of the display, the maximum and the RMS error of the reconstruction.
+ *
+ * @date 17.10.2026
+ * @copyright LGPL v3 (http://www.gnu.org/licenses/lgpl.html)
+ */
+
+#include "HostTarget.h"
+#include "HostTest.h"
+#include "Waveforms.h"
+#include "Pages.h"
+#include "TouchDSO.h"
+#include <math.h>
+#include <stdio.h>
+
+#define TEST_OFFSET 2048
+#define TEST_AMPLITUDE 1000
+#define TEST_ACQUISITIONS 100
+#define TEST_TRIGGER_HYSTERESIS 20
+
+/*
+ * The trigger crossing is interpolated linear between the 2 samples around the trigger level,
+ * so the error of the crossing, and with it of the position of all samples of an acquisition,
+ * increases with the phase step between 2 samples. Tolerances are relative to the amplitude.
+ */
+static void checkFrequency(float aFrequencyHertz, double aMaxErrorTolerance, double aRMSErrorTolerance) {
+    char tName[64];
+    setWaveform(WAVEFORM_SINE, aFrequencyHertz, TEST_OFFSET, TEST_AMPLITUDE, 0);
+    // clears the reconstruction of the last frequency
+    changeTimeBase(false);
+
+    resetAcquisitionStatistics();
+    startAcquisition();
+    for (int i = 0; i < TEST_ACQUISITIONS; ++i) {
+        hostRunAcquisitionCycle();
+    }
+    ADC_StopConversion(DSO_ADC_ID );
+    ADC_disableEOCInterrupt(DSO_ADC_ID );
+    snprintf(tName, sizeof tName, "%.0f Hz acquisitions", aFrequencyHertz);
+    checkValue(tName, AcquisitionInfo.AcquisitionCount, TEST_ACQUISITIONS, 0);
+    snprintf(tName, sizeof tName, "%.0f Hz trigger timeouts", aFrequencyHertz);
+    checkValue(tName, AcquisitionInfo.TriggerTimeoutCount, 0, 0);
+
+    /*
+     * The trigger crossing is at pixel DatabufferPreTriggerDisplaySize, where the phase of the sine is 0
+     */
+    // exact value is for one sample per pixel
+    double tPixelMicros = getTimebaseExactValueMicros(TIMEBASE_INDEX_EQUIVALENT_TIME)
+            / (TIMING_GRID_WIDTH * EQUIVALENT_TIME_PIXEL_PER_SAMPLE);
+    int tValidCount = 0;
+    double tMaxError = 0;
+    double tSumOfSquaredErrors = 0;
+    for (int x = 0; x < DSO_DISPLAY_WIDTH; ++x) {
+        uint16_t tValue = DisplayDataBufferControl.DataBuffer[x];
+        if (tValue == DATABUFFER_INVISIBLE_RAW_VALUE) {
+            continue;
+        }
+        tValidCount++;
+        double tMicros = (x - (int) DisplayControl.DatabufferPreTriggerDisplaySize) * tPixelMicros;
+        double tExpectedValue = TEST_OFFSET + TEST_AMPLITUDE * sin(2 * M_PI * aFrequencyHertz * tMicros / 1000000);
+        double tError = fabs(tValue - tExpectedValue);
+        if (tError > tMaxError) {
+            tMaxError = tError;
+        }
+        tSumOfSquaredErrors += tError * tError;
+    }
+    double tRMSError = tValidCount > 0 ? sqrt(tSumOfSquaredErrors / tValidCount) : 0;
+    printf("Equivalent time %.0f Hz: %d of %d pixel valid, %d samples folded, error max=%.1f RMS=%.1f\n", aFrequencyHertz,
+            tValidCount, DSO_DISPLAY_WIDTH, EquivalentTime.ValidCount, tMaxError, tRMSError);
+
+    // only the first pixel before the first sample of the reconstruction can be invisible
+    snprintf(tName, sizeof tName, "%.0f Hz valid pixel", aFrequencyHertz);
+    checkValue(tName, tValidCount, DSO_DISPLAY_WIDTH, 2);
+    snprintf(tName, sizeof tName, "%.0f Hz max error", aFrequencyHertz);
+    checkValue(tName, tMaxError, 0, aMaxErrorTolerance * TEST_AMPLITUDE);
+    snprintf(tName, sizeof tName, "%.0f Hz RMS error", aFrequencyHertz);
+    checkValue(tName, tRMSError, 0, aRMSErrorTolerance * TEST_AMPLITUDE);
+}
+
+int main(void) {
+    hostSetSignalSource(&getWaveformValue);
+    hostInitDSO();
+
+    MeasurementControl.TriggerMode = TRIGGER_MODE_MANUAL;
+    MeasurementControl.TriggerSlopeRising = true;
+    setTriggerLevelAndHysteresis(TEST_OFFSET, TEST_TRIGGER_HYSTERESIS);
+    MeasurementControl.TimebaseNewIndex = TIMEBASE_INDEX_EQUIVALENT_TIME;
+    changeTimeBase(false);
+    checkValue("XScale", DisplayControl.XScale, 0, 0);
+
+    // 49 degree between 2 samples, the sine changes up to 28 raw values per pixel
+    checkFrequency(700001, 0.04, 0.015);
+    // 86 degree between 2 samples, up to 49 raw values per pixel
+    checkFrequency(1234567, 0.1, 0.05);
+    return printTestResult("TestEquivalentTime");
+}
@@ -0,0 +1,143 @@
+/**
+ * TestFFT.cpp
+ *
+ * Compares the real input FFTs computeFFT() and computeFFTQ15() with a direct DFT in double
+ * of the same DC free and windowed samples for all windows and FFT sizes.
+ * On the host the complex FFT of both routines is the split radix FFT of arm_math.cpp,
+ * so the test checks the separation of the real spectrum, the window and the scaling, which are the same on target.
+ *
+ * @date 17.10.2026
+ * @copyright LGPL v3 (http://www.gnu.org/licenses/lgpl.html)
+ */
+
+#include "HostTarget.h"
+#include "HostTest.h"
+#include "Pages.h"
+#include "TouchDSO.h"
+#include <math.h>
+#include <stdio.h>
+
+// a0 to a4 of FFTWindowCoefficientsQ15 of TouchDSOAcquisition.cpp
+static const double WindowCoefficients[FFT_WINDOW_NUMBER][5] = { { 32767, 0, 0, 0, 0 }, { 16384, 16384, 0, 0, 0 }, { 17695,
+        15073, 0, 0, 0 }, { 7064, 13652, 9085, 2739, 228 } };
+static const char * const WindowNames[FFT_WINDOW_NUMBER] = { "rectangle", "Hann", "Hamming", "flat top" };
+
+#define TEST_SIGNAL_AMPLITUDE 1000
+#define TEST_SIGNAL_BIN 20 // first sine is exactly on this bin for FFT_SIZE
+#define TEST_SECOND_SIGNAL_AMPLITUDE 300
+
+static uint16_t TestSamples[FFT_SIZE_MAX];
+static float32_t FFTBuffer[FFT_SIZE_MAX];
+static q15_t FFTBufferQ15[3 * FFT_SIZE / 2];
+static double ReferenceMagnitudes[FFT_SIZE_MAX / 2];
+
+/*
+ * Two sines, one exactly on a bin of FFT_SIZE, one between bins, plus a small square wave for the harmonics
+ */
+static void generateTestSamples(void) {
+    for (int i = 0; i < FFT_SIZE_MAX; ++i) {
+        double tValue = 2048 + TEST_SIGNAL_AMPLITUDE * sin(2 * M_PI * TEST_SIGNAL_BIN * i / FFT_SIZE);
+        tValue += TEST_SECOND_SIGNAL_AMPLITUDE * sin(2 * M_PI * 47.3 * i / FFT_SIZE + 1.0);
+        tValue += ((i / 7) & 1) ? 20 : -20;
+        TestSamples[i] = lround(tValue);
+    }
+}
+
+/*
+ * Magnitudes of the direct DFT of the windowed samples with the DC value removed like computeFFT() does.
+ * Window is the exact cosine sum, with a0 to a4 in q15 as used by the DSO.
+ */
+static void computeReferenceDFT(int aFFTSize, uint8_t aWindowType) {
+    uint32_t tSum = 0;
+    for (int i = 0; i < aFFTSize; ++i) {
+        tSum += TestSamples[i];
+    }
+    int tDCValue = tSum / aFFTSize;
+
+    static double sInput[FFT_SIZE_MAX];
+    for (int i = 0; i < aFFTSize; ++i) {
+        double tWindow = 0;
+        double tSign = 1;
+        for (int k = 0; k < 5; ++k) {
+            tWindow += tSign * WindowCoefficients[aWindowType][k] * cos(2 * M_PI * k * i / aFFTSize) / 32768;
+            tSign = -tSign;
+        }
+        sInput[i] = (TestSamples[i] - tDCValue) * tWindow;
+    }
+    for (int k = 0; k < aFFTSize / 2; ++k) {
+        double tReal = 0;
+        double tImaginary = 0;
+        for (int i = 0; i < aFFTSize; ++i) {
+            double tAngle = 2 * M_PI * (double) ((k * i) % aFFTSize) / aFFTSize;
+            tReal += sInput[i] * cos(tAngle);
+            tImaginary -= sInput[i] * sin(tAngle);
+        }
+        ReferenceMagnitudes[k] = sqrt(tReal * tReal + tImaginary * tImaginary);
+    }
+}
+
+/*
+ * computeFFT() returns the DFT magnitude in volt, DC bin is zero
+ */
+static void testFloatFFT(int aFFTSize, uint8_t aWindowType) {
+    char tName[64];
+    computeReferenceDFT(aFFTSize, aWindowType);
+    computeFFT(TestSamples, FFTBuffer, aFFTSize);
+
+    double tMaxReference = 0;
+    int tMaxReferenceIndex = 0;
+    for (int k = 1; k < aFFTSize / 2; ++k) {
+        if (ReferenceMagnitudes[k] > tMaxReference) {
+            tMaxReference = ReferenceMagnitudes[k];
+            tMaxReferenceIndex = k;
+        }
+    }
+    // the q15 window table has an error of 1 LSB
+    double tTolerance = tMaxReference * actualDSORawToVoltFactor * 2e-4;
+    for (int k = 1; k < aFFTSize / 2; ++k) {
+        snprintf(tName, sizeof tName, "computeFFT %d %s bin %d", aFFTSize, WindowNames[aWindowType], k);
+        checkValue(tName, FFTBuffer[k], ReferenceMagnitudes[k] * actualDSORawToVoltFactor, tTolerance);
+    }
+    snprintf(tName, sizeof tName, "computeFFT %d %s DC bin", aFFTSize, WindowNames[aWindowType]);
+    checkValue(tName, FFTBuffer[0], 0, 0);
+    snprintf(tName, sizeof tName, "computeFFT %d %s max index", aFFTSize, WindowNames[aWindowType]);
+    checkValue(tName, FFTInfo.MaxIndex, tMaxReferenceIndex, 0);
+}
+
+/*
+ * computeFFTQ15() returns the DFT magnitude in raw values scaled by 4 / FFT_SIZE,
+ * i.e. the amplitude of a sine on a bin multiplied by 2 * a0
+ */
+static void testQ15FFT(uint8_t aWindowType) {
+    char tName[64];
+    computeReferenceDFT(FFT_SIZE, aWindowType);
+    q15_t * tMagnitudes = computeFFTQ15(TestSamples, FFTBufferQ15);
+
+    // rounding of input, window, butterflies and separation
+    double tTolerance = 4;
+    for (int k = 1; k < FFT_SIZE / 2; ++k) {
+        snprintf(tName, sizeof tName, "computeFFTQ15 %s bin %d", WindowNames[aWindowType], k);
+        checkValue(tName, tMagnitudes[k], ReferenceMagnitudes[k] * 4 / FFT_SIZE, tTolerance);
+    }
+    snprintf(tName, sizeof tName, "computeFFTQ15 %s max index", WindowNames[aWindowType]);
+    checkValue(tName, FFTInfo.MaxIndex, TEST_SIGNAL_BIN, 0);
+    if (aWindowType == FFT_WINDOW_FLAT_TOP) {
+        // the flat top window gives the amplitude of the sine even if it is not exactly on a bin
+        snprintf(tName, sizeof tName, "computeFFTQ15 %s amplitude", WindowNames[aWindowType]);
+        checkValue(tName, FFTInfo.MaxValue, TEST_SIGNAL_AMPLITUDE * actualDSORawToVoltFactor,
+                TEST_SIGNAL_AMPLITUDE * actualDSORawToVoltFactor * 0.01);
+    }
+}
+
+int main(void) {
+    hostInitDSO();
+    generateTestSamples();
+
+    for (uint8_t tWindowType = 0; tWindowType < FFT_WINDOW_NUMBER; ++tWindowType) {
+        DisplayControl.FFTWindowType = tWindowType;
+        testFloatFFT(FFT_SIZE, tWindowType);
+        testFloatFFT(FFT_SIZE_MAX, tWindowType);
+        testQ15FFT(tWindowType);
+    }
+    return printTestResult("TestFFT");
+}
@@ -0,0 +1,104 @@
+/**
+ * TestFilter.cpp
+ *
+ * Checks the frequency response of the display filters of getFilteredDataBufferPointer().
+ * Sines at multiples of 1/512 of the sample rate are filtered and the amplitude and phase of the output
+ * are measured by a DFT over 512 samples in the middle of the buffer.
+ * Expected gains are the moving average response, the analog Butterworth prototype of the biquad
+ * and the response of the FIR coefficients. For the FIR the phase is checked too, the compensation of the group delay
+ * of 7.5 samples by 8 samples must leave an advance of exactly half a sample.
+ * On the host the CMSIS filters are the portable versions of arm_math.cpp.
+ *
+ * @date 17.10.2026
+ * @copyright LGPL v3 (http://www.gnu.org/licenses/lgpl.html)
+ */
+
+#include "HostTarget.h"
+#include "HostTest.h"
+#include "Pages.h"
+#include "TouchDSO.h"
+#include <math.h>
+#include <stdio.h>
+
+#define TEST_COUNT 1024
+#define TEST_MEASUREMENT_START 256
+#define TEST_MEASUREMENT_SIZE 512
+#define TEST_AMPLITUDE 1000
+
+// FilterFIRCoefficients of TouchDSOAcquisition.cpp
+static const int FIRCoefficients[] = { -114, -159, -139, 291, 1450, 3284, 5246, 6524, 6524, 5246, 3284, 1450, 291, -139, -159, -114 };
+#define FIR_CUTOFF 0.1
+#define BIQUAD_CUTOFF 0.05
+
+static uint16_t TestSamples[TEST_COUNT];
+
+/*
+ * @param aFrequency - in units of the sample rate
+ * @return designed gain of the selected filter
+ */
+static double getExpectedGain(double aFrequency) {
+    double tOmega = 2 * M_PI * aFrequency;
+    if (DisplayControl.FilterType == FILTER_TYPE_MOVING_AVERAGE) {
+        return fabs(sin(4 * tOmega) / (8 * sin(tOmega / 2)));
+    } else if (DisplayControl.FilterType == FILTER_TYPE_IIR) {
+        // bilinear transform of the 2. order Butterworth low pass
+        double tRatio = tan(M_PI * aFrequency) / tan(M_PI * BIQUAD_CUTOFF);
+        return 1 / sqrt(1 + pow(tRatio, 4));
+    }
+    double tReal = 0;
+    double tImaginary = 0;
+    for (unsigned int k = 0; k < sizeof(FIRCoefficients) / sizeof(FIRCoefficients[0]); ++k) {
+        tReal += FIRCoefficients[k] * cos(tOmega * k) / 32768;
+        tImaginary -= FIRCoefficients[k] * sin(tOmega * k) / 32768;
+    }
+    return sqrt(tReal * tReal + tImaginary * tImaginary);
+}
+
+/*
+ * Filters a sine with aPeriods periods in TEST_MEASUREMENT_SIZE samples and checks gain and phase
+ */
+static void checkFrequency(int aPeriods, double aGainTolerance) {
+    double tFrequency = (double) aPeriods / TEST_MEASUREMENT_SIZE;
+    for (int i = 0; i < TEST_COUNT; ++i) {
+        TestSamples[i] = lround(2048 + TEST_AMPLITUDE * sin(2 * M_PI * tFrequency * i));
+    }
+    uint16_t * tFilteredPointer = getFilteredDataBufferPointer(TestSamples, TEST_COUNT);
+
+    double tReal = 0;
+    double tImaginary = 0;
+    for (int i = TEST_MEASUREMENT_START; i < TEST_MEASUREMENT_START + TEST_MEASUREMENT_SIZE; ++i) {
+        double tAngle = 2 * M_PI * tFrequency * i;
+        tReal += tFilteredPointer[i] * sin(tAngle);
+        tImaginary += tFilteredPointer[i] * cos(tAngle);
+    }
+    double tGain = 2 * sqrt(tReal * tReal + tImaginary * tImaginary) / (TEST_MEASUREMENT_SIZE * TEST_AMPLITUDE);
+    double tExpectedGain = getExpectedGain(tFrequency);
+    char tName[64];
+    snprintf(tName, sizeof tName, "filter %d gain at %.4f", DisplayControl.FilterType, tFrequency);
+    checkValue(tName, tGain, tExpectedGain, aGainTolerance);
+
+    if (DisplayControl.FilterType == FILTER_TYPE_FIR && tExpectedGain > 0.5) {
+        // FIR is symmetric and the delay of 7.5 samples is compensated by 8 samples
+        snprintf(tName, sizeof tName, "filter %d phase at %.4f", DisplayControl.FilterType, tFrequency);
+        checkValue(tName, atan2(tImaginary, tReal), M_PI * tFrequency, 0.02);
+    }
+}
+
+int main(void) {
+    hostInitDSO();
+
+    DisplayControl.FilterType = FILTER_TYPE_NONE;
+    checkValue("filter off returns input", getFilteredDataBufferPointer(TestSamples, TEST_COUNT) == TestSamples, 1, 0);
+
+    for (uint8_t tFilterType = FILTER_TYPE_MOVING_AVERAGE; tFilterType < FILTER_TYPE_NUMBER; ++tFilterType) {
+        DisplayControl.FilterType = tFilterType;
+        initFilter();
+        for (int tPeriods = 4; tPeriods <= 192; tPeriods += 4) {
+            checkFrequency(tPeriods, 0.01);
+        }
+    }
+    // -6 dB at cutoff of the FIR
+    DisplayControl.FilterType = FILTER_TYPE_FIR;
+    checkValue("FIR gain at cutoff", getExpectedGain(FIR_CUTOFF), 0.5, 0.02);
+    return printTestResult("TestFilter");
+}
@@ -0,0 +1,246 @@
+/**
+ * TestStatistics.cpp
+ *
+ * Compares the statistics pass of computeMinMaxAverageAndPeriodFrequency() with the baseline routine,
+ * which computed only min, max, average and period, on the same buffers.
+ * Min, max, average, period and frequency must be identical.
+ * RMS, duty cycle, rise and fall time and overshoot are checked against the values of the generated waveforms.
+ * Prints the host cycles per sample of both routines.
+ *
+ * @date 17.10.2026
+ * @copyright LGPL v3 (http://www.gnu.org/licenses/lgpl.html)
+ */
+
+#include "HostTarget.h"
+#include "HostTest.h"
+#include "Waveforms.h"
+#include "Pages.h"
+#include "TouchDSO.h"
+#include "Chart.h"
+#include <math.h>
+
+#define MIN_SAMPLES_PER_PERIOD_FOR_RELIABLE_FREQUENCY_VALUE 3 // from TouchDSOAcquisition.cpp
+#define TIMING_REPETITIONS 200
+
+uint32_t hostReadCycleCounter(void);
+
+struct BaselineResultStruct {
+    uint16_t RawValueMin;
+    uint16_t RawValueMax;
+    uint16_t RawValueAverage;
+    uint32_t FrequencyHertz;
+    float PeriodMicros;
+};
+
+/**
+ * computeMinMaxAverageAndPeriodFrequency() of the baseline, results are stored in aResult instead of MeasurementControl
+ */
+static void computeBaselineMinMaxAverageAndPeriodFrequency(BaselineResultStruct * aResult) {
+    uint16_t * tDataBufferPointer = DataBufferControl.DataBufferDisplayStart
+            + adjustIntWithScaleFactor(DisplayControl.DatabufferPreTriggerDisplaySize, DisplayControl.XScale);
+    if (DataBufferControl.DataBufferEndPointer > tDataBufferPointer) {
+        uint16_t tAcquisitionSize = DataBufferControl.DataBufferEndPointer + 1 - tDataBufferPointer;
+        uint16_t tMax, tMin;
+        tMax = *tDataBufferPointer;
+        tMin = *tDataBufferPointer;
+        uint16_t tValue;
+        uint32_t tIntegrateValue = 0;
+        uint32_t tIntegrateValueForTotalPeriods = 0;
+        int tCount = 0;
+        int tLastFoundPosition = 0;
+        int tPeriodDelta = 0;
+        int tPeriodMin = 1024;
+        int tPeriodMax = 0;
+        int tTriggerStatus = TRIGGER_START;
+        bool tFalling = !MeasurementControl.TriggerSlopeRising;
+        uint16_t tActualCompareValue = MeasurementControl.RawTriggerLevelHysteresis;
+        bool tReliableValue = true;
+
+        for (int i = 0; i < tAcquisitionSize; ++i) {
+            tValue = *tDataBufferPointer++;
+            bool tValueGreaterRef = (tValue > tActualCompareValue);
+            tValueGreaterRef = tValueGreaterRef ^ tFalling; // change value if tFalling == true
+
+            if (tTriggerStatus == TRIGGER_START) {
+                if (!tValueGreaterRef) {
+                    tTriggerStatus = TRIGGER_BEFORE_THRESHOLD;
+                    tActualCompareValue = MeasurementControl.RawTriggerLevel;
+                }
+            } else {
+                if (tValueGreaterRef) {
+                    if ((tPeriodDelta) < MIN_SAMPLES_PER_PERIOD_FOR_RELIABLE_FREQUENCY_VALUE) {
+                        tReliableValue = false;
+                    } else {
+                        if (tPeriodDelta < tPeriodMin) {
+                            tPeriodMin = tPeriodDelta;
+                        } else if (tPeriodDelta > tPeriodMax) {
+                            tPeriodMax = tPeriodDelta;
+                        }
+                        tPeriodDelta = 0;
+                        tIntegrateValueForTotalPeriods = tIntegrateValue;
+                        tCount++;
+                        tLastFoundPosition = i;
+                        tTriggerStatus = TRIGGER_START;
+                        tActualCompareValue = MeasurementControl.RawTriggerLevelHysteresis;
+                    }
+                }
+            }
+            tIntegrateValue += tValue;
+            tPeriodDelta++;
+
+            if (tValue > tMax) {
+                tMax = tValue;
+            } else if (tValue < tMin) {
+                tMin = tValue;
+            }
+        }
+
+        aResult->RawValueMin = tMin;
+        aResult->RawValueMax = tMax;
+
+        tPeriodDelta = tPeriodMax - tPeriodMin;
+        // the baseline divides by zero here if no period was found, which gives 0 on target
+        if (tCount != 0 && ((tLastFoundPosition / (8 * tCount)) + 3) < tPeriodDelta) {
+            tReliableValue = false;
+        }
+
+        float tPeriodMicros = 0.0;
+        float tHertz = 0.0;
+        if (tLastFoundPosition != 0 && tCount != 0 && tReliableValue) {
+            aResult->RawValueAverage = (tIntegrateValueForTotalPeriods + (tLastFoundPosition / 2)) / tLastFoundPosition;
+            tPeriodMicros = tLastFoundPosition;
+            if (MeasurementControl.TimebaseIndex < TIMEBASE_NUMBER_OF_EXCACT_ENTRIES) {
+                tPeriodMicros = tPeriodMicros * TimebaseExactDivValuesMicros[MeasurementControl.TimebaseIndex];
+                if (MeasurementControl.TimebaseIndex < TIMEBASE_NUMBER_OF_XSCALE_CORRECTION) {
+                    tPeriodMicros *= xScaleForTimebase[MeasurementControl.TimebaseIndex];
+                }
+            } else {
+                tPeriodMicros = tPeriodMicros * TimebaseDivValues[MeasurementControl.TimebaseIndex];
+            }
+            tPeriodMicros = tPeriodMicros / (tCount * TIMING_GRID_WIDTH);
+            if (MeasurementControl.TimebaseIndex >= TIMEBASE_INDEX_MILLIS) {
+                tPeriodMicros = tPeriodMicros * 1000;
+            }
+            tHertz = 1000000.0 / tPeriodMicros;
+        } else {
+            aResult->RawValueAverage = (tIntegrateValue + (tAcquisitionSize / 2)) / tAcquisitionSize;
+        }
+        aResult->FrequencyHertz = tHertz + 0.5;
+        aResult->PeriodMicros = tPeriodMicros + 0.5;
+    }
+}
+
+/**
+ * Fills the data buffer with aWaveformType for 10 periods, of which app. 9 are behind the trigger, and computes the statistics twice,
+ * so the levels of the "previous acquisition" are the levels of this buffer.
+ * @return micros per sample
+ */
+static float acquireWaveform(uint8_t aWaveformType, int aTimebaseIndex, uint8_t aDutyCyclePercent) {
+    MeasurementControl.TimebaseNewIndex = aTimebaseIndex;
+    changeTimeBase(false);
+    float tMicrosPerSample = getTimebaseExactValueMicros(aTimebaseIndex) / TIMING_GRID_WIDTH;
+    setWaveform(aWaveformType, 1000000 / (tMicrosPerSample * (DATABUFFER_SIZE / 10)), 2048, 1000, 0);
+    Waveform.DutyCyclePercent = aDutyCyclePercent;
+
+    hostConvertSamples(&DataBufferControl.DataBuffer[0], DATABUFFER_SIZE);
+    DataBufferControl.isPacked = false;
+    // start of post trigger values at the first rising crossing of the middle level, like an acquisition
+    int tTriggerIndex = DisplayControl.DatabufferPreTriggerDisplaySize;
+    while (tTriggerIndex < DATABUFFER_SIZE / 2
+            && !(DataBufferControl.DataBuffer[tTriggerIndex - 1] <= 2048 && DataBufferControl.DataBuffer[tTriggerIndex] > 2048)) {
+        tTriggerIndex++;
+    }
+    DataBufferControl.DataBufferDisplayStart = &DataBufferControl.DataBuffer[tTriggerIndex
+            - DisplayControl.DatabufferPreTriggerDisplaySize];
+    DataBufferControl.DataBufferEndPointer = &DataBufferControl.DataBuffer[DATABUFFER_SIZE - 1];
+    computeMinMaxAverageAndPeriodFrequency();
+    computeAutoTrigger();
+    computeMinMaxAverageAndPeriodFrequency();
+    return tMicrosPerSample;
+}
+
+static void compareWithBaseline(const char * aName, bool aIsPeriodic) {
+    BaselineResultStruct tBaseline;
+    computeBaselineMinMaxAverageAndPeriodFrequency(&tBaseline);
+    printf("%s: min=%u max=%u average=%u %uHz RMS=%u duty=%u%% rise=%.2fus fall=%.2fus overshoot=%u%% pulses=%u\n", aName,
+            MeasurementControl.RawValueMin, MeasurementControl.RawValueMax, MeasurementControl.RawValueAverage,
+            (unsigned int) MeasurementControl.FrequencyHertz, MeasurementControl.RawValueRMS, MeasurementControl.DutyCyclePercent,
+            MeasurementControl.RiseMicros, MeasurementControl.FallMicros, MeasurementControl.OvershootPercent,
+            MeasurementControl.PulseCount);
+    checkValue("min", MeasurementControl.RawValueMin, tBaseline.RawValueMin, 0);
+    checkValue("max", MeasurementControl.RawValueMax, tBaseline.RawValueMax, 0);
+    checkValue("average", MeasurementControl.RawValueAverage, tBaseline.RawValueAverage, 0);
+    checkValue("frequency", MeasurementControl.FrequencyHertz, tBaseline.FrequencyHertz, 0);
+    checkValue("period", MeasurementControl.PeriodMicros, tBaseline.PeriodMicros, 0);
+    if (aIsPeriodic) {
+        checkValue("frequency of waveform", MeasurementControl.FrequencyHertz, Waveform.FrequencyHertz,
+                Waveform.FrequencyHertz * 0.02);
+    }
+}
+
+static void printCyclesPerSample(void) {
+    int tSamples = DataBufferControl.DataBufferEndPointer + 1 - DataBufferControl.DataBufferDisplayStart
+            - DisplayControl.DatabufferPreTriggerDisplaySize;
+    BaselineResultStruct tBaseline;
+    uint32_t tStartCycles = hostReadCycleCounter();
+    for (int i = 0; i < TIMING_REPETITIONS; ++i) {
+        computeBaselineMinMaxAverageAndPeriodFrequency(&tBaseline);
+    }
+    uint32_t tBaselineCycles = hostReadCycleCounter() - tStartCycles;
+    tStartCycles = hostReadCycleCounter();
+    for (int i = 0; i < TIMING_REPETITIONS; ++i) {
+        computeMinMaxAverageAndPeriodFrequency();
+    }
+    uint32_t tCycles = hostReadCycleCounter() - tStartCycles;
+    printf("Host cycles per sample: baseline %.1f, with RMS, duty cycle, rise / fall time and overshoot %.1f\n",
+            (float) tBaselineCycles / (TIMING_REPETITIONS * tSamples), (float) tCycles / (TIMING_REPETITIONS * tSamples));
+}
+
+int main(void) {
+    hostSetSignalSource(&getWaveformValue);
+    hostInitDSO();
+    setACMode(false);
+    MeasurementControl.TriggerSlopeRising = true;
+
+    for (int tTimebaseIndex = TIMEBASE_FAST_MODES; tTimebaseIndex <= TIMEBASE_INDEX_START_VALUE; tTimebaseIndex +=
+            TIMEBASE_INDEX_START_VALUE - TIMEBASE_FAST_MODES) {
+        /*
+         * Sine - RMS = sqrt(offset^2 + amplitude^2 / 2), 10% to 90% takes (asin(0.8) - asin(-0.8)) / 2 PI of the period
+         */
+        float tMicrosPerSample = acquireWaveform(WAVEFORM_SINE, tTimebaseIndex, 50);
+        compareWithBaseline("Sine", true);
+        float tPeriodMicros = 1000000 / Waveform.FrequencyHertz;
+        checkValue("sine RMS", MeasurementControl.RawValueRMS, sqrt(2048.0 * 2048.0 + 1000.0 * 1000.0 / 2), 2);
+        checkValue("sine duty cycle", MeasurementControl.DutyCyclePercent, 50, 1);
+        float tRiseMicros = tPeriodMicros * (2 * asin(0.8)) / (2 * M_PI);
+        checkValue("sine rise time", MeasurementControl.RiseMicros, tRiseMicros, tRiseMicros * 0.03 + tMicrosPerSample);
+        checkValue("sine fall time", MeasurementControl.FallMicros, tRiseMicros, tRiseMicros * 0.03 + tMicrosPerSample);
+        checkValue("sine pulses", MeasurementControl.PulseCount, 9, 1);
+        // top level is the average above 90%, which is 2 * cos(asin(0.8)) / (PI - 2 * asin(0.8)) of the peak
+        float tTop = 2 * cos(asin(0.8)) / (M_PI - 2 * asin(0.8));
+        checkValue("sine overshoot", MeasurementControl.OvershootPercent, (int) (100 * (1 - tTop) / (2 * tTop)), 1);
+
+        /*
+         * Square 30% - values are offset +/- amplitude
+         */
+        acquireWaveform(WAVEFORM_SQUARE, tTimebaseIndex, 30);
+        compareWithBaseline("Square 30%", true);
+        checkValue("square RMS", MeasurementControl.RawValueRMS, sqrt(0.3 * 3048.0 * 3048.0 + 0.7 * 1048.0 * 1048.0), 12);
+        checkValue("square duty cycle", MeasurementControl.DutyCyclePercent, 30, 1);
+        checkValue("square rise time", MeasurementControl.RiseMicros, tMicrosPerSample, tMicrosPerSample * 0.01);
+        checkValue("square fall time", MeasurementControl.FallMicros, tMicrosPerSample, tMicrosPerSample * 0.01);
+        checkValue("square overshoot", MeasurementControl.OvershootPercent, 0, 0);
+
+        /*
+         * Noise and bursts - no reliable period, all values must still be identical to baseline
+         */
+        acquireWaveform(WAVEFORM_NOISE, tTimebaseIndex, 50);
+        compareWithBaseline("Noise", false);
+        acquireWaveform(WAVEFORM_BURST, tTimebaseIndex, 50);
+        compareWithBaseline("Burst", false);
+    }
+
+    acquireWaveform(WAVEFORM_SQUARE, TIMEBASE_INDEX_START_VALUE, 30);
+    printCyclesPerSample();
+    return printTestResult("TestStatistics");
+}
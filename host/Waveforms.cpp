@@ -0,0 +1,141 @@
+/**
+ * Waveforms.cpp
+ *
+ * Signal sources for the simulated ADC of the host build.
+ * The noise generator is a fixed linear congruential generator, so all runs are reproducible.
+ *
+ * CSV file format: one sample per line "<time in microseconds>,<raw ADC value>" with increasing time.
+ * Lines not starting with a number are skipped. Between samples the value is interpolated linear,
+ * after the last sample the values are repeated starting with the first one.
+ *
+ * @date 17.10.2026
+ * @copyright LGPL v3 (http://www.gnu.org/licenses/lgpl.html)
+ */
+
+#include "Waveforms.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define CSV_MAX_SAMPLES 100000
+
+WaveformStruct Waveform;
+const char * const WaveformNames[WAVEFORM_NUMBER] = { "sine", "square", "noise", "burst", "csv" };
+
+static uint32_t sNoiseState = 1;
+
+static float CSVMicros[CSV_MAX_SAMPLES];
+static uint16_t CSVValues[CSV_MAX_SAMPLES];
+static int sCSVCount;
+
+void setWaveform(uint8_t aType, float aFrequencyHertz, uint16_t aOffset, uint16_t aAmplitude, uint16_t aNoiseAmplitude) {
+    Waveform.Type = aType;
+    Waveform.FrequencyHertz = aFrequencyHertz;
+    Waveform.PhaseRadian = 0;
+    Waveform.Offset = aOffset;
+    Waveform.Amplitude = aAmplitude;
+    Waveform.NoiseAmplitude = aNoiseAmplitude;
+    Waveform.DutyCyclePercent = 50;
+    Waveform.BurstPeriods = 4;
+    Waveform.BurstPausePeriods = 12;
+    sNoiseState = 1;
+}
+
+/**
+ * @return uniform noise between -aAmplitude and aAmplitude
+ */
+static int getNoise(int aAmplitude) {
+    if (aAmplitude == 0) {
+        return 0;
+    }
+    sNoiseState = sNoiseState * 1664525 + 1013904223;
+    return (int) ((sNoiseState >> 16) % (2 * aAmplitude + 1)) - aAmplitude;
+}
+
+static int getCSVValue(double aMicros) {
+    if (sCSVCount < 2) {
+        return sCSVCount == 1 ? CSVValues[0] : 0;
+    }
+    double tPeriod = CSVMicros[sCSVCount - 1] - CSVMicros[0];
+    double tTime = CSVMicros[0] + fmod(aMicros, tPeriod);
+    // binary search for the last sample before tTime
+    int tLow = 0;
+    int tHigh = sCSVCount - 1;
+    while (tHigh - tLow > 1) {
+        int tMiddle = (tLow + tHigh) / 2;
+        if (CSVMicros[tMiddle] <= tTime) {
+            tLow = tMiddle;
+        } else {
+            tHigh = tMiddle;
+        }
+    }
+    double tFraction = (tTime - CSVMicros[tLow]) / (CSVMicros[tHigh] - CSVMicros[tLow]);
+    return CSVValues[tLow] + (int) lround(tFraction * ((int) CSVValues[tHigh] - (int) CSVValues[tLow]));
+}
+
+/**
+ * @return raw value clipped to 12 bit
+ */
+uint16_t getWaveformValue(double aMicros) {
+    double tPeriods = aMicros * Waveform.FrequencyHertz / 1000000;
+    double tFraction = tPeriods - floor(tPeriods);
+    int tValue = Waveform.Offset;
+    switch (Waveform.Type) {
+    case WAVEFORM_SINE:
+        tValue += lround(Waveform.Amplitude * sin(2 * M_PI * tPeriods + Waveform.PhaseRadian));
+        break;
+    case WAVEFORM_SQUARE:
+        tValue += (tFraction * 100 < Waveform.DutyCyclePercent) ? Waveform.Amplitude : -Waveform.Amplitude;
+        break;
+    case WAVEFORM_NOISE:
+        tValue += getNoise(Waveform.Amplitude);
+        break;
+    case WAVEFORM_BURST: {
+        int tPeriodInBurst = (long) floor(tPeriods) % (Waveform.BurstPeriods + Waveform.BurstPausePeriods);
+        if (tPeriodInBurst < Waveform.BurstPeriods) {
+            tValue += lround(Waveform.Amplitude * sin(2 * M_PI * tFraction));
+        }
+        break;
+    }
+    case WAVEFORM_CSV:
+        tValue = getCSVValue(aMicros);
+        break;
+    }
+    tValue += getNoise(Waveform.NoiseAmplitude);
+    if (tValue < 0) {
+        tValue = 0;
+    } else if (tValue > 4095) {
+        tValue = 4095;
+    }
+    return tValue;
+}
+
+/**
+ * Reads samples for WAVEFORM_CSV and sets Waveform.Type to WAVEFORM_CSV
+ * @return false if file could not be read or contains less than 2 samples
+ */
+bool readWaveformCSV(const char * aFilename) {
+    FILE * tFile = fopen(aFilename, "r");
+    if (tFile == NULL) {
+        return false;
+    }
+    char tLine[128];
+    sCSVCount = 0;
+    while (sCSVCount < CSV_MAX_SAMPLES && fgets(tLine, sizeof tLine, tFile) != NULL) {
+        float tMicros;
+        int tValue;
+        if (sscanf(tLine, "%f,%d", &tMicros, &tValue) == 2) {
+            CSVMicros[sCSVCount] = tMicros;
+            CSVValues[sCSVCount] = tValue;
+            sCSVCount++;
+        }
+    }
+    fclose(tFile);
+    if (sCSVCount < 2) {
+        return false;
+    }
+    Waveform.Type = WAVEFORM_CSV;
+    Waveform.Offset = 0;
+    Waveform.NoiseAmplitude = 0;
+    return true;
+}
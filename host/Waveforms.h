@@ -0,0 +1,41 @@
+/**
+ * Waveforms.h
+ *
+ * Signal sources for the simulated ADC of the host build.
+ * All values are raw ADC values, the time is the simulated time of the conversion.
+ *
+ * @date 17.10.2026
+ * @copyright LGPL v3 (http://www.gnu.org/licenses/lgpl.html)
+ */
+
+#ifndef WAVEFORMS_H_
+#define WAVEFORMS_H_
+
+#include <stdint.h>
+
+#define WAVEFORM_SINE 0
+#define WAVEFORM_SQUARE 1
+#define WAVEFORM_NOISE 2
+#define WAVEFORM_BURST 3 // sine bursts of BurstPeriods periods followed by a pause of BurstPausePeriods periods
+#define WAVEFORM_CSV 4 // values of readWaveformCSV() repeated periodically
+#define WAVEFORM_NUMBER 5
+
+struct WaveformStruct {
+    uint8_t Type;
+    float FrequencyHertz;
+    float PhaseRadian; // phase of sine at time 0
+    uint16_t Offset;
+    uint16_t Amplitude; // peak value
+    uint16_t NoiseAmplitude; // peak value of uniform noise added to all waveforms
+    uint8_t DutyCyclePercent; // for square
+    uint8_t BurstPeriods;
+    uint8_t BurstPausePeriods;
+};
+extern WaveformStruct Waveform;
+extern const char * const WaveformNames[WAVEFORM_NUMBER];
+
+void setWaveform(uint8_t aType, float aFrequencyHertz, uint16_t aOffset, uint16_t aAmplitude, uint16_t aNoiseAmplitude);
+uint16_t getWaveformValue(double aMicros);
+bool readWaveformCSV(const char * aFilename);
+
+#endif /* WAVEFORMS_H_ */
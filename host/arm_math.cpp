@@ -0,0 +1,233 @@
+/**
+ * arm_math.cpp
+ *
+ * Portable implementation of the CMSIS-DSP subset declared in stubs/arm_math.h.
+ * Scaling, state layout and saturation follow the CMSIS-DSP functions,
+ * so the DSO code computes the same results on the host as on target except for rounding of the last bit.
+ * The complex float FFT is a split radix FFT, the q15 FFT uses it too and scales down by fftLen like CMSIS.
+ *
+ * @date 17.10.2026
+ * @copyright LGPL v3 (http://www.gnu.org/licenses/lgpl.html)
+ */
+
+#include <arm_math.h>
+#include <complex>
+#include <vector>
+
+typedef std::complex<double> Complex;
+
+static inline q15_t saturateQ15(int64_t aValue) {
+    if (aValue > 32767) {
+        return 32767;
+    }
+    if (aValue < -32768) {
+        return -32768;
+    }
+    return aValue;
+}
+
+/**
+ * Recursive split radix decimation in time FFT
+ * @param aInput - aSize values with distance aStride
+ * @param aOutput - aSize contiguous values in natural order
+ */
+static void splitRadixFFT(const Complex * aInput, Complex * aOutput, int aSize, int aStride) {
+    if (aSize == 1) {
+        aOutput[0] = aInput[0];
+        return;
+    }
+    if (aSize == 2) {
+        aOutput[0] = aInput[0] + aInput[aStride];
+        aOutput[1] = aInput[0] - aInput[aStride];
+        return;
+    }
+    int tQuarter = aSize / 4;
+    // even values -> first half, values 4k+1 and 4k+3 -> third and fourth quarter
+    splitRadixFFT(aInput, aOutput, aSize / 2, 2 * aStride);
+    splitRadixFFT(aInput + aStride, aOutput + 2 * tQuarter, tQuarter, 4 * aStride);
+    splitRadixFFT(aInput + 3 * aStride, aOutput + 3 * tQuarter, tQuarter, 4 * aStride);
+    for (int k = 0; k < tQuarter; ++k) {
+        double tAngle = -2 * M_PI * k / aSize;
+        Complex tOdd1 = aOutput[k + 2 * tQuarter] * std::polar(1.0, tAngle);
+        Complex tOdd3 = aOutput[k + 3 * tQuarter] * std::polar(1.0, 3 * tAngle);
+        Complex tSum = tOdd1 + tOdd3;
+        // -i * (tOdd1 - tOdd3)
+        Complex tDifference = (tOdd1 - tOdd3) * Complex(0, -1);
+        Complex tEven0 = aOutput[k];
+        Complex tEven1 = aOutput[k + tQuarter];
+        aOutput[k] = tEven0 + tSum;
+        aOutput[k + 2 * tQuarter] = tEven0 - tSum;
+        aOutput[k + tQuarter] = tEven1 + tDifference;
+        aOutput[k + 3 * tQuarter] = tEven1 - tDifference;
+    }
+}
+
+static int reverseBits(int aValue, int aSize) {
+    int tResult = 0;
+    for (int tBit = 1; tBit < aSize; tBit <<= 1) {
+        tResult = (tResult << 1) | ((aValue & tBit) ? 1 : 0);
+    }
+    return tResult;
+}
+
+/**
+ * In place complex FFT with the output order and inverse scaling of the CMSIS radix 2 functions
+ */
+static void computeComplexFFT(std::vector<Complex> & aValues, bool aInverse, bool aBitReverse) {
+    int tSize = aValues.size();
+    if (aInverse) {
+        for (int i = 0; i < tSize; ++i) {
+            aValues[i] = std::conj(aValues[i]);
+        }
+    }
+    std::vector<Complex> tResult(tSize);
+    splitRadixFFT(&aValues[0], &tResult[0], tSize, 1);
+    for (int i = 0; i < tSize; ++i) {
+        Complex tValue = tResult[i];
+        if (aInverse) {
+            tValue = std::conj(tValue) / (double) tSize;
+        }
+        // without bit reversal CMSIS leaves the output in bit reversed order
+        aValues[aBitReverse ? i : reverseBits(i, tSize)] = tValue;
+    }
+}
+
+static arm_status checkFFTLength(uint16_t aFFTLength) {
+    if (aFFTLength < 2 || aFFTLength > 4096 || (aFFTLength & (aFFTLength - 1)) != 0) {
+        return ARM_MATH_ARGUMENT_ERROR;
+    }
+    return ARM_MATH_SUCCESS;
+}
+
+arm_status arm_cfft_radix2_init_f32(arm_cfft_radix2_instance_f32 *S, uint16_t fftLen, uint8_t ifftFlag, uint8_t bitReverseFlag) {
+    S->fftLen = fftLen;
+    S->ifftFlag = ifftFlag;
+    S->bitReverseFlag = bitReverseFlag;
+    return checkFFTLength(fftLen);
+}
+
+void arm_cfft_radix2_f32(const arm_cfft_radix2_instance_f32 *S, float32_t *pSrc) {
+    std::vector<Complex> tValues(S->fftLen);
+    for (int i = 0; i < S->fftLen; ++i) {
+        tValues[i] = Complex(pSrc[2 * i], pSrc[2 * i + 1]);
+    }
+    computeComplexFFT(tValues, S->ifftFlag, S->bitReverseFlag);
+    for (int i = 0; i < S->fftLen; ++i) {
+        pSrc[2 * i] = tValues[i].real();
+        pSrc[2 * i + 1] = tValues[i].imag();
+    }
+}
+
+arm_status arm_cfft_radix2_init_q15(arm_cfft_radix2_instance_q15 *S, uint16_t fftLen, uint8_t ifftFlag, uint8_t bitReverseFlag) {
+    S->fftLen = fftLen;
+    S->ifftFlag = ifftFlag;
+    S->bitReverseFlag = bitReverseFlag;
+    return checkFFTLength(fftLen);
+}
+
+/**
+ * CMSIS scales each of the log2(fftLen) stages by 1/2, so forward and inverse FFT are scaled down by fftLen
+ */
+void arm_cfft_radix2_q15(const arm_cfft_radix2_instance_q15 *S, q15_t *pSrc) {
+    std::vector<Complex> tValues(S->fftLen);
+    for (int i = 0; i < S->fftLen; ++i) {
+        tValues[i] = Complex(pSrc[2 * i], pSrc[2 * i + 1]);
+    }
+    computeComplexFFT(tValues, S->ifftFlag, S->bitReverseFlag);
+    // the inverse is already scaled by computeComplexFFT()
+    double tScale = S->ifftFlag ? 1.0 : 1.0 / S->fftLen;
+    for (int i = 0; i < S->fftLen; ++i) {
+        pSrc[2 * i] = saturateQ15(floor(tValues[i].real() * tScale));
+        pSrc[2 * i + 1] = saturateQ15(floor(tValues[i].imag() * tScale));
+    }
+}
+
+/**
+ * Index of first maximum like CMSIS
+ */
+void arm_max_q15(q15_t *pSrc, uint32_t blockSize, q15_t *pResult, uint32_t *pIndex) {
+    q15_t tMax = pSrc[0];
+    uint32_t tIndex = 0;
+    for (uint32_t i = 1; i < blockSize; ++i) {
+        if (pSrc[i] > tMax) {
+            tMax = pSrc[i];
+            tIndex = i;
+        }
+    }
+    *pResult = tMax;
+    *pIndex = tIndex;
+}
+
+/**
+ * Coefficients are in time reversed order, state holds numTaps + blockSize - 1 values, the oldest first
+ */
+arm_status arm_fir_init_q15(arm_fir_instance_q15 *S, uint16_t numTaps, q15_t *pCoeffs, q15_t *pState, uint32_t blockSize) {
+    S->numTaps = numTaps;
+    S->pCoeffs = pCoeffs;
+    S->pState = pState;
+    for (uint32_t i = 0; i < numTaps + blockSize - 1; ++i) {
+        pState[i] = 0;
+    }
+    return ARM_MATH_SUCCESS;
+}
+
+void arm_fir_q15(const arm_fir_instance_q15 *S, q15_t *pSrc, q15_t *pDst, uint32_t blockSize) {
+    int tNumberOfTaps = S->numTaps;
+    q15_t * tState = S->pState;
+    for (uint32_t i = 0; i < blockSize; ++i) {
+        tState[tNumberOfTaps - 1 + i] = pSrc[i];
+    }
+    for (uint32_t i = 0; i < blockSize; ++i) {
+        int64_t tAccumulator = 0;
+        for (int k = 0; k < tNumberOfTaps; ++k) {
+            tAccumulator += (int32_t) tState[i + k] * S->pCoeffs[k];
+        }
+        pDst[i] = saturateQ15(tAccumulator >> 15);
+    }
+    // keep the last numTaps - 1 inputs for the next block
+    for (int i = 0; i < tNumberOfTaps - 1; ++i) {
+        tState[i] = tState[blockSize + i];
+    }
+}
+
+/**
+ * Coefficients of each stage are b0, 0, b1, b2, a1, a2, state of each stage is x[n-1], x[n-2], y[n-1], y[n-2]
+ */
+void arm_biquad_cascade_df1_init_q15(arm_biquad_casd_df1_inst_q15 *S, uint8_t numStages, q15_t *pCoeffs, q15_t *pState,
+        int8_t postShift) {
+    S->numStages = numStages;
+    S->pCoeffs = pCoeffs;
+    S->pState = pState;
+    S->postShift = postShift;
+    for (int i = 0; i < 4 * numStages; ++i) {
+        pState[i] = 0;
+    }
+}
+
+void arm_biquad_cascade_df1_q15(const arm_biquad_casd_df1_inst_q15 *S, q15_t *pSrc, q15_t *pDst, uint32_t blockSize) {
+    q15_t * tInput = pSrc;
+    for (int tStage = 0; tStage < S->numStages; ++tStage) {
+        const q15_t * tCoefficients = &S->pCoeffs[6 * tStage];
+        q15_t * tState = &S->pState[4 * tStage];
+        for (uint32_t i = 0; i < blockSize; ++i) {
+            int64_t tAccumulator = (int64_t) tCoefficients[0] * tInput[i] + (int64_t) tCoefficients[2] * tState[0]
+                    + (int64_t) tCoefficients[3] * tState[1] + (int64_t) tCoefficients[4] * tState[2]
+                    + (int64_t) tCoefficients[5] * tState[3];
+            q15_t tOutput = saturateQ15(tAccumulator >> (15 - S->postShift));
+            tState[1] = tState[0];
+            tState[0] = tInput[i];
+            tState[3] = tState[2];
+            tState[2] = tOutput;
+            pDst[i] = tOutput;
+        }
+        tInput = pDst;
+    }
+}
+
+float32_t arm_sin_f32(float32_t x) {
+    return sinf(x);
+}
+
+float32_t arm_cos_f32(float32_t x) {
+    return cosf(x);
+}
@@ -0,0 +1,79 @@
+/**
+ * arm_math.h
+ *
+ * Host replacement of the CMSIS-DSP header for the host build of the DSO sources.
+ * Declares the subset of CMSIS-DSP functions used by the DSO with the argument conventions of CMSIS-DSP 1.x.
+ * They are implemented portably in arm_math.cpp.
+ *
+ * @date 17.10.2026
+ * @copyright LGPL v3 (http://www.gnu.org/licenses/lgpl.html)
+ */
+
+#ifndef ARM_MATH_H_
+#define ARM_MATH_H_
+
+#include <stdint.h>
+#include <math.h>
+#include "stm32f30x.h"
+
+typedef int16_t q15_t;
+typedef int32_t q31_t;
+typedef int64_t q63_t;
+typedef float float32_t;
+
+#define PI 3.14159265358979f
+
+typedef enum {
+    ARM_MATH_SUCCESS = 0, ARM_MATH_ARGUMENT_ERROR = -1, ARM_MATH_LENGTH_ERROR = -2
+} arm_status;
+
+typedef struct {
+    uint16_t fftLen;
+    uint8_t ifftFlag;
+    uint8_t bitReverseFlag;
+} arm_cfft_radix2_instance_f32;
+
+typedef struct {
+    uint16_t fftLen;
+    uint8_t ifftFlag;
+    uint8_t bitReverseFlag;
+} arm_cfft_radix2_instance_q15;
+
+typedef struct {
+    uint16_t numTaps;
+    q15_t *pState;
+    q15_t *pCoeffs;
+} arm_fir_instance_q15;
+
+typedef struct {
+    int8_t numStages;
+    q15_t *pState;
+    q15_t *pCoeffs;
+    int8_t postShift;
+} arm_biquad_casd_df1_inst_q15;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+arm_status arm_cfft_radix2_init_f32(arm_cfft_radix2_instance_f32 *S, uint16_t fftLen, uint8_t ifftFlag, uint8_t bitReverseFlag);
+void arm_cfft_radix2_f32(const arm_cfft_radix2_instance_f32 *S, float32_t *pSrc);
+arm_status arm_cfft_radix2_init_q15(arm_cfft_radix2_instance_q15 *S, uint16_t fftLen, uint8_t ifftFlag, uint8_t bitReverseFlag);
+void arm_cfft_radix2_q15(const arm_cfft_radix2_instance_q15 *S, q15_t *pSrc);
+
+void arm_max_q15(q15_t *pSrc, uint32_t blockSize, q15_t *pResult, uint32_t *pIndex);
+
+arm_status arm_fir_init_q15(arm_fir_instance_q15 *S, uint16_t numTaps, q15_t *pCoeffs, q15_t *pState, uint32_t blockSize);
+void arm_fir_q15(const arm_fir_instance_q15 *S, q15_t *pSrc, q15_t *pDst, uint32_t blockSize);
+void arm_biquad_cascade_df1_init_q15(arm_biquad_casd_df1_inst_q15 *S, uint8_t numStages, q15_t *pCoeffs, q15_t *pState,
+        int8_t postShift);
+void arm_biquad_cascade_df1_q15(const arm_biquad_casd_df1_inst_q15 *S, q15_t *pSrc, q15_t *pDst, uint32_t blockSize);
+
+float32_t arm_sin_f32(float32_t x);
+float32_t arm_cos_f32(float32_t x);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ARM_MATH_H_ */
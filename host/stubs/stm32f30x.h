@@ -0,0 +1,174 @@
+/**
+ * stm32f30x.h
+ *
+ * Host replacement of the device header for the host build of the DSO sources.
+ * Only the registers and library functions used by TouchDSOAcquisition.cpp and TouchDSODisplay.cpp are declared.
+ * The DMA counter register and the cycle counter are proxies,
+ * reading CNDTR advances the simulated DMA transfer and reading CYCCNT returns the time stamp counter of the host.
+ *
+ * @date 17.10.2026
+ * @copyright LGPL v3 (http://www.gnu.org/licenses/lgpl.html)
+ */
+
+#ifndef STM32F30X_H_
+#define STM32F30X_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define __IO volatile
+#define __I volatile const
+#define __STATIC_INLINE static inline
+#define HSE_VALUE 8000000
+
+typedef enum {
+    RESET = 0, SET = !RESET
+} FlagStatus, ITStatus;
+
+typedef enum {
+    DISABLE = 0, ENABLE = !DISABLE
+} FunctionalState;
+
+#ifdef __cplusplus
+/*
+ * Each read of CNDTR lets the simulated DMA transfer HOST_DMA_SAMPLES_PER_COUNT_READ further samples,
+ * like the real DMA which runs in parallel to the trigger search of the half transfer interrupt.
+ */
+uint32_t hostReadDMACount(void);
+struct HostDMACountRegister {
+    uint32_t Value;
+    operator uint32_t() const volatile {
+        return hostReadDMACount();
+    }
+    volatile HostDMACountRegister & operator=(uint32_t aValue) volatile {
+        Value = aValue;
+        return *this;
+    }
+};
+
+uint32_t hostReadCycleCounter(void);
+struct HostCycleCounterRegister {
+    operator uint32_t() const volatile {
+        return hostReadCycleCounter();
+    }
+    volatile HostCycleCounterRegister & operator=(uint32_t aValue) volatile {
+        return *this;
+    }
+};
+#endif
+
+typedef struct {
+    __IO uint32_t ISR;
+    __IO uint32_t IER;
+    __IO uint32_t CR;
+    __IO uint32_t CFGR;
+    __IO uint32_t DR;
+} ADC_TypeDef;
+
+typedef struct {
+    __IO uint32_t CCR;
+    __IO HostDMACountRegister CNDTR;
+    __IO uint32_t CPAR;
+    __IO uint32_t CMAR;
+} DMA_Channel_TypeDef;
+
+typedef struct {
+    __IO uint32_t CTRL;
+    __IO uint32_t LOAD;
+    __IO uint32_t VAL;
+    __IO uint32_t CALIB;
+} SysTick_Type;
+
+typedef struct {
+    __IO uint32_t MODER;
+    __IO uint32_t OTYPER;
+    __IO uint32_t OSPEEDR;
+    __IO uint32_t PUPDR;
+    __IO uint32_t IDR;
+    __IO uint32_t ODR;
+    __IO uint32_t BSRR;
+    __IO uint32_t LCKR;
+    __IO uint32_t AFR[2];
+    __IO uint32_t BRR;
+} GPIO_TypeDef;
+
+typedef struct {
+    __IO uint32_t CTRL;
+    __IO HostCycleCounterRegister CYCCNT;
+} DWT_Type;
+
+typedef struct {
+    __IO uint32_t DEMCR;
+} CoreDebug_Type;
+
+extern ADC_TypeDef HostADC1;
+extern DMA_Channel_TypeDef HostDMA1Channel1;
+extern SysTick_Type HostSysTick;
+extern GPIO_TypeDef HostGPIO;
+extern DWT_Type HostDWT;
+extern CoreDebug_Type HostCoreDebug;
+
+#define ADC1 (&HostADC1)
+#define DMA1_Channel1 (&HostDMA1Channel1)
+#define SysTick (&HostSysTick)
+#define GPIOB (&HostGPIO)
+#define GPIOD (&HostGPIO)
+#define GPIOE (&HostGPIO)
+#define DWT (&HostDWT)
+#define CoreDebug (&HostCoreDebug)
+
+#define DWT_CTRL_CYCCNTENA_Msk (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk (1UL << 24)
+#define SysTick_CTRL_COUNTFLAG_Msk (1UL << 16)
+
+#define DMA1_IT_GL1 ((uint32_t)0x00000001)
+#define DMA1_IT_TC1 ((uint32_t)0x00000002)
+#define DMA1_IT_HT1 ((uint32_t)0x00000004)
+#define DMA1_IT_TE1 ((uint32_t)0x00000008)
+
+#define GPIO_Pin_0 ((uint16_t)0x0001)
+#define GPIO_Pin_4 ((uint16_t)0x0010)
+#define GPIO_Pin_5 ((uint16_t)0x0020)
+#define GPIO_Pin_7 ((uint16_t)0x0080)
+#define GPIO_Pin_10 ((uint16_t)0x0400)
+#define RCC_AHBPeriph_GPIOB ((uint32_t)0x00040000)
+#define RCC_AHBPeriph_GPIOD ((uint32_t)0x00100000)
+#define RCC_AHBPeriph_GPIOE ((uint32_t)0x00200000)
+
+#define ADC_Channel_2 ((uint8_t)0x02)
+#define ADC_Channel_3 ((uint8_t)0x03)
+#define ADC_Channel_4 ((uint8_t)0x04)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+ITStatus DMA_GetITStatus(uint32_t DMAy_IT);
+void DMA_ClearITPendingBit(uint32_t DMAy_IT);
+void ADC_StartConversion(ADC_TypeDef* ADCx);
+void ADC_StopConversion(ADC_TypeDef* ADCx);
+#ifdef __cplusplus
+}
+#endif
+
+/*
+ * Core functions - the SIMD instructions are only used inside #ifdef __ARM_ARCH_7EM__
+ */
+static inline uint32_t __get_IPSR(void) {
+    return 0;
+}
+static inline uint32_t __CLZ(uint32_t aValue) {
+    return (aValue == 0) ? 32 : __builtin_clz(aValue);
+}
+static inline void __NOP(void) {
+}
+static inline void __disable_irq(void) {
+}
+static inline void __enable_irq(void) {
+}
+
+/*
+ * The device header includes stm32f30x_conf.h, of which only assert.h is needed by the DSO sources
+ */
+#include "assert.h"
+
+#endif /* STM32F30X_H_ */
@@ -0,0 +1,15 @@
+/**
+ * stm32f3_discovery.h
+ *
+ * Host replacement of the board header - the DSO sources use no board function.
+ *
+ * @date 17.10.2026
+ * @copyright LGPL v3 (http://www.gnu.org/licenses/lgpl.html)
+ */
+
+#ifndef STM32F3_DISCOVERY_H_
+#define STM32F3_DISCOVERY_H_
+
+#include "stm32f30x.h"
+
+#endif /* STM32F3_DISCOVERY_H_ */
@@ -0,0 +1,10 @@
+/**
+ * thickline.h
+ *
+ * BlueDisplay.h includes thickLine.h with the spelling of a case insensitive file system.
+ *
+ * @date 17.10.2026
+ * @copyright LGPL v3 (http://www.gnu.org/licenses/lgpl.html)
+ */
+
+#include "thickLine.h"
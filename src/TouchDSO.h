@@ -66,7 +66,10 @@ void setTriggerLevelAndHysteresis(int aRawTriggerValue, int aRawTriggerHysteresi
 bool changeInputRange(int aValue);
 int changeDisplayRange(int aValue);
 bool setDisplayRange(int aNewDisplayRangeIndex, bool aClipToIndexInputRange);
-void adjustPreTriggerBuffer(uint16_t* tTempBuffer);
+void setPreTriggerRing(void);
+void linearizePreTriggerBuffer(void);
+void linearizeRollBuffer(void);
+void adjustSegmentsPreTriggerBuffer(void);
 uint16_t computeNumberOfSamplesToTimeout(uint16_t aTimebaseIndex);
 void computeMinMaxAverageAndPeriodFrequency(void);
 bool setInputRange(int aValue);
@@ -80,18 +83,21 @@ void drawTriggerLine(void);
 void clearTriggerLine(uint8_t aTriggerLevelDisplayValue);
 void printTriggerInfo(void);
 
+char getTimebaseUnitChar(int aTimebaseIndex);
 void printInfo(void);
 void clearInfo(void);
 void clearDiplayedChart(void);
 void drawDataBuffer(uint16_t *aDataBufferPointer, int aLength, uint16_t aColor, uint16_t aClearBeforeColor);
 void drawRemainingDataBufferValues(uint16_t aDrawColor);
+void drawRollModeValues(uint16_t aDrawColor);
 
 void initScaleValuesForDisplay(void);
 void testDSOConversions(void);
 int getDisplayFrowRawInputValue(int aAdcValue);
-int getDisplayFrowMultipleRawValues(uint16_t * aAdcValuePtr, int aCount);
 
 void initRawToDisplayFactors(void);
+void initRawToDisplayTable(void);
+void invalidateMinMaxPyramid(void);
 int getRawOffsetValueFromGridCount(int aCount);
 int getInputRawFromDisplayValue(int aValue);
 float getFloatFromRawValue(int aValue);
@@ -114,12 +120,17 @@ float getFloatFromDisplayValue(uint8_t aValue);
 #define CHANGE_REQUESTED_TIMEBASE 0x01
 #define TIMEBASE_FAST_MODES 7 // first modes are fast DMA modes
 #define TIMEBASE_INDEX_DRAW_WHILE_ACQUIRE 17 // min index where chart is drawn while buffer is filled
-#define TIMEBASE_NUMBER_OF_ENTRIES 21 // the number of different timebase provided - 1. entry is not uses until interleaved acquisition is implemented
+#define TIMEBASE_NUMBER_OF_ENTRIES 21 // the number of different timebase provided - 1. entry uses equivalent time sampling
 #define TIMEBASE_NUMBER_OF_EXCACT_ENTRIES 8 // the number of exact float value for timebase because of granularity of clock division
 #define TIMEBASE_NUMBER_OF_XSCALE_CORRECTION 5  // number of timebase which are simulated by display XSale factor
 #define TIMEBASE_INDEX_MILLIS 11 // min index to switch to ms instead of ns display
 #define TIMEBASE_INDEX_MICROS 2 // min index to switch to us instead of ns display
 #define TIMEBASE_INDEX_START_VALUE 12
+#define TIMEBASE_INDEX_PEAK_DETECT_START TIMEBASE_INDEX_MILLIS // min index for peak detect mode
+// peak detect samples with fixed 160 kHz (72 MHz / (9 * 50)) = 6.25 us
+#define PEAK_DETECT_TIMER_DIVIDER 50
+#define PEAK_DETECT_TIMER_PRESCALER 9
+#define PEAK_DETECT_ADC_CLOCK_PRESCALER 4 // 9 MHz ADC clock => 2.2 us conversion time for slow channel
 extern const uint8_t xScaleForTimebase[TIMEBASE_NUMBER_OF_XSCALE_CORRECTION];
 extern const uint16_t TimebaseDivValues[TIMEBASE_NUMBER_OF_ENTRIES];
 extern const float TimebaseExactDivValuesMicros[TIMEBASE_NUMBER_OF_EXCACT_ENTRIES];
@@ -164,6 +175,7 @@ extern bool isAttenuatorAvailable;
 extern float RawAttenuationFactor[NUMBER_OF_RANGES];
 extern const uint8_t AttenuatorHardwareValue[NUMBER_OF_RANGES];
 extern int FactorFromInputToDisplayRangeShift12;
+extern uint8_t RawToDisplayTable[];
 extern uint16_t RawDSOReadingACZero;
 
 // ADC channel stuff
@@ -176,13 +188,47 @@ extern const char * const ADCInputMUXChannelStrings[ADC_CHANNEL_COUNT];
 extern char ADCInputMUXChannelChars[ADC_CHANNEL_COUNT];
 extern uint8_t ADCInputMUXChannels[ADC_CHANNEL_COUNT];
 
-#define FFT_SIZE 256 // for radix4 - can be 64, 256, 1024 etc.
-void computeFFT(uint16_t * aDataBufferPointer, float32_t *aFFTBuffer);
+#define FFT_SIZE 256 // real input FFT for running display - power of 2
+#define FFT_SIZE_MAX 512 // for analysis of stopped data - in place FFT of FFT_SIZE_MAX floats fits in FourDisplayLinesBuffer
+void computeFFT(uint16_t * aDataBufferPointer, float32_t *aFFTBuffer, int aFFTSize);
+uint16_t * getFFTDataBufferPointer(uint16_t * aDataBufferPointer, int aCount);
+q15_t * computeFFTQ15(uint16_t * aDataBufferPointer, q15_t *aFFTBuffer);
+void resetFFTAverage(void);
+int getLog2Shift8(uint32_t aValue);
+
+#define FFT_WINDOW_RECTANGLE 0
+#define FFT_WINDOW_HANN 1
+#define FFT_WINDOW_HAMMING 2
+#define FFT_WINDOW_FLAT_TOP 3 // for amplitude measurement
+#define FFT_WINDOW_NUMBER 4
+
+// averaging of running FFT
+#define FFT_AVERAGE_OFF 0
+#define FFT_AVERAGE_EXPONENTIAL 1
+#define FFT_AVERAGE_BLOCK 2 // average of FFT_AVERAGE_BLOCK_SIZE frames
+#define FFT_PEAK_HOLD 3
+#define FFT_AVERAGE_NUMBER 4
+#define FFT_AVERAGE_EXPONENTIAL_SHIFT 3 // weight of new frame is 1/8
+#define FFT_AVERAGE_BLOCK_SIZE 8
+
+#define FFT_DB_RANGE 60 // dB shown by FFT bars and chart
 void draw128FFTValuesFast(uint16_t aColor, uint16_t * aDataBufferPointer);
 void clearFFTValuesOnDisplay(void);
 void drawFFT(void);
 extern uint8_t DisplayBufferFFT[FFT_SIZE / 2];
 
+/*
+ * Waterfall page - the running FFT adds one row of 8 bit levels per acquisition to a ring buffer.
+ * Each row has a fixed slot on the page, the slot of the oldest row is marked by a line.
+ */
+#define FFT_WATERFALL_BINS (DSO_DISPLAY_WIDTH / 3) // 106 - same 3 pixel width as the FFT bars
+#define FFT_WATERFALL_ROWS 40 // 4240 bytes ring buffer
+#define FFT_WATERFALL_ROW_HEIGHT 4
+#define FFT_WATERFALL_Y_START 56 // below the back button
+void resetWaterfall(void);
+void drawWaterfall(void);
+void addFFTWaterfallRow(uint16_t * aDataBufferPointer);
+
 struct MeasurementControlStruct {
     bool isRunning;
     volatile uint8_t ChangeRequestedFlags; // GUI (Event) -> Thread (main loop) - change of clock prescaler requested from GUI
@@ -225,12 +271,33 @@ struct MeasurementControlStruct {
 
     uint16_t RawValueAverage;
 
+    // computed in the same pass as min, max and average
+    uint16_t RawValueRMS; // contains RawDSOReadingACZero in AC mode like the other raw values
+    uint8_t DutyCyclePercent; // positive duty cycle of entire periods - 0 if no periods found
+    uint8_t OvershootPercent; // max above top level relative to top - base level
+    uint16_t PulseCount; // number of 10% to 90% rising edges
+    float RiseMicros; // average time from 10% to 90% level
+    float FallMicros; // average time from 90% to 10% level
+
     // Timebase
     bool TimebaseFastDMAMode;
     int8_t TimebaseNewIndex; // set by touch handler
     int8_t TimebaseIndex;
     uint8_t ADCInputMUXChannelIndex;
 
+    bool isDeepMemoryMode; // GUI - pack post trigger data of last acquisition (stop / single shot) in interrupt mode
+    bool isStreamingStatisticsMode; // GUI - compute min, max, average and period in ISR / DMA interrupts while acquiring
+    volatile bool isSegmentMode; // GUI -> ADC-ISR - capture DATABUFFER_NUMBER_OF_SEGMENTS trigger events into DataBuffer
+
+    // Peak detect - ISR stores min and max of PeakDetectWindowSampleCount fast samples instead of 2 single samples
+    bool isPeakDetectMode; // GUI
+    volatile bool PeakDetectActive; // set by changeTimeBase() - isPeakDetectMode && TimebaseIndex >= TIMEBASE_INDEX_PEAK_DETECT_START
+    uint16_t PeakDetectWindowSampleCount;
+
+    // Roll mode - ISR fills the whole DataBuffer as a ring without trigger and never ends the acquisition by itself
+    bool isRollMode; // GUI
+    volatile bool RollModeActive; // set by startAcquisition() - isRollMode && TimebaseIndex >= TIMEBASE_INDEX_DRAW_WHILE_ACQUIRE
+
     // Range
     bool RangeAutomatic; // [RANGE_MODE_AUTOMATIC, MANUAL]
     bool isACMode; // false: unipolar mode => 0V probe input -> 0V ADC input  - true: AC range => 0V probe input -> 1.5V ADC input
@@ -264,15 +331,34 @@ extern unsigned int sDatabufferPreDisplaySize;
 #define DATABUFFER_DISPLAY_END (DATABUFFER_DISPLAY_START + DSO_DISPLAY_WIDTH - 1)
 #define DATABUFFER_POST_TRIGGER_START (&DataBuffer[DATABUFFER_PRE_TRIGGER_SIZE])
 #define DATABUFFER_POST_TRIGGER_SIZE (DATABUFFER_SIZE - DATABUFFER_PRE_TRIGGER_SIZE)
+// packed deep memory - 2 post trigger values of 12 bit are stored in 3 bytes
+#define DATABUFFER_PACKED_POST_TRIGGER_SIZE (((DATABUFFER_POST_TRIGGER_SIZE * 2) / 3) * 2)
+#define DATABUFFER_PACKED_SIZE (DATABUFFER_PRE_TRIGGER_SIZE + DATABUFFER_PACKED_POST_TRIGGER_SIZE)
+bool isPackedLastAcquisitionPossible(void);
 #define DATABUFFER_INVISIBLE_RAW_VALUE 0x1000 // Value for invalid data in/from pretrigger area
 #define DISPLAYBUFFER_INVISIBLE_VALUE 0xFF // Value for invisible data in display buffer. Used if raw value was DATABUFFER_INVISIBLE_RAW_VALUE
 struct DataBufferStruct {
     volatile bool DataBufferFull; // ISR -> main loop
     bool DrawWhileAcquire;
     volatile bool DataBufferPreTriggerAreaWrapAround; // ISR -> draw-while-acquire mode
+    volatile bool DataBufferRollWrapAround; // ISR -> main loop - roll mode ring was filled completely at least once
+    /*
+     * Post trigger values are packed - pointers behind DataBufferControl.DataBuffer[DATABUFFER_PRE_TRIGGER_SIZE] are virtual
+     * then and can go up to DataBuffer[DATABUFFER_PACKED_SIZE - 1]. Use getDataBufferValue() etc. to read them.
+     */
+    bool isPacked;
     uint8_t InputRangeIndexUsed; // index used for acquisition of buffer data
 
+    uint16_t * DataBufferSegmentStart; // &DataBuffer[0] or start of actual segment in segment mode
+    volatile uint8_t SegmentIndex; // ISR -> main loop - index of actual segment in segment mode
+
     uint16_t * DataBufferPreTriggerNextPointer; // pointer to next pre trigger value in DataBuffer - set only once at end of search trigger phase
+    /*
+     * The pre trigger area is a ring. Its oldest value is at DataBuffer[PreTriggerRingOffset].
+     * Readers use getDataBufferValue() etc. which resolve the ring, the data itself is only moved at stop.
+     */
+    uint16_t PreTriggerRingOffset;
+    uint16_t PreTriggerInvalidCount; // number of never written values at (logical) start of pre trigger area - for draw-while-acquire
     uint16_t * DataBufferNextInPointer; // used by ISR as main databuffer pointer - also read by draw-while-acquire mode
     volatile uint16_t * DataBufferNextDrawPointer; // for draw-while-acquire mode
     uint16_t NextDrawXValue; // for draw-while-acquire mode
@@ -289,6 +375,49 @@ struct DataBufferStruct {
 };
 extern struct DataBufferStruct DataBufferControl;
 
+/*
+ * Segment mode - DataBuffer is split into segments each holding a pre trigger area and one screen of data.
+ * The ISR captures consecutive trigger events back to back without any display work in between.
+ */
+#define DATABUFFER_SEGMENT_SIZE (DATABUFFER_PRE_TRIGGER_SIZE + DSO_DISPLAY_WIDTH)
+#define DATABUFFER_NUMBER_OF_SEGMENTS (DATABUFFER_SIZE / DATABUFFER_SEGMENT_SIZE)
+// segment mode is only supported for interrupt mode timebases which are not drawn while acquiring
+#define TIMEBASE_INDEX_SEGMENT_START TIMEBASE_FAST_MODES
+#define TIMEBASE_INDEX_SEGMENT_END (TIMEBASE_INDEX_DRAW_WHILE_ACQUIRE - 1)
+struct SegmentInfoStruct {
+    uint32_t TriggerMillis; // time of trigger, timeout or start of segment (trigger off)
+    uint16_t * PreTriggerNextPointer; // to align pre trigger area after capture
+    uint8_t TriggerStatus; // != TRIGGER_OK if segment ended by trigger timeout
+};
+extern SegmentInfoStruct SegmentInfo[DATABUFFER_NUMBER_OF_SEGMENTS];
+
+/*
+ * Second buffer for the display region of the last acquisition.
+ * The main loop analyzes and draws this copy while the ISR / DMA already fills DataBufferControl with the next acquisition.
+ */
+struct DisplayDataBufferStruct {
+    uint8_t InputRangeIndexUsed; // index used for acquisition of buffer data
+    uint16_t DataBuffer[DSO_DISPLAY_WIDTH];
+};
+extern struct DisplayDataBufferStruct DisplayDataBufferControl;
+void copyDataBufferDisplayRegion(void);
+
+uint16_t getDataBufferValue(uint16_t * aDataBufferPointer);
+uint16_t * getLinearDataBufferPointer(uint16_t * aDataBufferPointer, uint16_t * aBuffer, int aCount);
+uint16_t * getDataBufferDisplayPointer(void);
+
+/*
+ * Filter for displayed data - the filter runs on a copy of the data to be displayed with 15 bit fixed point values
+ */
+#define FILTER_TYPE_NONE 0
+#define FILTER_TYPE_MOVING_AVERAGE 1 // 8 values
+#define FILTER_TYPE_IIR 2 // 2. order Butterworth low pass at 0.05 * sample rate
+#define FILTER_TYPE_FIR 3 // 16 taps Hamming low pass at 0.1 * sample rate
+#define FILTER_TYPE_NUMBER 4
+#define FILTER_VIEW_BUFFER_SIZE (4 * DSO_DISPLAY_WIDTH) // greater compressions are displayed unfiltered
+void initFilter(void);
+uint16_t * getFilteredDataBufferPointer(uint16_t * aDataBufferPointer, int aCount);
+
 /*
  * Display control
  * while running switch between upper info line on/off
@@ -305,20 +434,27 @@ enum InfoModeEnum {
 };
 
 enum DisplayPageEnum {
-    START, CHART, SETTINGS, MORE_SETTINGS
+    START, CHART, SETTINGS, MORE_SETTINGS, FFT_SETTINGS, WATERFALL
 };
 
 // Modes for DisplayBufferDrawMode
 #define DRAW_MODE_LINE 0x01    // draw as line - otherwise draw only measurement pixel
 #define DRAW_MODE_TRIGGER 0x02 // Trigger state is displayed
+#define DRAW_MODE_DECODE 0x04 // UART bytes decoded from trigger state are displayed
 #define SCALE_CHANGE_DELAY_MILLIS 2000
 #define DRAW_HISTORY_LEVELS 4 // 0 = No history, 3 = history high
+#define DRAW_HISTORY_PERSISTENCE DRAW_HISTORY_LEVELS // EraseColorIndex for persistence display
 struct DisplayControlStruct {
     uint8_t TriggerLevelDisplayValue; // For clearing old line of manual trigger level setting
     uint8_t DisplayBufferDrawMode;
     InfoModeEnum showInfoMode; // ONLY_DATA | PLUS_INFO
-    DisplayPageEnum DisplayPage; // START, CHART, SETTINGS, MORE_SETTINGS
+    DisplayPageEnum DisplayPage; // START, CHART, SETTINGS, MORE_SETTINGS, FFT_SETTINGS, WATERFALL
     bool ShowFFT;
+    uint16_t FFTSize; // FFT_SIZE or FFT_SIZE_MAX - samples used for FFT of stopped data
+    uint8_t FFTWindowType; // FFT_WINDOW_HANN etc.
+    uint8_t FFTAverageMode; // FFT_AVERAGE_OFF etc. - for running FFT only
+    bool FFTShowDB; // logarithmic scale for FFT
+    bool ShowHarmonics; // amplitude, phase and THD of fundamental in info line
 
     /**
      * XScale > 1 : expansion by factor XScale
@@ -338,7 +474,9 @@ struct DisplayControlStruct {
 
     uint16_t EraseColors[DRAW_HISTORY_LEVELS];
     uint16_t EraseColor;
-    uint8_t EraseColorIndex;
+    uint8_t EraseColorIndex; // 0 to DRAW_HISTORY_PERSISTENCE
+
+    uint8_t FilterType; // FILTER_TYPE_NONE etc. - for display and FFT only, acquired data is not changed
 };
 extern DisplayControlStruct DisplayControl;
 
@@ -362,11 +500,197 @@ extern DisplayControlStruct DisplayControl;
 #define COLOR_DATA_ERASE_HIGH RGB(0x40,0xC0,0x40)
 
 struct FFTInfoStruct {
-    float MaxValue; // max bin value for y scaling
+    float MaxValue; // max bin value for y scaling - amplitude in volt for computeFFTQ15()
     int MaxIndex;   // index of MaxValue
+    uint16_t Size; // number of samples of last fft
     uint32_t TimeElapsedMillis; // milliseconds of computing last fft
 };
 extern FFTInfoStruct FFTInfo;
+
+/*
+ * Harmonic analysis - Goertzel filters at the measured frequency and its harmonics, no FFT needed
+ */
+#define HARMONICS_NUMBER 5 // fundamental and 2. to 5. harmonic
+struct HarmonicsInfoStruct {
+    float Amplitude[HARMONICS_NUMBER]; // in volt - 0 if harmonic is above half of sample frequency
+    float PhaseDegree; // of fundamental relative to first displayed sample
+    float THDPercent;
+    float FrequencyHertz; // refined fundamental
+    uint8_t HarmonicsUsed; // harmonics below half of sample frequency including fundamental
+    bool Valid;
+};
+extern HarmonicsInfoStruct HarmonicsInfo;
+void computeHarmonics(uint16_t * aDataBufferPointer, int aCount);
 extern uint8_t DisplayBuffer[DSO_DISPLAY_WIDTH];
 
+/*
+ * Persistence - display values of each acquisition are folded into a grid of 4 bit hit counts,
+ * which is drawn with an intensity color map every PERSISTENCE_DRAW_MILLIS and decayed every PERSISTENCE_DECAY_DRAWS draws.
+ */
+#define PERSISTENCE_ROW_HEIGHT 5
+#define PERSISTENCE_ROWS (DSO_DISPLAY_HEIGHT / PERSISTENCE_ROW_HEIGHT) // 48 -> 7680 bytes grid
+#define PERSISTENCE_MAX_COUNT 0x0F
+#define PERSISTENCE_DRAW_MILLIS 100
+#define PERSISTENCE_DECAY_DRAWS 4
+#define PERSISTENCE_HISTOGRAM_WIDTH 32 // voltage histogram at right border of chart
+struct PersistenceInfoStruct {
+    uint32_t LastDrawMillis;
+    uint8_t DrawCount; // for decay
+    uint16_t FramesFolded; // since last draw
+    uint16_t Histogram[PERSISTENCE_ROWS]; // samples per row since last draw
+};
+extern PersistenceInfoStruct PersistenceInfo;
+void clearPersistence(void);
+void accumulatePersistence(uint16_t * aDataBufferPointer);
+void drawPersistence(void);
+
+/*
+ * Acquisition statistics - to measure throughput of the acquire / display cycle on target
+ */
+#define BENCHMARK_MILLIS_PER_TIMEBASE 2000
+#define BENCHMARK_TIMEBASE_INDEX_END TIMEBASE_INDEX_DRAW_WHILE_ACQUIRE // draw while acquire timebases need seconds for one acquisition
+#define BENCHMARK_PACKED_TIMEBASE_INDEX_END TIMEBASE_INDEX_MILLIS // a packed acquisition of 4000 samples needs more than 60 ms above
+struct AcquisitionInfoStruct {
+    volatile bool isBenchmarkActive; // Thread -> ISR - cycles and samples of ISR are only counted while benchmark is running
+    uint32_t StartMillis; // start of actual measurement interval
+    uint16_t AcquisitionCount; // number of completed acquisitions in interval
+    uint16_t TriggerTimeoutCount; // number of acquisitions ended by trigger timeout
+    volatile uint32_t ISRCycles; // CPU cycles spent in ADC ISR or in DMA trigger search
+    volatile uint32_t ISRSampleCount; // samples processed by ADC ISR or checked by DMA trigger search
+    uint32_t StatisticsCycles; // CPU cycles spent in the statistics pass of computeMinMaxAverageAndPeriodFrequency()
+    uint32_t StatisticsSampleCount; // samples processed by the statistics pass
+};
+extern AcquisitionInfoStruct AcquisitionInfo;
+
+struct AcquisitionBenchmarkResultStruct {
+    float AcquisitionsPerSecond;
+    uint8_t TriggerHitPercent;
+    uint16_t CyclesPerSample; // for DMA modes cycles per sample checked for trigger condition
+    uint16_t PackedCyclesPerSample; // for interrupt mode with deep memory - 0 if not available
+    uint16_t StatisticsCyclesPerSample; // for the statistics pass in thread mode
+};
+extern AcquisitionBenchmarkResultStruct AcquisitionBenchmarkResults[TIMEBASE_NUMBER_OF_ENTRIES];
+
+void initAcquisitionStatistics(void);
+void resetAcquisitionStatistics(void);
+void countAcquisitionForStatistics(void);
+void computeAcquisitionStatistics(AcquisitionBenchmarkResultStruct * aResult);
+void drawAcquisitionBenchmarkResults(void);
+
+void drawSegment(int aSegmentIndex);
+
+/*
+ * Serial decoder - thresholds the data with the trigger level and hysteresis and decodes UART 8N1 frames (idle high).
+ * The bit width is taken from the pulses found, which are multiples of the shortest pulse.
+ * Values are processed one by one, so it can run in draw while acquire mode.
+ */
+#define DECODER_MAX_BYTES 32 // bytes stored for one screen
+#define DECODER_MIN_SAMPLES_PER_BIT 3 // shorter pulses are ignored for bit width
+#define DECODER_MAX_BITS_PER_PULSE 9 // longer pulses (idle) are ignored for bit width
+struct SerialDecoderStruct {
+    // bit level
+    uint16_t HighThreshold;
+    uint16_t LowThreshold;
+    bool LineStateKnown; // false until first visible value
+    bool LineIsHigh;
+    int SampleIndex;
+    int LastEdgeIndex; // -1 if no edge found on this screen
+    // auto baud
+    int ShortestPulse; // 0 if not yet known - kept for next screen
+    int ShortestPulseOfScreen;
+    uint32_t PulseSamplesSum;
+    uint16_t PulseBitsSum;
+    int BitWidthShift4; // samples per bit * 16, 0 if not yet known
+    // frame level
+    int8_t BitIndex; // -1 -> wait for start bit, 0 -> start bit, 9 -> stop bit
+    int NextBitIndexShift4; // sample index for middle of next bit * 16
+    uint16_t FrameStartIndex;
+    uint8_t ShiftRegister;
+    // results
+    uint8_t ByteCount;
+    uint8_t Bytes[DECODER_MAX_BYTES];
+    uint16_t BytePositions[DECODER_MAX_BYTES]; // sample index of start bit
+    bool FrameError[DECODER_MAX_BYTES]; // stop bit was low
+};
+extern SerialDecoderStruct SerialDecoder;
+void startSerialDecoder(void);
+bool decodeSerialValue(uint16_t aRawValue);
+void decodeSerialValues(uint16_t * aDataBufferPointer, int aCount);
+void drawDecodedBytes(int aSamplesPerScreen, int aStartByteIndex);
+void clearDecodedBytes(void);
+
+/*
+ * Equivalent time sampling for repetitive signals at 200 ns/div.
+ * The ADC timer is not synchronized to the signal, so the trigger crossing has a random phase relative to the samples.
+ * The samples of each triggered acquisition are placed in a buffer with display resolution
+ * according to their time relative to the interpolated trigger crossing.
+ */
+#define TIMEBASE_INDEX_EQUIVALENT_TIME 0
+#define EQUIVALENT_TIME_PIXEL_PER_SAMPLE 31 // 5.14 MSamples/s -> 160 MSamples/s effective
+#define EQUIVALENT_TIME_MAX_AGE 128 // number of acquisitions a sample stays valid
+struct EquivalentTimeStruct {
+    uint16_t ReconstructionBuffer[DSO_DISPLAY_WIDTH]; // raw values
+    uint8_t SampleAge[DSO_DISPLAY_WIDTH]; // AcquisitionCount when sample was placed
+    uint8_t AcquisitionCount;
+    uint16_t ValidCount; // pixel with valid sample at last call of getEquivalentTimeValues()
+};
+extern EquivalentTimeStruct EquivalentTime;
+void resetEquivalentTime(void);
+void foldEquivalentTimeSamples(void);
+void getEquivalentTimeValues(uint16_t * aDestinationPointer);
+
+/*
+ * Mask test - the displayed region of the stopped capture is the reference.
+ * Lower and upper limit of each sample are the min and max of the reference sample and its neighbors
+ * extended by a tolerance in display pixel. Each new acquisition is checked sample by sample against the limits.
+ */
+#define MASK_TEST_TOLERANCE_OFF 0 // ToleranceIndex 0 -> mask test off
+#define MASK_TEST_TOLERANCE_NUMBER 4
+#define MASK_FAILURE_COUNT 0 // only count
+#define MASK_FAILURE_STOP 1 // stop and keep failing acquisition
+#define MASK_FAILURE_SAVE 2 // stop and store failing acquisition
+#define MASK_FAILURE_NUMBER 3
+struct MaskTestStruct {
+    uint8_t ToleranceIndex;
+    uint8_t FailureAction;
+    // reference conditions - acquisitions with other settings are not checked
+    uint8_t InputRangeIndex;
+    uint8_t TimebaseIndex;
+    uint32_t PassCount;
+    uint32_t FailCount;
+    int16_t FirstFailureIndex; // of last failed acquisition
+    uint16_t RawLowerLimit[DSO_DISPLAY_WIDTH];
+    uint16_t RawUpperLimit[DSO_DISPLAY_WIDTH];
+};
+extern MaskTestStruct MaskTest;
+extern const uint8_t MaskToleranceDisplayValues[MASK_TEST_TOLERANCE_NUMBER];
+void initMaskTest(uint8_t aToleranceIndex);
+bool checkMask(uint16_t * aDataBufferPointer);
+void drawMaskLimits(void);
+
+/*
+ * Autoset - takes a capture of the whole data buffer with trigger off, starting with the widest input range,
+ * and sets input range, timebase, offset and trigger level in one step for each capture.
+ * Ends if a capture confirms the settings or after AUTOSET_MAX_CAPTURES captures.
+ */
+#define AUTOSET_MAX_CAPTURES 3
+#define AUTOSET_TIMEBASE_INDEX_FIRST TIMEBASE_INDEX_MILLIS // 1 ms/div -> 100 ms for a capture, periods from 250 us to 50 ms
+#define AUTOSET_TIMEBASE_INDEX_FAST 5 // 10 us/div -> periods from 2.4 us
+#define AUTOSET_TIMEBASE_INDEX_SLOW 14 // 10 ms/div -> 1 s for a capture, periods up to 500 ms
+#define AUTOSET_MIN_SAMPLES_PER_PERIOD 8 // below this the period may be aliased
+#define AUTOSET_MIN_PEAK_TO_PEAK 8 // raw value - below this, signal is taken as DC
+#define AUTOSET_PERIODS_PER_SCREEN 2
+struct AutosetInfoStruct {
+    uint32_t StartMillis;
+    uint16_t MillisToStable; // duration of last autoset for info line - 0 if timebase was changed manually afterwards
+    uint8_t CaptureCount;
+    int CrossingCount; // of last capture
+    int PeriodSamples; // of last capture - 0 if less than 2 periods or DC
+};
+extern AutosetInfoStruct AutosetInfo;
+void analyzeAutosetCapture(void);
+bool setAutosetInputRange(void);
+int computeAutosetTimebaseIndex(void);
+void setAutosetOffsetAndTrigger(void);
+
 #endif /* SIMPLETOUCHSCREENDSO_H_ */
@@ -102,12 +102,24 @@ struct MeasurementControlStruct MeasurementControl;
  * Data buffer
  */
 struct DataBufferStruct DataBufferControl;
+struct DisplayDataBufferStruct DisplayDataBufferControl;
 
 /*
  * FFT info
  */
 FFTInfoStruct FFTInfo;
 
+/*
+ * Acquisition statistics
+ */
+AcquisitionInfoStruct AcquisitionInfo;
+AcquisitionBenchmarkResultStruct AcquisitionBenchmarkResults[TIMEBASE_NUMBER_OF_ENTRIES];
+
+/*
+ * Autoset
+ */
+AutosetInfoStruct AutosetInfo;
+
 /**
  * Attenuator (Hardware) related stuff
  */
@@ -176,6 +188,8 @@ void initAcquisition(void) {
     MeasurementControl.TimebaseFastDMAMode = false;
     MeasurementControl.TimebaseIndex = TIMEBASE_INDEX_START_VALUE;
     DataBufferControl.DrawWhileAcquire = (TIMEBASE_INDEX_START_VALUE >= TIMEBASE_INDEX_DRAW_WHILE_ACQUIRE); // false here
+
+    initAcquisitionStatistics();
 }
 
 /**
@@ -195,6 +209,12 @@ void resetAcquisition(void) {
     autoACZeroCalibration(); // sets MeasurementControl.DSOReadingACZero
 
     // Timebase
+    MeasurementControl.isPeakDetectMode = false;
+    MeasurementControl.isDeepMemoryMode = false;
+    MeasurementControl.isStreamingStatisticsMode = false;
+    MeasurementControl.isRollMode = false;
+    MeasurementControl.PeakDetectActive = false;
+    MeasurementControl.RollModeActive = false;
     MeasurementControl.TimebaseNewIndex = MeasurementControl.TimebaseIndex;
     changeTimeBase(true);
 
@@ -221,6 +241,216 @@ void resetAcquisition(void) {
     setACMode(MeasurementControl.isACMode);
 }
 
+/*
+ * Statistics of post trigger values - min, max, average, period, RMS, duty cycle, rise and fall time and overshoot.
+ * Computed either by a separate pass over the data buffer or while acquiring by the ISR / DMA interrupts.
+ * All values are computed in the same pass. The 10%, 50% and 90% levels for duty cycle, rise and fall time
+ * are taken from min and max of the previous acquisition, like the trigger level.
+ * So after a change of the signal amplitude these values are one acquisition late.
+ */
+#define STATISTICS_LEVEL_UNKNOWN 0
+#define STATISTICS_LEVEL_LOW 1 // last value beyond 10% level was below
+#define STATISTICS_LEVEL_HIGH 2 // last value beyond 90% level was above
+struct StatisticsStruct {
+    uint16_t Min;
+    uint16_t Max;
+    bool Falling;
+    uint8_t TriggerStatus;
+    uint16_t ActualCompareValue;
+    bool ReliableValue;
+    uint16_t Count; // number of values added
+    uint32_t IntegrateValue;
+    uint32_t IntegrateValueForTotalPeriods;
+    uint64_t SumOfSquares;
+    uint64_t SumOfSquaresForTotalPeriods;
+    int PeriodCount;
+    int FirstFoundPosition;
+    int LastFoundPosition;
+    int PeriodDelta;
+    int PeriodMin;
+    int PeriodMax;
+    // duty cycle - values above 50% level
+    uint16_t MiddleLevel;
+    uint16_t HighCount;
+    uint16_t HighCountAtFirstPeriod;
+    uint16_t HighCountForTotalPeriods;
+    // rise and fall time between 10% and 90% level and top and base level for overshoot
+    uint16_t LowLevel;
+    uint16_t HighLevel;
+    uint8_t LevelState; // STATISTICS_LEVEL_UNKNOWN, LOW or HIGH - hysteresis between 10% and 90% level
+    uint16_t LastLowPosition;
+    uint16_t LastHighPosition;
+    uint16_t RiseCount;
+    uint16_t FallCount;
+    uint32_t RiseSamplesSum;
+    uint32_t FallSamplesSum;
+    uint32_t TopSum; // sum of values above 90% level
+    uint16_t TopCount;
+    uint32_t BaseSum; // sum of values below 10% level
+    uint16_t BaseCount;
+};
+static StatisticsStruct sStreamingStatistics; // for ISR and DMA interrupts
+static bool sStreamingStatisticsActive; // ISR -> computeMinMaxAverageAndPeriodFrequency()
+static uint16_t * sStreamingStatisticsNextPointer; // next value to add at DMA transfer complete
+
+static void initStatistics(StatisticsStruct * aStatistics) {
+    aStatistics->Min = 0xFFFF;
+    aStatistics->Max = 0;
+    aStatistics->Falling = !MeasurementControl.TriggerSlopeRising;
+    aStatistics->TriggerStatus = TRIGGER_START;
+    aStatistics->ActualCompareValue = MeasurementControl.RawTriggerLevelHysteresis;
+    aStatistics->ReliableValue = true;
+    aStatistics->Count = 0;
+    aStatistics->IntegrateValue = 0;
+    aStatistics->IntegrateValueForTotalPeriods = 0;
+    aStatistics->SumOfSquares = 0;
+    aStatistics->SumOfSquaresForTotalPeriods = 0;
+    aStatistics->PeriodCount = 0;
+    aStatistics->FirstFoundPosition = 0;
+    aStatistics->LastFoundPosition = 0;
+    aStatistics->PeriodDelta = 0;
+    aStatistics->PeriodMin = 1024;
+    aStatistics->PeriodMax = 0;
+
+    // levels from previous acquisition
+    int tPeakToPeak = MeasurementControl.RawValueMax - MeasurementControl.RawValueMin;
+    aStatistics->MiddleLevel = MeasurementControl.RawValueMin + (tPeakToPeak / 2);
+    aStatistics->LowLevel = MeasurementControl.RawValueMin + (tPeakToPeak / 10);
+    aStatistics->HighLevel = MeasurementControl.RawValueMax - (tPeakToPeak / 10);
+    aStatistics->HighCount = 0;
+    aStatistics->HighCountAtFirstPeriod = 0;
+    aStatistics->HighCountForTotalPeriods = 0;
+    aStatistics->LevelState = STATISTICS_LEVEL_UNKNOWN;
+    aStatistics->LastLowPosition = 0;
+    aStatistics->LastHighPosition = 0;
+    aStatistics->RiseCount = 0;
+    aStatistics->FallCount = 0;
+    aStatistics->RiseSamplesSum = 0;
+    aStatistics->FallSamplesSum = 0;
+    aStatistics->TopSum = 0;
+    aStatistics->TopCount = 0;
+    aStatistics->BaseSum = 0;
+    aStatistics->BaseCount = 0;
+}
+
+static inline void addValueToStatistics(StatisticsStruct * aStatistics, uint16_t aValue) {
+    /*
+     * trigger condition and average taken only from entire periods
+     */ //
+    bool tValueGreaterRef = (aValue > aStatistics->ActualCompareValue);
+    tValueGreaterRef = tValueGreaterRef ^ aStatistics->Falling; // change value if Falling == true
+
+    if (aStatistics->TriggerStatus == TRIGGER_START) {
+        // rising slope - wait for value below 1. threshold
+        // falling slope - wait for value above 1. threshold
+        if (!tValueGreaterRef) {
+            aStatistics->TriggerStatus = TRIGGER_BEFORE_THRESHOLD;
+            aStatistics->ActualCompareValue = MeasurementControl.RawTriggerLevel;
+        }
+    } else {
+        // rising slope - wait for value to rise above 2. threshold
+        // falling slope - wait for value to go below 2. threshold
+        if (tValueGreaterRef) {
+            if (aStatistics->PeriodDelta < MIN_SAMPLES_PER_PERIOD_FOR_RELIABLE_FREQUENCY_VALUE) {
+                // found new trigger in less than MIN_SAMPLES_PER_PERIOD_FOR_RELIABLE_FREQUENCY_VALUE samples => no reliable value
+                aStatistics->ReliableValue = false;
+            } else {
+                if (aStatistics->PeriodDelta < aStatistics->PeriodMin) {
+                    aStatistics->PeriodMin = aStatistics->PeriodDelta;
+                } else if (aStatistics->PeriodDelta > aStatistics->PeriodMax) {
+                    aStatistics->PeriodMax = aStatistics->PeriodDelta;
+                }
+                aStatistics->PeriodDelta = 0;
+                // found and search for next slope
+                if (aStatistics->PeriodCount == 0) {
+                    aStatistics->FirstFoundPosition = aStatistics->Count;
+                    aStatistics->HighCountAtFirstPeriod = aStatistics->HighCount;
+                }
+                aStatistics->IntegrateValueForTotalPeriods = aStatistics->IntegrateValue;
+                aStatistics->SumOfSquaresForTotalPeriods = aStatistics->SumOfSquares;
+                aStatistics->HighCountForTotalPeriods = aStatistics->HighCount;
+                aStatistics->PeriodCount++;
+                aStatistics->LastFoundPosition = aStatistics->Count;
+                aStatistics->TriggerStatus = TRIGGER_START;
+                aStatistics->ActualCompareValue = MeasurementControl.RawTriggerLevelHysteresis;
+            }
+        }
+    }
+
+    /*
+     * 10% to 90% transitions and top and base level
+     */
+    if (aValue < aStatistics->LowLevel) {
+        if (aStatistics->LevelState == STATISTICS_LEVEL_HIGH) {
+            aStatistics->FallSamplesSum += aStatistics->Count - aStatistics->LastHighPosition;
+            aStatistics->FallCount++;
+        }
+        aStatistics->LevelState = STATISTICS_LEVEL_LOW;
+        aStatistics->LastLowPosition = aStatistics->Count;
+        aStatistics->BaseSum += aValue;
+        aStatistics->BaseCount++;
+    } else if (aValue > aStatistics->HighLevel) {
+        if (aStatistics->LevelState == STATISTICS_LEVEL_LOW) {
+            aStatistics->RiseSamplesSum += aStatistics->Count - aStatistics->LastLowPosition;
+            aStatistics->RiseCount++;
+        }
+        aStatistics->LevelState = STATISTICS_LEVEL_HIGH;
+        aStatistics->LastHighPosition = aStatistics->Count;
+        aStatistics->TopSum += aValue;
+        aStatistics->TopCount++;
+    }
+    if (aValue > aStatistics->MiddleLevel) {
+        aStatistics->HighCount++;
+    }
+
+    aStatistics->IntegrateValue += aValue;
+    aStatistics->SumOfSquares += (uint32_t) aValue * aValue;
+    aStatistics->PeriodDelta++;
+    aStatistics->Count++;
+
+    /*
+     * Min and Max
+     */
+    if (aValue > aStatistics->Max) {
+        aStatistics->Max = aValue;
+    }
+    if (aValue < aStatistics->Min) {
+        aStatistics->Min = aValue;
+    }
+}
+
+/**
+ * @param aEndPointer pointer to first value not to add
+ */
+static void addValuesToStatistics(StatisticsStruct * aStatistics, uint16_t * aStartPointer, uint16_t * aEndPointer) {
+    while (aStartPointer < aEndPointer) {
+        addValueToStatistics(aStatistics, *aStartPointer++);
+    }
+}
+
+/*
+ * Peak detect state of ISR. Values are reset at start of each acquisition and by changeTimeBase().
+ */
+static uint16_t sPeakDetectMin;
+static uint16_t sPeakDetectMax;
+static uint16_t sPeakDetectSampleCount;
+static bool sPeakDetectMinIsLast; // to store min and max in the order of their occurrence
+
+static inline void resetPeakDetectWindow(void) {
+    sPeakDetectMin = 0xFFFF;
+    sPeakDetectMax = 0;
+    sPeakDetectSampleCount = MeasurementControl.PeakDetectWindowSampleCount;
+}
+
+/**
+ * Packed storage is only possible for the last acquisition of a triggered ISR mode acquisition
+ * @return true if the last acquisition after stop will store its post trigger values packed
+ */
+bool isPackedLastAcquisitionPossible(void) {
+    return (MeasurementControl.isDeepMemoryMode && !MeasurementControl.isSegmentMode && !MeasurementControl.TimebaseFastDMAMode
+            && !DataBufferControl.DrawWhileAcquire && MeasurementControl.TriggerMode != TRIGGER_MODE_OFF);
+}
+
 /*
  * prepares all variables for new acquisition
  * switches between fast an interrupt mode depending on TIMEBASE_FAST_MODES
@@ -234,8 +464,11 @@ void startAcquisition(void) {
     MeasurementControl.TriggerSampleCount = 0;
     MeasurementControl.TriggerStatus = TRIGGER_START;
     MeasurementControl.doPretriggerCopyForDisplay = false;
+    resetPeakDetectWindow();
+    invalidateMinMaxPyramid();
 
     MeasurementControl.TimebaseFastDMAMode = false;
+    MeasurementControl.RollModeActive = false;
     if (MeasurementControl.TimebaseIndex < TIMEBASE_FAST_MODES) {
         // TimebaseFastFreerunningMode must be set only here at beginning of acquisition
         MeasurementControl.TimebaseFastDMAMode = true;
@@ -245,6 +478,7 @@ void startAcquisition(void) {
         DataBufferControl.NextDrawXValue = 0;
         MeasurementControl.TriggerPhaseJustEnded = false;
         DataBufferControl.DataBufferPreTriggerAreaWrapAround = false;
+        MeasurementControl.RollModeActive = MeasurementControl.isRollMode;
     }
 
     // start and end pointer
@@ -252,6 +486,18 @@ void startAcquisition(void) {
     DataBufferControl.DataBufferDisplayStart = &DataBufferControl.DataBuffer[DATABUFFER_DISPLAY_START];
     DataBufferControl.DataBufferEndPointer = &DataBufferControl.DataBuffer[DATABUFFER_DISPLAY_END];
     DataBufferControl.DataBufferNextInPointer = &DataBufferControl.DataBuffer[0];
+    DataBufferControl.DataBufferSegmentStart = &DataBufferControl.DataBuffer[0];
+    DataBufferControl.SegmentIndex = 0;
+    DataBufferControl.isPacked = false;
+    // DMA mode and trigger off have no pre trigger ring, for ISR mode it is set by setPreTriggerRing()
+    DataBufferControl.PreTriggerRingOffset = 0;
+    DataBufferControl.PreTriggerInvalidCount = 0;
+    sStreamingStatisticsActive = false;
+    // for trigger mode off and DMA mode initialized here, for ISR mode again at trigger
+    initStatistics(&sStreamingStatistics);
+    // for DMA mode and trigger off all values are added at transfer complete, with trigger it is set again at trigger
+    sStreamingStatisticsNextPointer = &DataBufferControl.DataBuffer[0];
+    SegmentInfo[0].TriggerMillis = getMillisSinceBoot();
 
     if (MeasurementControl.TriggerMode == TRIGGER_MODE_OFF) {
         MeasurementControl.TriggerActualPhase = PHASE_POST_TRIGGER;
@@ -259,12 +505,19 @@ void startAcquisition(void) {
         DataBufferControl.DataBufferDisplayStart = &DataBufferControl.DataBuffer[0];
         DataBufferControl.DataBufferEndPointer = &DataBufferControl.DataBuffer[DSO_DISPLAY_WIDTH - 1];
     }
+    if (MeasurementControl.RollModeActive) {
+        // no trigger and the whole data buffer is one ring, so no sample gets lost between screens
+        MeasurementControl.TriggerActualPhase = PHASE_POST_TRIGGER;
+        DataBufferControl.DataBufferDisplayStart = &DataBufferControl.DataBuffer[0];
+        DataBufferControl.DataBufferEndPointer = &DataBufferControl.DataBuffer[DATABUFFER_SIZE - 1];
+        DataBufferControl.DataBufferRollWrapAround = false;
+    }
 
     if (MeasurementControl.isSingleShotMode) {
         // Start and request immediate stop
         MeasurementControl.StopRequested = true;
     }
-    if (MeasurementControl.StopRequested) {
+    if (MeasurementControl.StopRequested && !MeasurementControl.isSegmentMode) {
         // last acquisition or single shot mode -> use whole data buffer
         DataBufferControl.DataBufferEndPointer = &DataBufferControl.DataBuffer[DATABUFFER_SIZE - 1];
     }
@@ -279,6 +532,16 @@ void startAcquisition(void) {
     }
 #endif
 
+    if (MeasurementControl.StopRequested && isPackedLastAcquisitionPossible()) {
+        // last acquisition -> store post trigger values packed to get more samples
+        DataBufferControl.isPacked = true;
+        DataBufferControl.DataBufferEndPointer = DataBufferControl.DataBuffer + (DATABUFFER_PACKED_SIZE - 1);
+    }
+
+    // roll mode has no end of acquisition for the statistics
+    sStreamingStatisticsActive = MeasurementControl.isStreamingStatisticsMode && !MeasurementControl.isSegmentMode
+            && !MeasurementControl.RollModeActive;
+
     MeasurementControl.StopAcknowledged = false;
     DataBufferControl.InputRangeIndexUsed = MeasurementControl.InputRangeIndex;
 
@@ -349,8 +612,74 @@ void readADS7846Channels(void) {
 }
 #endif
 
+/**
+ * Compares 2 packed 16 bit values with 2 packed compare values
+ * @return 0xFFFF for each halfword of aTwoValues which is greater or equal than the corresponding halfword of aTwoCompareValues
+ */
+static inline uint32_t getGreaterOrEqualMaskPacked(uint32_t aTwoValues, uint32_t aTwoCompareValues) {
+#if defined(__ARM_ARCH_7EM__)
+    // Cortex-M4 SIMD - USUB16 sets the 2 GE flags of each halfword if no borrow occurs, SEL converts the flags to a mask
+    // in one asm block, since the compiler does not know about the GE flags between 2 intrinsics
+    uint32_t tResult;
+    __ASM volatile ("usub16 %0, %1, %2\n\tsel %0, %3, %4" : "=&r"(tResult)
+            : "r"(aTwoValues), "r"(aTwoCompareValues), "r"(0xFFFFFFFF), "r"(0) : "cc");
+    return tResult;
+#else
+    // portable version e.g. for host builds
+    uint32_t tMask = 0;
+    if ((aTwoValues & 0xFFFF) >= (aTwoCompareValues & 0xFFFF)) {
+        tMask = 0x0000FFFF;
+    }
+    if ((aTwoValues >> 16) >= (aTwoCompareValues >> 16)) {
+        tMask |= 0xFFFF0000;
+    }
+    return tMask;
+#endif
+}
+
+/**
+ * Checks 2 values at once as long as none of them can change the trigger status.
+ * @param aStartAddress must be 32 bit aligned
+ * @param aCompareValue value of the trigger state machine - status changes if value is greater than it
+ * @param aIdleMask mask of getGreaterOrEqualMaskPacked() for which trigger status does not change - 0 or 0xFFFFFFFF
+ * @return address of the first value of the pair which can change the trigger status
+ *         or address where less than 2 values are left before aEndAddress
+ */
+static inline uint16_t * searchTriggerStatusChangePacked(uint16_t * aStartAddress, uint16_t * aEndAddress,
+        uint16_t aCompareValue, uint32_t aIdleMask) {
+    // value > aCompareValue is equivalent to value >= aCompareValue + 1
+    uint32_t tCompareValue = aCompareValue + 1;
+    if (tCompareValue > 0xFFFF) {
+        // no value can be greater
+        tCompareValue = 0xFFFF;
+    }
+    tCompareValue |= tCompareValue << 16;
+    uint32_t * tPackedAddress = (uint32_t *) aStartAddress;
+    uint32_t * tPackedEndAddress = (uint32_t *) (aStartAddress + ((aEndAddress - aStartAddress) & ~0x01));
+    while (tPackedAddress < tPackedEndAddress) {
+        if (getGreaterOrEqualMaskPacked(*tPackedAddress, tCompareValue) != aIdleMask) {
+            break;
+        }
+        tPackedAddress++;
+    }
+    return (uint16_t *) tPackedAddress;
+}
+
+/**
+ * Adds the samples checked by the trigger search of DMACheckForTriggerCondition() to the benchmark sample count.
+ * Clamped, since an unsigned count must not be decremented if the search ended before its start address.
+ */
+static inline void countTriggerSearchSamples(uint16_t * aSearchEndAddress) {
+    int tCheckedSamples = aSearchEndAddress - &DataBufferControl.DataBuffer[DATABUFFER_PRE_TRIGGER_SIZE];
+    if (tCheckedSamples > 0) {
+        AcquisitionInfo.ISRSampleCount += tCheckedSamples;
+    }
+}
+
 /*
  * called by half transfer interrupt
+ * Values are checked pairwise by searchTriggerStatusChangePacked() and only the candidates
+ * for a trigger status change are checked by the trigger state machine.
  */
 void DMACheckForTriggerCondition(void) {
     if (MeasurementControl.TriggerMode != TRIGGER_MODE_OFF) {
@@ -359,15 +688,28 @@ void DMACheckForTriggerCondition(void) {
         uint8_t tTriggerStatus = TRIGGER_START;
         bool tFalling = !MeasurementControl.TriggerSlopeRising;
         uint16_t tActualCompareValue = MeasurementControl.RawTriggerLevelHysteresis;
+        // rising slope - all values above 1. threshold do not change status, falling slope - all values below
+        uint32_t tIdleMask = 0xFFFFFFFF;
+        if (tFalling) {
+            tIdleMask = 0;
+        }
         // start after pre trigger values
         uint16_t * tDMAMemoryAddress = &DataBufferControl.DataBuffer[DATABUFFER_PRE_TRIGGER_SIZE];
         uint16_t * tEndMemoryAddress = &DataBufferControl.DataBuffer[DATABUFFER_SIZE / 2];
         do {
             clearSystic();
-            while (tDMAMemoryAddress < tEndMemoryAddress) { // 37 instructions at -o0 if nothing found
+            while (tDMAMemoryAddress < tEndMemoryAddress) {
                 /*
                  * scan from end of pre trigger to half of buffer for trigger condition
                  */
+                if (((uint32_t) tDMAMemoryAddress & 0x02) == 0) {
+                    // aligned -> skip all pairs of values which cannot change trigger status
+                    tDMAMemoryAddress = searchTriggerStatusChangePacked(tDMAMemoryAddress, tEndMemoryAddress, tActualCompareValue,
+                            tIdleMask);
+                    if (tDMAMemoryAddress >= tEndMemoryAddress) {
+                        break;
+                    }
+                }
                 tValue = *tDMAMemoryAddress++;
                 bool tValueGreaterRef = (tValue > tActualCompareValue);
                 tValueGreaterRef = tValueGreaterRef ^ tFalling; // change value if tFalling == true
@@ -377,6 +719,7 @@ void DMACheckForTriggerCondition(void) {
                     if (!tValueGreaterRef) {
                         tTriggerStatus = TRIGGER_BEFORE_THRESHOLD;
                         tActualCompareValue = MeasurementControl.RawTriggerLevel;
+                        tIdleMask = ~tIdleMask;
                     }
                 } else {
                     // rising slope - wait for value to rise above 2. threshold
@@ -418,6 +761,7 @@ void DMACheckForTriggerCondition(void) {
                     MeasurementControl.doPretriggerCopyForDisplay = false;
                 }
 
+                countTriggerSearchSamples(tDMAMemoryAddress);
                 // restart DMA, leave ISR and wait for new interrupt
                 ADC_DMA_start((uint32_t) &DataBufferControl.DataBuffer[0], DATABUFFER_SIZE);
                 // reset transfer complete status before return since this interrupt may happened and must be re enabled
@@ -426,7 +770,8 @@ void DMACheckForTriggerCondition(void) {
                 return;
             } else {
                 // set new tEndMemoryAddress and check if it is before last possible trigger position
-                // appr. 77063 cycles / 1 ms until we get here first time (1440 values checked 53 cycles/value at -o0)
+                // appr. 77063 cycles / 1 ms until we got here first time with the scalar check (1440 values checked 53 cycles/value at -o0)
+                // see cycles per sample of acquisition benchmark for actual values
                 uint32_t tCount = DSO_DMA_CHANNEL ->CNDTR;
                 if (tCount < DSO_DISPLAY_WIDTH - DisplayControl.DatabufferPreTriggerDisplaySize) {
                     tCount = DSO_DISPLAY_WIDTH - DisplayControl.DatabufferPreTriggerDisplaySize;
@@ -434,6 +779,7 @@ void DMACheckForTriggerCondition(void) {
                 tEndMemoryAddress = &DataBufferControl.DataBuffer[DATABUFFER_SIZE - tCount - 1];
             }
         } while (true); // end with break above
+        countTriggerSearchSamples(tDMAMemoryAddress);
 
         /*
          * set pointer for display of data
@@ -454,6 +800,18 @@ void DMACheckForTriggerCondition(void) {
                     DisplayControl.XScale);
             DataBufferControl.DataBufferEndPointer = tDMAMemoryAddress + tAdjust;
         }
+        if (sStreamingStatisticsActive) {
+            // add all values already transferred, the rest is added at transfer complete
+            uint16_t * tStatisticsEndPointer = &DataBufferControl.DataBuffer[DATABUFFER_SIZE - DSO_DMA_CHANNEL ->CNDTR];
+            if (tStatisticsEndPointer > DataBufferControl.DataBufferEndPointer + 1) {
+                tStatisticsEndPointer = (uint16_t *) DataBufferControl.DataBufferEndPointer + 1;
+            }
+            uint16_t * tStatisticsStartPointer = DataBufferControl.DataBufferDisplayStart
+                    + adjustIntWithScaleFactor(DisplayControl.DatabufferPreTriggerDisplaySize, DisplayControl.XScale);
+            initStatistics(&sStreamingStatistics);
+            addValuesToStatistics(&sStreamingStatistics, tStatisticsStartPointer, tStatisticsEndPointer);
+            sStreamingStatisticsNextPointer = tStatisticsEndPointer;
+        }
     }
 }
 
@@ -463,6 +821,10 @@ extern "C" void DMA1_Channel1_IRQHandler(void) {
     if (DMA_GetITStatus(DMA1_IT_TC1 )) {
         /* Clear DMA  Transfer Complete interrupt pending bit */
         DMA_ClearITPendingBit(DMA1_IT_TC1 );
+        if (sStreamingStatisticsActive) {
+            addValuesToStatistics(&sStreamingStatistics, sStreamingStatisticsNextPointer,
+                    (uint16_t *) DataBufferControl.DataBufferEndPointer + 1);
+        }
         DataBufferControl.DataBufferFull = true;
         ADC_StopConversion(DSO_ADC_ID );
     }
@@ -474,27 +836,197 @@ extern "C" void DMA1_Channel1_IRQHandler(void) {
     // Test on DMA Transfer Half interrupt
     if (DMA_GetITStatus(DMA1_IT_HT1 )) {
         DMA_ClearITPendingBit(DMA1_IT_HT1 );
-        DMACheckForTriggerCondition();
+        if (AcquisitionInfo.isBenchmarkActive) {
+            uint32_t tStartCycles = DWT->CYCCNT;
+            DMACheckForTriggerCondition();
+            AcquisitionInfo.ISRCycles += DWT->CYCCNT - tStartCycles;
+        } else {
+            DMACheckForTriggerCondition();
+        }
+    }
+}
+
+/*
+ * Packed deep memory
+ * 2 post trigger values are stored in 3 bytes starting at DataBuffer[DATABUFFER_PRE_TRIGGER_SIZE]
+ * byte 0: bits 0-7 of even value, byte 1: bits 8-11 of even value + bits 0-3 of odd value, byte 2: bits 4-11 of odd value
+ */
+static inline uint8_t * getPackedBytePointer(int aPostTriggerIndex) {
+    return ((uint8_t *) &DataBufferControl.DataBuffer[DATABUFFER_PRE_TRIGGER_SIZE]) + ((aPostTriggerIndex >> 1) * 3);
+}
+
+/**
+ * app. 10 cycles more than storing of unpacked value
+ * @param aDataBufferPointer virtual pointer of value
+ */
+static inline void storePackedValue(uint16_t * aDataBufferPointer, uint16_t aValue) {
+    int tIndex = aDataBufferPointer - &DataBufferControl.DataBuffer[DATABUFFER_PRE_TRIGGER_SIZE];
+    uint8_t * tBytePointer = getPackedBytePointer(tIndex);
+    if ((tIndex & 0x01) == 0) {
+        tBytePointer[0] = aValue;
+        tBytePointer[1] = aValue >> 8; // high nibble is set by the odd value
+    } else {
+        tBytePointer[1] |= aValue << 4;
+        tBytePointer[2] = aValue >> 4;
     }
 }
 
 /**
- * Interrupt service routine for adc interrupt
+ * @param aDataBufferPointer pointer to value in DataBuffer - virtual if DataBufferControl.isPacked
+ * @return raw value or DATABUFFER_INVISIBLE_RAW_VALUE if packed and behind end of acquisition
+ *         or if in the never written part of the pre trigger area.
+ *         Values in the pre trigger area are read through the ring described by PreTriggerRingOffset.
+ */
+uint16_t getDataBufferValue(uint16_t * aDataBufferPointer) {
+    int tIndex = aDataBufferPointer - &DataBufferControl.DataBuffer[DATABUFFER_PRE_TRIGGER_SIZE];
+    if (tIndex < 0) {
+        tIndex += DATABUFFER_PRE_TRIGGER_SIZE;
+        if (tIndex < DataBufferControl.PreTriggerInvalidCount) {
+            return DATABUFFER_INVISIBLE_RAW_VALUE;
+        }
+        tIndex += DataBufferControl.PreTriggerRingOffset;
+        if (tIndex >= DATABUFFER_PRE_TRIGGER_SIZE) {
+            tIndex -= DATABUFFER_PRE_TRIGGER_SIZE;
+        }
+        return DataBufferControl.DataBuffer[tIndex];
+    }
+    if (!DataBufferControl.isPacked) {
+        return *aDataBufferPointer;
+    }
+    if (aDataBufferPointer > DataBufferControl.DataBufferEndPointer) {
+        return DATABUFFER_INVISIBLE_RAW_VALUE;
+    }
+    uint8_t * tBytePointer = getPackedBytePointer(tIndex);
+    if ((tIndex & 0x01) == 0) {
+        return tBytePointer[0] | ((tBytePointer[1] & 0x0F) << 8);
+    }
+    return (tBytePointer[1] >> 4) | (tBytePointer[2] << 4);
+}
+
+/**
+ * Copies aCount values in linear time order to aBuffer.
+ * The pre trigger part is copied with (at most) 2 memcpy from the ring, the post trigger part with memcpy or unpacked.
+ */
+static void copyLinearDataBuffer(uint16_t * aDataBufferPointer, uint16_t * aBuffer, int aCount) {
+    int tIndex = aDataBufferPointer - &DataBufferControl.DataBuffer[0];
+    if (tIndex < DATABUFFER_PRE_TRIGGER_SIZE) {
+        int tPreTriggerCount = DATABUFFER_PRE_TRIGGER_SIZE - tIndex;
+        if (tPreTriggerCount > aCount) {
+            tPreTriggerCount = aCount;
+        }
+        aCount -= tPreTriggerCount;
+        aDataBufferPointer += tPreTriggerCount;
+        // never written values
+        while (tPreTriggerCount > 0 && tIndex < DataBufferControl.PreTriggerInvalidCount) {
+            *aBuffer++ = DATABUFFER_INVISIBLE_RAW_VALUE;
+            tIndex++;
+            tPreTriggerCount--;
+        }
+        tIndex += DataBufferControl.PreTriggerRingOffset;
+        if (tIndex >= DATABUFFER_PRE_TRIGGER_SIZE) {
+            tIndex -= DATABUFFER_PRE_TRIGGER_SIZE;
+        }
+        // part up to end of ring
+        int tCount = DATABUFFER_PRE_TRIGGER_SIZE - tIndex;
+        if (tCount > tPreTriggerCount) {
+            tCount = tPreTriggerCount;
+        }
+        memcpy(aBuffer, &DataBufferControl.DataBuffer[tIndex], tCount * sizeof(*aBuffer));
+        aBuffer += tCount;
+        // wrapped part from start of ring
+        tCount = tPreTriggerCount - tCount;
+        memcpy(aBuffer, &DataBufferControl.DataBuffer[0], tCount * sizeof(*aBuffer));
+        aBuffer += tCount;
+    }
+    if (DataBufferControl.isPacked) {
+        for (int i = 0; i < aCount; ++i) {
+            *aBuffer++ = getDataBufferValue(aDataBufferPointer++);
+        }
+    } else {
+        memcpy(aBuffer, aDataBufferPointer, aCount * sizeof(*aBuffer));
+    }
+}
+
+/**
+ * Lazy decoding of packed data and of a not yet linearized pre trigger ring
+ * @return aDataBufferPointer or aBuffer filled with aCount linear values starting at aDataBufferPointer
+ */
+uint16_t * getLinearDataBufferPointer(uint16_t * aDataBufferPointer, uint16_t * aBuffer, int aCount) {
+    bool tPreTriggerIsLinear = (DataBufferControl.PreTriggerRingOffset == 0 && DataBufferControl.PreTriggerInvalidCount == 0)
+            || aDataBufferPointer >= &DataBufferControl.DataBuffer[DATABUFFER_PRE_TRIGGER_SIZE];
+    if (tPreTriggerIsLinear
+            && (!DataBufferControl.isPacked
+                    || aDataBufferPointer + aCount <= &DataBufferControl.DataBuffer[DATABUFFER_PRE_TRIGGER_SIZE])) {
+        return aDataBufferPointer;
+    }
+    copyLinearDataBuffer(aDataBufferPointer, aBuffer, aCount);
+    return aBuffer;
+}
+
+/**
+ * @return pointer to data for drawDataBuffer() starting at DataBufferDisplayStart - unpacked to FourDisplayLinesBuffer if packed
+ * and filtered to FilterViewBuffer if filter is active
+ */
+uint16_t * getDataBufferDisplayPointer(void) {
+    int tCount = adjustIntWithScaleFactor(DSO_DISPLAY_WIDTH, DisplayControl.XScale);
+    int tLinearCount = tCount;
+    if (tLinearCount > SIZEOF_DISPLAYLINE_BUFFER) {
+        tLinearCount = SIZEOF_DISPLAYLINE_BUFFER;
+    }
+    return getFilteredDataBufferPointer(
+            getLinearDataBufferPointer(DataBufferControl.DataBufferDisplayStart, FourDisplayLinesBuffer, tLinearCount), tCount);
+}
+
+/*
+ * Segment mode
+ */
+SegmentInfoStruct SegmentInfo[DATABUFFER_NUMBER_OF_SEGMENTS];
+
+static inline void saveSegmentInfo(void) {
+    SegmentInfoStruct * tSegmentInfoPointer = &SegmentInfo[DataBufferControl.SegmentIndex];
+    tSegmentInfoPointer->PreTriggerNextPointer = DataBufferControl.DataBufferPreTriggerNextPointer;
+    tSegmentInfoPointer->TriggerStatus = MeasurementControl.TriggerStatus;
+}
+
+/**
+ * Saves info of the segment just filled and prepares the ISR for filling the next segment.
+ * Only the variables set by startAcquisition() for the ISR mode are reset here, so re-arm costs only a few cycles.
+ * @param aValue the first value of the new segment
+ */
+static inline void startNextSegment(uint16_t aValue) {
+    saveSegmentInfo();
+    uint16_t * tSegmentStart = DataBufferControl.DataBufferSegmentStart + DATABUFFER_SEGMENT_SIZE;
+    // keep the distance of end pointer since it depends on trigger mode
+    DataBufferControl.DataBufferEndPointer = tSegmentStart
+            + (DataBufferControl.DataBufferEndPointer - DataBufferControl.DataBufferSegmentStart);
+    DataBufferControl.DataBufferSegmentStart = tSegmentStart;
+    DataBufferControl.SegmentIndex++;
+    SegmentInfo[DataBufferControl.SegmentIndex].TriggerMillis = getMillisSinceBoot();
+
+    MeasurementControl.TriggerStatus = TRIGGER_START;
+    if (MeasurementControl.TriggerMode != TRIGGER_MODE_OFF) {
+        MeasurementControl.TriggerActualPhase = PHASE_PRE_TRIGGER;
+    }
+    // store value
+    *tSegmentStart++ = aValue;
+    MeasurementControl.TriggerSampleCount = 1;
+    DataBufferControl.DataBufferNextInPointer = tSegmentStart;
+}
+
+/**
+ * Processing of one sample for interrupt mode
  * app. 3.5 microseconds when compiled with no optimizations.
  * With optimizations it works up to 50us/div
  * first value which meets trigger condition is stored at position DataBufferControl.DataBuffer[DATABUFFER_PRE_TRIGGER_SIZE]
  */
-
-extern "C" void ADC1_2_IRQHandler(void) {
-
-    uint16_t tValue = DSO_ADC_ID ->DR;
+static inline void processADCValue(uint16_t aValue) {
 
     /*
      * read at least DATABUFFER_PRE_TRIGGER_SIZE values in pre trigger phase
      */
     if (MeasurementControl.TriggerActualPhase == PHASE_PRE_TRIGGER) {
         // store value
-        *DataBufferControl.DataBufferNextInPointer++ = tValue;
+        *DataBufferControl.DataBufferNextInPointer++ = aValue;
         MeasurementControl.TriggerSampleCount++;
         if (MeasurementControl.TriggerSampleCount >= DATABUFFER_PRE_TRIGGER_SIZE) {
             // now we have read at least DATABUFFER_PRE_TRIGGER_SIZE values => start search for trigger
@@ -505,7 +1037,7 @@ extern "C" void ADC1_2_IRQHandler(void) {
                 MeasurementControl.TriggerActualPhase = PHASE_SEARCH_TRIGGER;
             }
             MeasurementControl.TriggerSampleCount = 0;
-            DataBufferControl.DataBufferNextInPointer = &DataBufferControl.DataBuffer[0];
+            DataBufferControl.DataBufferNextInPointer = DataBufferControl.DataBufferSegmentStart;
         }
         return;
     }
@@ -519,12 +1051,12 @@ extern "C" void ADC1_2_IRQHandler(void) {
         if (MeasurementControl.TriggerSlopeRising) {
             if (tTriggerStatus == TRIGGER_START) {
                 // rising slope - wait for value below 1. threshold
-                if (tValue < MeasurementControl.RawTriggerLevelHysteresis) {
+                if (aValue < MeasurementControl.RawTriggerLevelHysteresis) {
                     MeasurementControl.TriggerStatus = TRIGGER_BEFORE_THRESHOLD;
                 }
             } else {
                 // rising slope - wait for value to rise above 2. threshold
-                if (tValue > MeasurementControl.RawTriggerLevel) {
+                if (aValue > MeasurementControl.RawTriggerLevel) {
                     // start reading into buffer
                     tTriggerFound = true;
                     MeasurementControl.TriggerStatus = TRIGGER_OK;
@@ -533,12 +1065,12 @@ extern "C" void ADC1_2_IRQHandler(void) {
         } else {
             if (tTriggerStatus == TRIGGER_START) {
                 // falling slope - wait for value above 1. threshold
-                if (tValue > MeasurementControl.RawTriggerLevelHysteresis) {
+                if (aValue > MeasurementControl.RawTriggerLevelHysteresis) {
                     MeasurementControl.TriggerStatus = TRIGGER_BEFORE_THRESHOLD;
                 }
             } else {
                 // falling slope - wait for value to go below 2. threshold
-                if (tValue < MeasurementControl.RawTriggerLevel) {
+                if (aValue < MeasurementControl.RawTriggerLevel) {
                     // start reading into buffer
                     tTriggerFound = true;
                     MeasurementControl.TriggerStatus = TRIGGER_OK;
@@ -552,20 +1084,20 @@ extern "C" void ADC1_2_IRQHandler(void) {
              * store value - check for wrap around in pre trigger area
              */
             // store value
-            *tDataBufferPointer++ = tValue;
+            *tDataBufferPointer++ = aValue;
             MeasurementControl.TriggerSampleCount++;
             // detect end of pre trigger buffer
-            if (tDataBufferPointer >= &DataBufferControl.DataBuffer[DATABUFFER_PRE_TRIGGER_SIZE]) {
+            if (tDataBufferPointer >= DataBufferControl.DataBufferSegmentStart + DATABUFFER_PRE_TRIGGER_SIZE) {
                 // wrap around - for draw while acquire
                 DataBufferControl.DataBufferPreTriggerAreaWrapAround = true;
-                tDataBufferPointer = &DataBufferControl.DataBuffer[0];
+                tDataBufferPointer = DataBufferControl.DataBufferSegmentStart;
             }
             // prepare for next
             DataBufferControl.DataBufferNextInPointer = tDataBufferPointer;
 
             if (MeasurementControl.isSingleShotMode) {
                 // No timeout in single shot mode
-                MeasurementControl.RawValueBeforeTrigger = tValue;
+                MeasurementControl.RawValueBeforeTrigger = aValue;
                 return;
             }
             /*
@@ -586,10 +1118,21 @@ extern "C" void ADC1_2_IRQHandler(void) {
          * set flag for main loop to detect end of trigger phase
          */
         MeasurementControl.TriggerPhaseJustEnded = true;
-        tDataBufferPointer = &DataBufferControl.DataBuffer[DATABUFFER_PRE_TRIGGER_SIZE];
+        if (MeasurementControl.isSegmentMode) {
+            SegmentInfo[DataBufferControl.SegmentIndex].TriggerMillis = getMillisSinceBoot();
+        }
+        tDataBufferPointer = DataBufferControl.DataBufferSegmentStart + DATABUFFER_PRE_TRIGGER_SIZE;
         // store value
-        *tDataBufferPointer++ = tValue;
-        DataBufferControl.DataBufferNextInPointer = tDataBufferPointer;
+        if (DataBufferControl.isPacked) {
+            storePackedValue(tDataBufferPointer, aValue);
+        } else {
+            *tDataBufferPointer = aValue;
+        }
+        DataBufferControl.DataBufferNextInPointer = tDataBufferPointer + 1;
+        if (sStreamingStatisticsActive) {
+            initStatistics(&sStreamingStatistics);
+            addValueToStatistics(&sStreamingStatistics, aValue);
+        }
         return;
     }
 
@@ -599,10 +1142,29 @@ extern "C" void ADC1_2_IRQHandler(void) {
     uint16_t * tDataBufferPointer = DataBufferControl.DataBufferNextInPointer;
     if (tDataBufferPointer <= DataBufferControl.DataBufferEndPointer) {
         // store display value
-        *tDataBufferPointer++ = tValue;
+        if (DataBufferControl.isPacked) {
+            storePackedValue(tDataBufferPointer, aValue);
+        } else {
+            *tDataBufferPointer = aValue;
+        }
+        tDataBufferPointer++;
         // prepare for next
         DataBufferControl.DataBufferNextInPointer = tDataBufferPointer;
+        if (sStreamingStatisticsActive) {
+            addValueToStatistics(&sStreamingStatistics, aValue);
+        }
+    } else if (MeasurementControl.isSegmentMode && DataBufferControl.SegmentIndex < DATABUFFER_NUMBER_OF_SEGMENTS - 1) {
+        // re-arm for next segment without stopping the ADC
+        startNextSegment(aValue);
+    } else if (MeasurementControl.RollModeActive && !MeasurementControl.StopRequested) {
+        // roll mode - continue at start of buffer, main loop reads it as ring
+        DataBufferControl.DataBuffer[0] = aValue;
+        DataBufferControl.DataBufferNextInPointer = &DataBufferControl.DataBuffer[1];
+        DataBufferControl.DataBufferRollWrapAround = true;
     } else {
+        if (MeasurementControl.isSegmentMode) {
+            saveSegmentInfo();
+        }
         // stop acquisition
         // End of conversion => stop ADC in order to make it reconfigurable (change timebase)
         ADC_StopConversion(DSO_ADC_ID );
@@ -614,6 +1176,54 @@ extern "C" void ADC1_2_IRQHandler(void) {
         DataBufferControl.DataBufferFull = true;
     }
 }
+
+/**
+ * Processing of one internal sample in peak detect mode.
+ * Reduces PeakDetectWindowSampleCount samples to one min/max pair, which is then processed like 2 normal samples.
+ * So the pair covers the same time as 2 samples without peak detect and timing, trigger timeout and buffer size are unchanged.
+ */
+static inline void processPeakDetectValue(void) {
+    uint16_t tValue = DSO_ADC_ID ->DR;
+    if (tValue < sPeakDetectMin) {
+        sPeakDetectMin = tValue;
+        sPeakDetectMinIsLast = true;
+    }
+    if (tValue > sPeakDetectMax) {
+        sPeakDetectMax = tValue;
+        sPeakDetectMinIsLast = false;
+    }
+    sPeakDetectSampleCount--;
+    if (sPeakDetectSampleCount == 0) {
+        if (sPeakDetectMinIsLast) {
+            processADCValue(sPeakDetectMax);
+            processADCValue(sPeakDetectMin);
+        } else {
+            processADCValue(sPeakDetectMin);
+            processADCValue(sPeakDetectMax);
+        }
+        resetPeakDetectWindow();
+    }
+}
+
+/**
+ * Interrupt service routine for adc interrupt
+ * Measures the cycles needed for processing of each sample only while the acquisition benchmark is running.
+ */
+extern "C" void ADC1_2_IRQHandler(void) {
+    uint32_t tStartCycles = 0;
+    if (AcquisitionInfo.isBenchmarkActive) {
+        tStartCycles = DWT->CYCCNT;
+    }
+    if (MeasurementControl.PeakDetectActive) {
+        processPeakDetectValue();
+    } else {
+        processADCValue(DSO_ADC_ID ->DR);
+    }
+    if (AcquisitionInfo.isBenchmarkActive) {
+        AcquisitionInfo.ISRCycles += DWT->CYCCNT - tStartCycles;
+        AcquisitionInfo.ISRSampleCount++;
+    }
+}
 /**
  * set attenuator to infinite and AC Pin active, read n samples and store it in MeasurementControl.DSOReadingACZero
  */
@@ -630,135 +1240,163 @@ void autoACZeroCalibration(void) {
         if (tVal > ADC_MAX_CONVERSION_VALUE) {
             // conversion impossible -> set fallback value
             MeasurementControl.RawDSOReadingACZero = ADC_MAX_CONVERSION_VALUE / 2;
+            initRawToDisplayTable();
             return;
         }
         tSum += ADC1_getChannelValue(ADCInputMUXChannels[START_ADC_CHANNEL_INDEX]);
     }
     MeasurementControl.RawDSOReadingACZero = tSum >> 4;
     DSO_setACMode(tState);
+    initRawToDisplayTable();
 }
 /**
- * Get period and frequency and average for display
- * Get max and min for display and automatic triggering.
- *
- * Use only post trigger area!
+ * Computes min, max, average, period / frequency, RMS, duty cycle, rise and fall time and overshoot from the statistic values
  */
-void computeMinMaxAverageAndPeriodFrequency(void) {
-    uint16_t * tDataBufferPointer = DataBufferControl.DataBufferDisplayStart
-            + adjustIntWithScaleFactor(DisplayControl.DatabufferPreTriggerDisplaySize, DisplayControl.XScale);
-    if (DataBufferControl.DataBufferEndPointer > tDataBufferPointer) {
-        uint16_t tAcquisitionSize = DataBufferControl.DataBufferEndPointer + 1 - tDataBufferPointer;
-        uint16_t tMax, tMin;
-        tMax = *tDataBufferPointer;
-        tMin = *tDataBufferPointer;
-        uint16_t tValue;
-        uint32_t tIntegrateValue = 0;
-        uint32_t tIntegrateValueForTotalPeriods = 0;
-        int tCount = 0;
-        int tLastFoundPosition = 0;
-        int tPeriodDelta = 0;
-        int tPeriodMin = 1024;
-        int tPeriodMax = 0;
-        int tTriggerStatus = TRIGGER_START;
-        bool tFalling = !MeasurementControl.TriggerSlopeRising;
-        uint16_t tActualCompareValue = MeasurementControl.RawTriggerLevelHysteresis;
-        bool tReliableValue = true;
+static void computeStatisticsResults(StatisticsStruct * aStatistics) {
+    uint16_t tAcquisitionSize = aStatistics->Count;
+    if (tAcquisitionSize == 0) {
+        return;
+    }
+    MeasurementControl.RawValueMin = aStatistics->Min;
+    MeasurementControl.RawValueMax = aStatistics->Max;
 
-        for (int i = 0; i < tAcquisitionSize; ++i) {
-            tValue = *tDataBufferPointer++;
-            /*
-             * trigger condition and average taken only from entire periods
-             */ //
-            bool tValueGreaterRef = (tValue > tActualCompareValue);
-            tValueGreaterRef = tValueGreaterRef ^ tFalling; // change value if tFalling == true
+    int tCount = aStatistics->PeriodCount;
+    int tLastFoundPosition = aStatistics->LastFoundPosition;
+    bool tReliableValue = aStatistics->ReliableValue;
+    /*
+     * check for plausi of period values
+     * allow delta of periods to be at least 1/8 period + 3
+     */
+    int tPeriodDelta = aStatistics->PeriodMax - aStatistics->PeriodMin;
+    if (tCount != 0 && ((tLastFoundPosition / (8 * tCount)) + 3) < tPeriodDelta) {
+        tReliableValue = false;
+    }
 
-            if (tTriggerStatus == TRIGGER_START) {
-                // rising slope - wait for value below 1. threshold
-                // falling slope - wait for value above 1. threshold
-                if (!tValueGreaterRef) {
-                    tTriggerStatus = TRIGGER_BEFORE_THRESHOLD;
-                    tActualCompareValue = MeasurementControl.RawTriggerLevel;
-                }
-            } else {
-                // rising slope - wait for value to rise above 2. threshold
-                // falling slope - wait for value to go below 2. threshold
-                if (tValueGreaterRef) {
-                    if ((tPeriodDelta) < MIN_SAMPLES_PER_PERIOD_FOR_RELIABLE_FREQUENCY_VALUE) {
-                        // found new trigger in less than MIN_SAMPLES_PER_PERIOD_FOR_RELIABLE_FREQUENCY_VALUE samples => no reliable value
-                        tReliableValue = false;
-                    } else {
-                        if (tPeriodDelta < tPeriodMin) {
-                            tPeriodMin = tPeriodDelta;
-                        } else if (tPeriodDelta > tPeriodMax) {
-                            tPeriodMax = tPeriodDelta;
-                        }
-                        tPeriodDelta = 0;
-                        // found and search for next slope
-                        tIntegrateValueForTotalPeriods = tIntegrateValue;
-                        tCount++;
-                        tLastFoundPosition = i;
-                        tTriggerStatus = TRIGGER_START;
-                        tActualCompareValue = MeasurementControl.RawTriggerLevelHysteresis;
-                    }
-                }
+    /*
+     * compute period and frequency
+     */
+    float tPeriodMicros = 0.0;
+    float tHertz = 0.0;
+    if (tLastFoundPosition != 0 && tCount != 0 && tReliableValue) {
+        MeasurementControl.RawValueAverage = (aStatistics->IntegrateValueForTotalPeriods + (tLastFoundPosition / 2))
+                / tLastFoundPosition;
+
+        // compute microseconds per period
+        tPeriodMicros = tLastFoundPosition;
+        if (MeasurementControl.TimebaseIndex < TIMEBASE_NUMBER_OF_EXCACT_ENTRIES) {
+            // use exact value where needed
+            tPeriodMicros = tPeriodMicros * TimebaseExactDivValuesMicros[MeasurementControl.TimebaseIndex];
+            if (MeasurementControl.TimebaseIndex < TIMEBASE_NUMBER_OF_XSCALE_CORRECTION) {
+                tPeriodMicros *= xScaleForTimebase[MeasurementControl.TimebaseIndex];
             }
-            tIntegrateValue += tValue;
-            tPeriodDelta++;
+        } else {
+            tPeriodMicros = tPeriodMicros * TimebaseDivValues[MeasurementControl.TimebaseIndex];
+        }
+        tPeriodMicros = tPeriodMicros / (tCount * TIMING_GRID_WIDTH);
+        // nanos are handled by TimebaseExactDivValues < 1
+        if (MeasurementControl.TimebaseIndex >= TIMEBASE_INDEX_MILLIS) {
+            tPeriodMicros = tPeriodMicros * 1000;
+        }
+        // frequency
+        tHertz = 1000000.0 / tPeriodMicros;
+    } else {
+        MeasurementControl.RawValueAverage = (aStatistics->IntegrateValue + (tAcquisitionSize / 2)) / tAcquisitionSize;
+    }
+    MeasurementControl.FrequencyHertz = tHertz  + 0.5;
+    MeasurementControl.PeriodMicros = tPeriodMicros  + 0.5;
 
-            /*
-             * Min and Max
-             */
-            if (tValue > tMax) {
-                tMax = tValue;
-            } else if (tValue < tMin) {
-                tMin = tValue;
-            }
+    /*
+     * RMS - of entire periods like average
+     */
+    int tRMSCount = tAcquisitionSize;
+    uint64_t tSumOfSquares = aStatistics->SumOfSquares;
+    uint32_t tSum = aStatistics->IntegrateValue;
+    if (tLastFoundPosition != 0 && tCount != 0 && tReliableValue) {
+        tRMSCount = tLastFoundPosition;
+        tSumOfSquares = aStatistics->SumOfSquaresForTotalPeriods;
+        tSum = aStatistics->IntegrateValueForTotalPeriods;
+    }
+    float tMeanOfSquares = (float) tSumOfSquares / tRMSCount;
+    int tZeroValue = 0;
+    if (MeasurementControl.isACMode) {
+        // RMS of (value - zero) = sqrt(mean of squares - 2 * zero * mean + zero^2)
+        tZeroValue = MeasurementControl.RawDSOReadingACZero;
+        tMeanOfSquares += (float) tZeroValue * ((float) tZeroValue - ((2.0 * tSum) / tRMSCount));
+        if (tMeanOfSquares < 0) {
+            tMeanOfSquares = 0;
         }
+    }
+    MeasurementControl.RawValueRMS = sqrtf(tMeanOfSquares) + tZeroValue + 0.5;
 
-        MeasurementControl.RawValueMin = tMin;
-        MeasurementControl.RawValueMax = tMax;
+    /*
+     * duty cycle - of entire periods
+     */
+    MeasurementControl.DutyCyclePercent = 0;
+    if (tCount >= 2 && tReliableValue) {
+        MeasurementControl.DutyCyclePercent = ((aStatistics->HighCountForTotalPeriods - aStatistics->HighCountAtFirstPeriod)
+                * 100 + 50) / (tLastFoundPosition - aStatistics->FirstFoundPosition);
+    }
 
-        /*
-         * check for plausi of period values
-         * allow delta of periods to be at least 1/8 period + 3
-         */
-        tPeriodDelta = tPeriodMax - tPeriodMin;
-        if (((tLastFoundPosition / (8 * tCount)) + 3) < tPeriodDelta) {
-            tReliableValue = false;
-        }
+    /*
+     * rise and fall time
+     */
+    float tMicrosPerSample = getTimebaseExactValueMicros(MeasurementControl.TimebaseIndex) / TIMING_GRID_WIDTH;
+    MeasurementControl.RiseMicros = 0.0;
+    MeasurementControl.FallMicros = 0.0;
+    if (aStatistics->RiseCount != 0) {
+        MeasurementControl.RiseMicros = (aStatistics->RiseSamplesSum * tMicrosPerSample) / aStatistics->RiseCount;
+    }
+    if (aStatistics->FallCount != 0) {
+        MeasurementControl.FallMicros = (aStatistics->FallSamplesSum * tMicrosPerSample) / aStatistics->FallCount;
+    }
+    MeasurementControl.PulseCount = aStatistics->RiseCount;
 
-        /*
-         * compute period and frequency
-         */
-        float tPeriodMicros = 0.0;
-        float tHertz = 0.0;
-        if (tLastFoundPosition != 0 && tCount != 0 && tReliableValue) {
-            MeasurementControl.RawValueAverage = (tIntegrateValueForTotalPeriods + (tLastFoundPosition / 2)) / tLastFoundPosition;
-
-            // compute microseconds per period
-            tPeriodMicros = tLastFoundPosition;
-            if (MeasurementControl.TimebaseIndex < TIMEBASE_NUMBER_OF_EXCACT_ENTRIES) {
-                // use exact value where needed
-                tPeriodMicros = tPeriodMicros * TimebaseExactDivValuesMicros[MeasurementControl.TimebaseIndex];
-                if (MeasurementControl.TimebaseIndex < TIMEBASE_NUMBER_OF_XSCALE_CORRECTION) {
-                    tPeriodMicros *= xScaleForTimebase[MeasurementControl.TimebaseIndex];
-                }
-            } else {
-                tPeriodMicros = tPeriodMicros * TimebaseDivValues[MeasurementControl.TimebaseIndex];
+    /*
+     * overshoot of max above top level relative to top - base amplitude
+     */
+    MeasurementControl.OvershootPercent = 0;
+    if (aStatistics->TopCount != 0 && aStatistics->BaseCount != 0) {
+        int tTop = aStatistics->TopSum / aStatistics->TopCount;
+        int tAmplitude = tTop - (int) (aStatistics->BaseSum / aStatistics->BaseCount);
+        if (tAmplitude > 0) {
+            int tOvershootPercent = ((aStatistics->Max - tTop) * 100) / tAmplitude;
+            if (tOvershootPercent > 0xFF) {
+                tOvershootPercent = 0xFF;
             }
-            tPeriodMicros = tPeriodMicros / (tCount * TIMING_GRID_WIDTH);
-            // nanos are handled by TimebaseExactDivValues < 1
-            if (MeasurementControl.TimebaseIndex >= TIMEBASE_INDEX_MILLIS) {
-                tPeriodMicros = tPeriodMicros * 1000;
+            MeasurementControl.OvershootPercent = tOvershootPercent;
+        }
+    }
+}
+
+/**
+ * Get period and frequency and average for display
+ * Get max and min for display and automatic triggering.
+ *
+ * Use only post trigger area!
+ * If streaming statistics are enabled, the statistics were already computed by the ISR / DMA interrupts while acquiring.
+ */
+void computeMinMaxAverageAndPeriodFrequency(void) {
+    if (sStreamingStatisticsActive) {
+        computeStatisticsResults(&sStreamingStatistics);
+        return;
+    }
+    uint16_t * tDataBufferPointer = DataBufferControl.DataBufferDisplayStart
+            + adjustIntWithScaleFactor(DisplayControl.DatabufferPreTriggerDisplaySize, DisplayControl.XScale);
+    if (DataBufferControl.DataBufferEndPointer > tDataBufferPointer) {
+        uint16_t tAcquisitionSize = DataBufferControl.DataBufferEndPointer + 1 - tDataBufferPointer;
+        uint32_t tStartCycles = DWT->CYCCNT;
+        StatisticsStruct tStatistics;
+        initStatistics(&tStatistics);
+        if (DataBufferControl.isPacked) {
+            for (int i = 0; i < tAcquisitionSize; ++i) {
+                addValueToStatistics(&tStatistics, getDataBufferValue(tDataBufferPointer++));
             }
-            // frequency
-            tHertz = 1000000.0 / tPeriodMicros;
         } else {
-            MeasurementControl.RawValueAverage = (tIntegrateValue + (tAcquisitionSize / 2)) / tAcquisitionSize;
+            addValuesToStatistics(&tStatistics, tDataBufferPointer, tDataBufferPointer + tAcquisitionSize);
         }
-        MeasurementControl.FrequencyHertz = tHertz  + 0.5;
-        MeasurementControl.PeriodMicros = tPeriodMicros  + 0.5;
-        return;
+        AcquisitionInfo.StatisticsCycles += DWT->CYCCNT - tStartCycles;
+        AcquisitionInfo.StatisticsSampleCount += tAcquisitionSize;
+        computeStatisticsResults(&tStatistics);
     }
 }
 
@@ -1006,6 +1644,7 @@ bool changeInputRange(int aValue) {
                 MeasurementControl.RawOffsetValueForDisplayRange = getRawOffsetValueFromGridCount(
                         DISPLAY_AC_ZERO_OFFSET_GRID_COUNT);
             }
+            initRawToDisplayTable();
             // keep labels up to date
             drawGridLinesWithHorizLabelsAndTriggerLine(COLOR_GRID_LINES);
         }
@@ -1032,6 +1671,7 @@ void setACMode(bool aACMode) {
         MeasurementControl.RawOffsetValueForDisplayRange = 0;
         MeasurementControl.OffsetGridCount = 0;
     }
+    initRawToDisplayTable();
 }
 
 /**
@@ -1063,6 +1703,7 @@ bool setDisplayRange(int aNewDisplayRangeIndex, bool aClipToInputRangeIndex) {
         FactorFromInputToDisplayRangeShift12 = (RawAttenuationFactor[MeasurementControl.InputRangeIndex]
                 * (1 << DSO_INPUT_TO_DISPLAY_SHIFT)) / RawAttenuationFactor[MeasurementControl.DisplayRangeIndex];
     }
+    initRawToDisplayTable();
     return tRetValue;
 }
 
@@ -1093,6 +1734,7 @@ void setOffsetGridCount(int aOffsetGridCount) {
     MeasurementControl.RawOffsetValueForDisplayRange = getRawOffsetValueFromGridCount(aOffsetGridCount);
     MeasurementControl.RawValueOffsetClippingLower = getInputRawFromDisplayValue(DISPLAY_VALUE_FOR_ZERO); // value for bottom of display
     MeasurementControl.RawValueOffsetClippingUpper = getInputRawFromDisplayValue(0); // value for top of display
+    initRawToDisplayTable();
 }
 
 /**
@@ -1101,118 +1743,381 @@ void setOffsetGridCount(int aOffsetGridCount) {
  */
 void changeTimeBase(bool aForceSetPrescaler) {
     int tOldIndex = MeasurementControl.TimebaseIndex;
+    uint16_t tOldADCClockPrescaler = ADCClockPrescalerValues[tOldIndex];
+    if (MeasurementControl.PeakDetectActive) {
+        tOldADCClockPrescaler = PEAK_DETECT_ADC_CLOCK_PRESCALER;
+    }
     MeasurementControl.TimebaseIndex = MeasurementControl.TimebaseNewIndex;
-    ADC_SetTimer6Period(TimebaseTimerDividerValues[MeasurementControl.TimebaseIndex],
-            TimebaseTimerPrescalerDividerValues[MeasurementControl.TimebaseIndex]);
+    uint16_t tADCClockPrescaler = ADCClockPrescalerValues[MeasurementControl.TimebaseIndex];
+
+    MeasurementControl.PeakDetectActive = (MeasurementControl.isPeakDetectMode
+            && MeasurementControl.TimebaseIndex >= TIMEBASE_INDEX_PEAK_DETECT_START);
+    if (MeasurementControl.PeakDetectActive) {
+        // sample with fixed high rate - the ISR reduces the samples of 2 timebase periods to one min/max pair
+        uint32_t tTimebaseTimerCycles = TimebaseTimerDividerValues[MeasurementControl.TimebaseIndex]
+                * TimebaseTimerPrescalerDividerValues[MeasurementControl.TimebaseIndex];
+        MeasurementControl.PeakDetectWindowSampleCount = (2 * tTimebaseTimerCycles)
+                / (PEAK_DETECT_TIMER_DIVIDER * PEAK_DETECT_TIMER_PRESCALER);
+        resetPeakDetectWindow();
+        ADC_SetTimer6Period(PEAK_DETECT_TIMER_DIVIDER, PEAK_DETECT_TIMER_PRESCALER);
+        tADCClockPrescaler = PEAK_DETECT_ADC_CLOCK_PRESCALER;
+    } else {
+        ADC_SetTimer6Period(TimebaseTimerDividerValues[MeasurementControl.TimebaseIndex],
+                TimebaseTimerPrescalerDividerValues[MeasurementControl.TimebaseIndex]);
+    }
     // so set matching sampling times for channel
     ADC_SetChannelSampleTime(DSO_ADC_ID, ADCInputMUXChannels[MeasurementControl.ADCInputMUXChannelIndex],
             (MeasurementControl.TimebaseIndex < TIMEBASE_FAST_MODES));
 
-    if (aForceSetPrescaler || ADCClockPrescalerValues[MeasurementControl.TimebaseIndex] != ADCClockPrescalerValues[tOldIndex]) {
+    if (aForceSetPrescaler || tADCClockPrescaler != tOldADCClockPrescaler) {
         // stop and start is really needed :-(
         // first disable ADC otherwise sometimes interrupts just stop after the first reading
         ADC_disableAndWait(DSO_ADC_ID );
-        ADC_SetClockPrescaler(ADCClockPrescalerValues[MeasurementControl.TimebaseIndex]);
+        ADC_SetClockPrescaler(tADCClockPrescaler);
         ADC_enableAndWait(DSO_ADC_ID );
     }
 
-    if (MeasurementControl.TimebaseIndex < TIMEBASE_NUMBER_OF_XSCALE_CORRECTION) {
+    if (MeasurementControl.TimebaseIndex == TIMEBASE_INDEX_EQUIVALENT_TIME) {
+        // reconstruction buffer has display resolution
+        DisplayControl.XScale = 0;
+        resetEquivalentTime();
+    } else if (MeasurementControl.TimebaseIndex < TIMEBASE_NUMBER_OF_XSCALE_CORRECTION) {
         DisplayControl.XScale = xScaleForTimebase[MeasurementControl.TimebaseIndex];
     } else {
         DisplayControl.XScale = 0;
     }
+    // spectrum and waterfall of old timebase are meaningless
+    resetFFTAverage();
+    resetWaterfall();
     DataBufferControl.DrawWhileAcquire = (MeasurementControl.TimebaseIndex >= TIMEBASE_INDEX_DRAW_WHILE_ACQUIRE);
     MeasurementControl.TriggerTimeoutSampleOrLoopCount = computeNumberOfSamplesToTimeout(MeasurementControl.TimebaseIndex);
     printInfo();
 }
 
 /**
- * adjust (copy around) the cyclic pre trigger buffer in order to have them at linear time
- * app. 100 us
+ * Copies the display region of the completed acquisition to DisplayDataBufferControl.
+ * The pre trigger ring is resolved while copying, so no extra pass over the data is needed.
+ * Must be called after setPreTriggerRing() and before startAcquisition().
+ * app. 10 us for 640 bytes
  */
-void adjustPreTriggerBuffer(uint16_t* tTempBuffer) {
-// align pre trigger buffer
-    int tCount = 0;
-    uint16_t* tDestPtr;
-    uint16_t* tSrcPtr;
-    if ((DataBufferControl.DataBufferPreTriggerNextPointer == &DataBufferControl.DataBuffer[0])
-            || MeasurementControl.TriggerMode == TRIGGER_MODE_OFF) {
-        return;
+void copyDataBufferDisplayRegion(void) {
+    int tCount = DSO_DISPLAY_WIDTH;
+    if (!DataBufferControl.isPacked) {
+        tCount = &DataBufferControl.DataBuffer[DATABUFFER_SIZE] - DataBufferControl.DataBufferDisplayStart;
+        if (tCount > DSO_DISPLAY_WIDTH) {
+            tCount = DSO_DISPLAY_WIDTH;
+        }
     }
+    copyLinearDataBuffer(DataBufferControl.DataBufferDisplayStart, &DisplayDataBufferControl.DataBuffer[0], tCount);
+    DisplayDataBufferControl.InputRangeIndexUsed = DataBufferControl.InputRangeIndexUsed;
+}
 
-    tCount = &DataBufferControl.DataBuffer[DATABUFFER_PRE_TRIGGER_SIZE] - DataBufferControl.DataBufferPreTriggerNextPointer;
+static void reverseValues(uint16_t * aStart, uint16_t * aEnd) {
+    while (aStart < --aEnd) {
+        uint16_t tValue = *aStart;
+        *aStart++ = *aEnd;
+        *aEnd = tValue;
+    }
+}
 
+/**
+ * Rotates the cyclic pre trigger area in place (by 3 reversals), so that the oldest value is at its start
+ * @param aPreTriggerStart start of pre trigger area - &DataBuffer[0] or start of segment
+ * @param aRingOffset index of oldest pre trigger value
+ * @param aInvalidCount number of never written values at start of the rotated area
+ */
+static void rotatePreTriggerArea(uint16_t * aPreTriggerStart, int aRingOffset, int aInvalidCount) {
+    uint16_t * tPreTriggerEnd = aPreTriggerStart + DATABUFFER_PRE_TRIGGER_SIZE;
+    reverseValues(aPreTriggerStart, aPreTriggerStart + aRingOffset);
+    reverseValues(aPreTriggerStart + aRingOffset, tPreTriggerEnd);
+    reverseValues(aPreTriggerStart, tPreTriggerEnd);
+// memset can only set bytes :-(
+    for (int i = aInvalidCount; i > 0; --i) {
+        *aPreTriggerStart++ = DATABUFFER_INVISIBLE_RAW_VALUE;
+    }
+}
+
+/**
+ * Sets the ring parameters of the cyclic pre trigger area after the trigger phase,
+ * so that it can be read in linear time order by getDataBufferValue() etc. without moving any data.
+ * Must not be called in DMA mode, since DMA does not use DataBufferPreTriggerNextPointer.
+ */
+void setPreTriggerRing(void) {
+    DataBufferControl.PreTriggerRingOffset = 0;
+    DataBufferControl.PreTriggerInvalidCount = 0;
+    if ((DataBufferControl.DataBufferPreTriggerNextPointer == &DataBufferControl.DataBuffer[0])
+            || MeasurementControl.TriggerMode == TRIGGER_MODE_OFF) {
+        return;
+    }
+    DataBufferControl.PreTriggerRingOffset = DataBufferControl.DataBufferPreTriggerNextPointer
+            - &DataBufferControl.DataBuffer[0];
     /*
      * If Modus is DrawWhileAcquire and pre trigger buffer was only written once,
      * (since trigger condition was met before buffer wrap around)
      * then the tail buffer region from last pre trigger value to end of pre trigger region is invalid.
      */ //
-    bool tLastPretriggerRegionInvalid = (DataBufferControl.DrawWhileAcquire
-            && MeasurementControl.TriggerSampleCount < DATABUFFER_PRE_TRIGGER_SIZE);
-    if (!tLastPretriggerRegionInvalid) {
-// 1. shift region from last pre trigger value to end of pre trigger region to start of buffer. Use temp buffer (DisplayLineBuffer)
-        tDestPtr = tTempBuffer;
-        tSrcPtr = DataBufferControl.DataBufferPreTriggerNextPointer;
-        memcpy(tDestPtr, tSrcPtr, tCount * sizeof(*tDestPtr));
-    }
-// 2. shift region from beginning to last pre trigger value to end of pre trigger region
-    tDestPtr = &DataBufferControl.DataBuffer[DATABUFFER_PRE_TRIGGER_SIZE - 1];
-    tSrcPtr = &DataBufferControl.DataBuffer[DATABUFFER_PRE_TRIGGER_SIZE - tCount - 1];
-//	this does not work :-(  memmove(tDestPtr, tSrcPtr, (DATABUFFER_PRE_TRIGGER_SIZE - tCount) * sizeof(*tDestPtr));
-    for (int i = DATABUFFER_PRE_TRIGGER_SIZE - tCount; i > 0; --i) {
-        *tDestPtr-- = *tSrcPtr--;
-    }
-    tDestPtr++;
-// 3. copy temp buffer to start of pre trigger region
-    tSrcPtr = tTempBuffer;
-    tDestPtr = DataBufferControl.DataBuffer;
-    if (tLastPretriggerRegionInvalid) {
-// set invalid values in pretrigger area to special value
-        for (int i = tCount; i > 0; --i) {
-            *tDestPtr++ = DATABUFFER_INVISIBLE_RAW_VALUE;
-        }
-// memset can only set bytes :-(  memset(tDestPtr, DATABUFFER_INVISIBLE_RAW_VALUE, tCount * sizeof(*tDestPtr));
+    if (DataBufferControl.DrawWhileAcquire && MeasurementControl.TriggerSampleCount < DATABUFFER_PRE_TRIGGER_SIZE) {
+        DataBufferControl.PreTriggerInvalidCount = DATABUFFER_PRE_TRIGGER_SIZE - DataBufferControl.PreTriggerRingOffset;
+    }
+}
+
+/**
+ * Makes the pre trigger ring linear in place for analysis of a stopped acquisition, storage etc.
+ * Called only once at stop, so running acquisitions never move their pre trigger data.
+ */
+void linearizePreTriggerBuffer(void) {
+    if (DataBufferControl.PreTriggerRingOffset == 0 && DataBufferControl.PreTriggerInvalidCount == 0) {
+        return;
+    }
+    rotatePreTriggerArea(&DataBufferControl.DataBuffer[0], DataBufferControl.PreTriggerRingOffset,
+            DataBufferControl.PreTriggerInvalidCount);
+    DataBufferControl.PreTriggerRingOffset = 0;
+    DataBufferControl.PreTriggerInvalidCount = 0;
+}
+
+/**
+ * Makes the ring of a stopped roll mode acquisition linear in place and sets display start to its last screen
+ */
+void linearizeRollBuffer(void) {
+    // acquisition is over, end pointer below must not be taken as request for a new last acquisition
+    MeasurementControl.RollModeActive = false;
+    MeasurementControl.StopAcknowledged = true;
+    uint16_t * tEndPointer = DataBufferControl.DataBufferNextInPointer; // behind newest value
+    if (DataBufferControl.DataBufferRollWrapAround) {
+        // oldest value is at tEndPointer -> rotate it to start of buffer
+        reverseValues(&DataBufferControl.DataBuffer[0], tEndPointer);
+        reverseValues(tEndPointer, &DataBufferControl.DataBuffer[DATABUFFER_SIZE]);
+        reverseValues(&DataBufferControl.DataBuffer[0], &DataBufferControl.DataBuffer[DATABUFFER_SIZE]);
+        tEndPointer = &DataBufferControl.DataBuffer[DATABUFFER_SIZE];
+    } else {
+        // clear trailing buffer space not used
+        for (uint16_t * tPointer = tEndPointer; tPointer < &DataBufferControl.DataBuffer[DATABUFFER_SIZE]; ++tPointer) {
+            *tPointer = DATABUFFER_INVISIBLE_RAW_VALUE;
+        }
+    }
+    DataBufferControl.DataBufferEndPointer = tEndPointer - 1;
+    if (tEndPointer - &DataBufferControl.DataBuffer[0] > DSO_DISPLAY_WIDTH) {
+        DataBufferControl.DataBufferDisplayStart = tEndPointer - DSO_DISPLAY_WIDTH;
+    } else {
+        DataBufferControl.DataBufferDisplayStart = &DataBufferControl.DataBuffer[0];
+    }
+}
+
+/**
+ * Aligns the pre trigger areas of all segments after a segment mode acquisition
+ */
+void adjustSegmentsPreTriggerBuffer(void) {
+    if (MeasurementControl.TriggerMode == TRIGGER_MODE_OFF) {
+        return;
+    }
+    uint16_t * tSegmentStart = &DataBufferControl.DataBuffer[0];
+    for (int i = 0; i <= DataBufferControl.SegmentIndex; ++i) {
+        if (SegmentInfo[i].PreTriggerNextPointer != tSegmentStart) {
+            rotatePreTriggerArea(tSegmentStart, SegmentInfo[i].PreTriggerNextPointer - tSegmentStart, 0);
+        }
+        tSegmentStart += DATABUFFER_SEGMENT_SIZE;
+    }
+}
+
+/*
+ * Window section - windows are sums of cosines and computed from a quarter period cosine table for FFT_SIZE_MAX.
+ * The selected window is precomputed for FFT_SIZE_MAX, smaller FFTs use every n.th value.
+ */
+// cos(2 * PI * i / FFT_SIZE_MAX) for the first quarter period including PI / 2
+static const q15_t FFTCosTableQ15[FFT_SIZE_MAX / 4 + 1] = {
+        32767, 32766, 32758, 32746, 32729, 32706, 32679, 32647, 32610, 32568, 32522, 32470, 32413, 32352, 32286,
+        32214, 32138, 32058, 31972, 31881, 31786, 31686, 31581, 31471, 31357, 31238, 31114, 30986, 30853, 30715,
+        30572, 30425, 30274, 30118, 29957, 29792, 29622, 29448, 29269, 29086, 28899, 28707, 28511, 28311, 28106,
+        27897, 27684, 27467, 27246, 27020, 26791, 26557, 26320, 26078, 25833, 25583, 25330, 25073, 24812, 24548,
+        24279, 24008, 23732, 23453, 23170, 22884, 22595, 22302, 22006, 21706, 21403, 21097, 20788, 20475, 20160,
+        19841, 19520, 19195, 18868, 18538, 18205, 17869, 17531, 17190, 16846, 16500, 16151, 15800, 15447, 15091,
+        14733, 14373, 14010, 13646, 13279, 12910, 12540, 12167, 11793, 11417, 11039, 10660, 10279, 9896, 9512, 9127,
+        8740, 8351, 7962, 7571, 7180, 6787, 6393, 5998, 5602, 5205, 4808, 4410, 4011, 3612, 3212, 2811, 2411, 2009,
+        1608, 1206, 804, 402, 0 };
+
+// a0, a1, a2, a3, a4 of w = a0 - a1 * cos(x) + a2 * cos(2x) - a3 * cos(3x) + a4 * cos(4x)
+static const q15_t FFTWindowCoefficientsQ15[FFT_WINDOW_NUMBER][5] = { { 32767, 0, 0, 0, 0 }, // rectangle
+        { 16384, 16384, 0, 0, 0 }, // Hann
+        { 17695, 15073, 0, 0, 0 }, // Hamming
+        { 7064, 13652, 9085, 2739, 228 } }; // flat top
+// 1 / (2 * a0) - since a bin magnitude of computeFFTQ15() is the amplitude multiplied by 2 * a0
+static const float FFTWindowAmplitudeFactor[FFT_WINDOW_NUMBER] = { 0.5, 1.0, 0.9259, 2.3194 };
+
+// first half of window including the middle value
+static q15_t FFTWindowQ15[FFT_SIZE_MAX / 2 + 1];
+static uint8_t sFFTWindowTypeComputed = FFT_WINDOW_NUMBER; // forces computation at first call
+
+/**
+ * @return cos(2 * PI * aIndex / FFT_SIZE_MAX) as q15
+ */
+static int getFFTCosQ15(int aIndex) {
+    aIndex &= (FFT_SIZE_MAX - 1);
+    if (aIndex <= FFT_SIZE_MAX / 4) {
+        return FFTCosTableQ15[aIndex];
+    } else if (aIndex <= FFT_SIZE_MAX / 2) {
+        return -FFTCosTableQ15[(FFT_SIZE_MAX / 2) - aIndex];
+    } else if (aIndex <= (3 * FFT_SIZE_MAX) / 4) {
+        return -FFTCosTableQ15[aIndex - (FFT_SIZE_MAX / 2)];
+    }
+    return FFTCosTableQ15[FFT_SIZE_MAX - aIndex];
+}
+
+/**
+ * Computes window table if window type has changed
+ */
+static void initFFTWindow(void) {
+    if (sFFTWindowTypeComputed == DisplayControl.FFTWindowType) {
+        return;
+    }
+    sFFTWindowTypeComputed = DisplayControl.FFTWindowType;
+    const q15_t * tCoefficients = &FFTWindowCoefficientsQ15[DisplayControl.FFTWindowType][0];
+    for (int i = 0; i <= FFT_SIZE_MAX / 2; ++i) {
+        int32_t tValue = tCoefficients[0] << 15;
+        int32_t tSign = -1;
+        for (int k = 1; k < 5; ++k) {
+            tValue += tSign * tCoefficients[k] * getFFTCosQ15(k * i);
+            tSign = -tSign;
+        }
+        tValue >>= 15;
+        if (tValue > 32767) {
+            tValue = 32767;
+        }
+        FFTWindowQ15[i] = tValue;
+    }
+}
+
+/**
+ * @return window value for index aIndex of an FFT of size aFFTSize
+ */
+static inline int getFFTWindowQ15(int aIndex, int aFFTSize) {
+    if (aIndex > aFFTSize / 2) {
+        // use symmetry
+        aIndex = aFFTSize - aIndex;
+    }
+    return FFTWindowQ15[aIndex * (FFT_SIZE_MAX / aFFTSize)];
+}
+
+/**
+ * Fast logarithm for dB display
+ * @param aValue - must be > 0
+ * @return log2(aValue) * 256 with an error below 0.02, using a parabolic approximation of the mantissa
+ */
+int getLog2Shift8(uint32_t aValue) {
+    int tExponent = 31 - __CLZ(aValue);
+    int tMantissa;
+    if (tExponent >= 8) {
+        tMantissa = (aValue >> (tExponent - 8)) & 0xFF;
     } else {
-        memcpy(tDestPtr, tSrcPtr, tCount * sizeof(*tDestPtr));
+        tMantissa = (aValue << (8 - tExponent)) & 0xFF;
+    }
+    // log2(1 + m) ~ m + 0.347 * m * (1 - m)
+    return (tExponent << 8) + tMantissa + ((tMantissa * (256 - tMantissa) * 89) >> 16);
+}
+
+/*
+ * Real input FFT - the N real values are taken as N/2 complex values for the radix 2 complex FFT
+ * and the spectrum of the real values is separated afterwards in place.
+ * This needs half of the complex FFT work and N floats of memory.
+ * The instance is only initialized if the size changes.
+ */
+static arm_cfft_radix2_instance_f32 sFFTInstance;
+static float32_t sFFTTwiddleCosStep; // cos(2 * PI / N)
+static float32_t sFFTTwiddleSinStep;
+
+static void initRealFFT(int aFFTSize) {
+    if (sFFTInstance.fftLen != aFFTSize / 2) {
+        // no IFFT, bitReverse
+        arm_cfft_radix2_init_f32(&sFFTInstance, aFFTSize / 2, 0, 1);
+        sFFTTwiddleCosStep = arm_cos_f32(2 * PI / aFFTSize);
+        sFFTTwiddleSinStep = arm_sin_f32(2 * PI / aFFTSize);
     }
 }
 
 /**
- * 3ms for FFT with -OS
+ * Computes the first N/2 bins X[k] of the real FFT from the N/2 bins Z[k] of the complex FFT in place.
+ * X[k] = E[k] + W^k * O[k] and X[N/2 - k] = conj(E[k] - W^k * O[k])
+ * with E[k] = (Z[k] + conj(Z[N/2 - k])) / 2, O[k] = -i * (Z[k] - conj(Z[N/2 - k])) / 2 and W = e^(-i * 2 * PI / N)
+ * Real part of nyquist bin is stored as imaginary part of DC bin.
  */
-void computeFFT(uint16_t * aDataBufferPointer, float32_t *aFFTBuffer) {
-    arm_cfft_radix4_instance_f32 tFFTControlStruct;
+static void separateRealFFT(float32_t *aFFTBuffer, int aFFTSize) {
+    int tHalfSize = aFFTSize / 2;
+    float32_t tReal = aFFTBuffer[0];
+    float32_t tImaginary = aFFTBuffer[1];
+    aFFTBuffer[0] = tReal + tImaginary;
+    aFFTBuffer[1] = tReal - tImaginary;
+
+    // W^k = tCos - i * tSin
+    float32_t tCos = 1.0;
+    float32_t tSin = 0.0;
+    for (int k = 1; k <= tHalfSize / 2; ++k) {
+        float32_t tCosOld = tCos;
+        tCos = tCos * sFFTTwiddleCosStep - tSin * sFFTTwiddleSinStep;
+        tSin = tSin * sFFTTwiddleCosStep + tCosOld * sFFTTwiddleSinStep;
+
+        float32_t *tLowPointer = &aFFTBuffer[2 * k];
+        float32_t *tHighPointer = &aFFTBuffer[2 * (tHalfSize - k)];
+        float32_t tEvenReal = 0.5 * (tLowPointer[0] + tHighPointer[0]);
+        float32_t tEvenImaginary = 0.5 * (tLowPointer[1] - tHighPointer[1]);
+        float32_t tOddReal = 0.5 * (tLowPointer[1] + tHighPointer[1]);
+        float32_t tOddImaginary = 0.5 * (tHighPointer[0] - tLowPointer[0]);
+        // W^k * O[k]
+        tReal = tCos * tOddReal + tSin * tOddImaginary;
+        tImaginary = tCos * tOddImaginary - tSin * tOddReal;
+
+        tLowPointer[0] = tEvenReal + tReal;
+        tLowPointer[1] = tEvenImaginary + tImaginary;
+        tHighPointer[0] = tEvenReal - tReal;
+        tHighPointer[1] = tImaginary - tEvenImaginary;
+    }
+}
+
+/**
+ * 3ms for FFT with -OS at 256 samples - measured with complex FFT
+ * @param aFFTBuffer - space for aFFTSize floats, contains aFFTSize / 2 bin values in volt afterwards. DC bin is set to zero.
+ * @param aFFTSize - power of 2 up to FFT_SIZE_MAX
+ */
+void computeFFT(uint16_t * aDataBufferPointer, float32_t *aFFTBuffer, int aFFTSize) {
     int i;
 
     uint32_t tTime = getMillisSinceBoot();
+    initRealFFT(aFFTSize);
 
-    // generates FFT input array
-    for (i = 0; i < FFT_SIZE; ++i) {
-        *aFFTBuffer++ = getFloatFromRawValue(*aDataBufferPointer++);
-        *aFFTBuffer++ = 0.0;
+    initFFTWindow();
+
+    // DC must be removed before windowing, otherwise it leaks into the low bins
+    uint32_t tSum = 0;
+    for (i = 0; i < aFFTSize; ++i) {
+        tSum += aDataBufferPointer[i];
+    }
+    int tDCValue = tSum / aFFTSize;
+
+    // generates FFT input array - conversion to volt is done once for each bin
+    float32_t *tFFTBuffer = aFFTBuffer;
+    for (i = 0; i < aFFTSize; ++i) {
+        *tFFTBuffer++ = (float32_t) ((*aDataBufferPointer++ - tDCValue) * getFFTWindowQ15(i, aFFTSize));
     }
-    // Initialize the CFFT/CIFFT module 256 samples, no IFFT, bitReverse
-    arm_cfft_radix4_init_f32(&tFFTControlStruct, FFT_SIZE, 0, 1);
 
-    aFFTBuffer = (float32_t *) FourDisplayLinesBuffer;
     /* Process the data through the CFFT/CIFFT module */
-    arm_cfft_radix4_f32(&tFFTControlStruct, aFFTBuffer);
+    arm_cfft_radix2_f32(&sFFTInstance, aFFTBuffer);
+    separateRealFFT(aFFTBuffer, aFFTSize);
 
-    aFFTBuffer = &((float32_t *) FourDisplayLinesBuffer)[2]; // skip DC value
-    float32_t *tOutBuffer = (float32_t *) FourDisplayLinesBuffer;
+    tFFTBuffer = &aFFTBuffer[2]; // skip DC and nyquist value
+    float32_t *tOutBuffer = aFFTBuffer;
     float32_t tRealValue, tImaginaryValue;
     float tMaxValue = 0.0;
     int tMaxIndex = 0;
+    // window values are q15
+    float tVoltFactor = actualDSORawToVoltFactor / 32768;
 
     *tOutBuffer++ = 0; // set DC to zero so it does not affect the scaling
     // use only the first half of bins
-    for (i = 1; i < FFT_SIZE / 2; ++i) {
+    for (i = 1; i < aFFTSize / 2; ++i) {
         /*
          * in place conversion
          */
-        tRealValue = *aFFTBuffer++;
-        tImaginaryValue = *aFFTBuffer++;
-        tRealValue = sqrtf((tRealValue * tRealValue) + (tImaginaryValue * tImaginaryValue));
+        tRealValue = *tFFTBuffer++;
+        tImaginaryValue = *tFFTBuffer++;
+        tRealValue = sqrtf((tRealValue * tRealValue) + (tImaginaryValue * tImaginaryValue)) * tVoltFactor;
         // find max bin value for scaling and frequency display
         if (tRealValue > tMaxValue) {
             tMaxValue = tRealValue;
@@ -1222,6 +2127,1028 @@ void computeFFT(uint16_t * aDataBufferPointer, float32_t *aFFTBuffer) {
     }
     FFTInfo.MaxValue = tMaxValue;
     FFTInfo.MaxIndex = tMaxIndex;
+    FFTInfo.Size = aFFTSize;
     FFTInfo.TimeElapsedMillis = getMillisSinceBoot() - tTime;
 
 }
+
+/*
+ * Fixed point FFT for the running display - works on raw values without float conversion.
+ * The DC value is subtracted, the values are windowed, shifted to q15 range and transformed
+ * by the same real input scheme as computeFFT() with the q15 radix 2 complex FFT.
+ * The q15 complex FFT scales down by FFT_SIZE / 2, so the magnitude of a bin is the amplitude of a sine in raw values
+ * multiplied with 2 * a0 of the window.
+ */
+#define FFT_Q15_INPUT_SHIFT 2 // 12 bit ADC values -> 14 bit, leaves 1 bit headroom for the separation of the real spectrum
+
+static arm_cfft_radix2_instance_q15 sFFTInstanceQ15;
+
+/*
+ * Persistent bin values for averaging and peak hold of running FFT
+ */
+static uint32_t FFTBinAccumulator[FFT_SIZE / 2];
+static q15_t FFTBinBlockAverage[FFT_SIZE / 2]; // result of last complete block
+static uint8_t sFFTAverageCount;
+static bool sFFTBlockAverageValid;
+
+void resetFFTAverage(void) {
+    memset(FFTBinAccumulator, 0, sizeof(FFTBinAccumulator));
+    sFFTAverageCount = 0;
+    sFFTBlockAverageValid = false;
+}
+
+/**
+ * Integer version of separateRealFFT() for FFT_SIZE, DC and nyquist bins are not computed
+ */
+static void separateRealFFTQ15(q15_t *aFFTBuffer) {
+    for (int k = 1; k <= FFT_SIZE / 4; ++k) {
+        // W^k = tCos - i * tSin
+        int32_t tCos = getFFTCosQ15(k * (FFT_SIZE_MAX / FFT_SIZE));
+        int32_t tSin = getFFTCosQ15(((FFT_SIZE / 4) - k) * (FFT_SIZE_MAX / FFT_SIZE));
+
+        q15_t *tLowPointer = &aFFTBuffer[2 * k];
+        q15_t *tHighPointer = &aFFTBuffer[2 * ((FFT_SIZE / 2) - k)];
+        int32_t tEvenReal = (tLowPointer[0] + tHighPointer[0]) >> 1;
+        int32_t tEvenImaginary = (tLowPointer[1] - tHighPointer[1]) >> 1;
+        int32_t tOddReal = (tLowPointer[1] + tHighPointer[1]) >> 1;
+        int32_t tOddImaginary = (tHighPointer[0] - tLowPointer[0]) >> 1;
+        // W^k * O[k]
+        int32_t tReal = (tCos * tOddReal + tSin * tOddImaginary) >> 15;
+        int32_t tImaginary = (tCos * tOddImaginary - tSin * tOddReal) >> 15;
+
+        tLowPointer[0] = tEvenReal + tReal;
+        tLowPointer[1] = tEvenImaginary + tImaginary;
+        tHighPointer[0] = tEvenReal - tReal;
+        tHighPointer[1] = tImaginary - tEvenImaginary;
+    }
+}
+
+/**
+ * Replaces magnitudes by their average or peak value according to DisplayControl.FFTAverageMode.
+ * Costs one add or compare per bin and frame.
+ */
+static void averageFFTMagnitudes(q15_t *aMagnitudes) {
+    uint8_t tMode = DisplayControl.FFTAverageMode;
+    if (tMode == FFT_AVERAGE_OFF) {
+        return;
+    }
+    if (sFFTAverageCount < 0xFF) {
+        sFFTAverageCount++;
+    }
+    for (int i = 1; i < FFT_SIZE / 2; ++i) {
+        uint32_t tValue = aMagnitudes[i];
+        uint32_t tAccumulator = FFTBinAccumulator[i];
+        if (tMode == FFT_AVERAGE_EXPONENTIAL) {
+            // accumulator holds average << FFT_AVERAGE_EXPONENTIAL_SHIFT
+            if (sFFTAverageCount == 1) {
+                tAccumulator = tValue << FFT_AVERAGE_EXPONENTIAL_SHIFT;
+            } else {
+                tAccumulator += tValue - (tAccumulator >> FFT_AVERAGE_EXPONENTIAL_SHIFT);
+            }
+            aMagnitudes[i] = tAccumulator >> FFT_AVERAGE_EXPONENTIAL_SHIFT;
+        } else if (tMode == FFT_AVERAGE_BLOCK) {
+            tAccumulator += tValue;
+            if (sFFTAverageCount >= FFT_AVERAGE_BLOCK_SIZE) {
+                FFTBinBlockAverage[i] = tAccumulator / FFT_AVERAGE_BLOCK_SIZE;
+                tAccumulator = 0;
+            }
+            if (!sFFTBlockAverageValid && sFFTAverageCount < FFT_AVERAGE_BLOCK_SIZE) {
+                // first block not yet complete
+                aMagnitudes[i] = tAccumulator / sFFTAverageCount;
+            } else {
+                aMagnitudes[i] = FFTBinBlockAverage[i];
+            }
+        } else {
+            // peak hold
+            if (tValue > tAccumulator) {
+                tAccumulator = tValue;
+            }
+            aMagnitudes[i] = tAccumulator;
+        }
+        FFTBinAccumulator[i] = tAccumulator;
+    }
+    if (tMode == FFT_AVERAGE_BLOCK && sFFTAverageCount >= FFT_AVERAGE_BLOCK_SIZE) {
+        sFFTAverageCount = 0;
+        sFFTBlockAverageValid = true;
+    }
+}
+
+/**
+ * @param aFFTBuffer - space for 3 * FFT_SIZE / 2 q15 values
+ * @return pointer to FFT_SIZE / 2 averaged bin magnitudes in raw values in aFFTBuffer. DC bin is set to zero.
+ */
+q15_t * computeFFTQ15(uint16_t * aDataBufferPointer, q15_t *aFFTBuffer) {
+    uint32_t tTime = getMillisSinceBoot();
+    if (sFFTInstanceQ15.fftLen != FFT_SIZE / 2) {
+        // no IFFT, bitReverse
+        arm_cfft_radix2_init_q15(&sFFTInstanceQ15, FFT_SIZE / 2, 0, 1);
+    }
+    initFFTWindow();
+
+    uint32_t tSum = 0;
+    for (int i = 0; i < FFT_SIZE; ++i) {
+        tSum += aDataBufferPointer[i];
+    }
+    int tDCValue = tSum / FFT_SIZE;
+
+    // generates FFT input array
+    for (int i = 0; i < FFT_SIZE; ++i) {
+        aFFTBuffer[i] = (((aDataBufferPointer[i] - tDCValue) << FFT_Q15_INPUT_SHIFT) * getFFTWindowQ15(i, FFT_SIZE)) >> 15;
+    }
+
+    arm_cfft_radix2_q15(&sFFTInstanceQ15, aFFTBuffer);
+    separateRealFFTQ15(aFFTBuffer);
+
+    /*
+     * Half of the magnitude compensates the doubling by the separation.
+     * arm_cmplx_mag_q15() is not used, it takes the square root of only the upper 15 bits of the sum of squares,
+     * which leaves just a few levels for the small bin values of the down scaled q15 FFT.
+     */
+    q15_t *tMagnitudes = &aFFTBuffer[FFT_SIZE];
+    tMagnitudes[0] = 0; // set DC to zero so it does not affect the scaling
+    for (int i = 1; i < FFT_SIZE / 2; ++i) {
+        int32_t tReal = aFFTBuffer[2 * i];
+        int32_t tImaginary = aFFTBuffer[2 * i + 1];
+        tMagnitudes[i] = (sqrtf((float) ((tReal * tReal) + (tImaginary * tImaginary))) * 0.5f) + 0.5f;
+    }
+    averageFFTMagnitudes(tMagnitudes);
+
+    q15_t tMaxValue;
+    uint32_t tMaxIndex;
+    arm_max_q15(&tMagnitudes[1], (FFT_SIZE / 2) - 1, &tMaxValue, &tMaxIndex);
+    FFTInfo.MaxValue = tMaxValue * actualDSORawToVoltFactor * FFTWindowAmplitudeFactor[DisplayControl.FFTWindowType];
+    FFTInfo.MaxIndex = tMaxIndex + 1;
+    FFTInfo.Size = FFT_SIZE;
+    FFTInfo.TimeElapsedMillis = getMillisSinceBoot() - tTime;
+    return tMagnitudes;
+}
+
+/************************************************************************
+ * Harmonic analysis section - Goertzel filters at the measured frequency and its harmonics.
+ * Costs (HARMONICS_NUMBER + 1) Goertzel passes over the samples, so it can run for every acquisition without any FFT.
+ ************************************************************************/
+HarmonicsInfoStruct HarmonicsInfo;
+
+/*
+ * Generalized Goertzel - aOmega need not be a multiple of 2 * PI / aCount
+ * @param aMean is subtracted from each sample
+ * @param aRealPtr, aImaginaryPtr DFT value at aOmega, phase is referenced to the first sample
+ */
+static void computeGoertzel(uint16_t * aDataBufferPointer, int aCount, int aMean, float32_t aOmega, float32_t * aRealPtr,
+        float32_t * aImaginaryPtr) {
+    float32_t tCos = arm_cos_f32(aOmega);
+    float32_t tCoefficient = 2 * tCos;
+    float32_t tS1 = 0.0;
+    float32_t tS2 = 0.0;
+    for (int i = 0; i < aCount; ++i) {
+        float32_t tS0 = (int) (aDataBufferPointer[i] - aMean) + (tCoefficient * tS1) - tS2;
+        tS2 = tS1;
+        tS1 = tS0;
+    }
+    // S1 - e^(-i * aOmega) * S2 is the DFT value multiplied by e^(i * aOmega * (aCount - 1))
+    float32_t tReal = tS1 - (tS2 * tCos);
+    float32_t tImaginary = tS2 * arm_sin_f32(aOmega);
+    float32_t tAngle = aOmega * (aCount - 1);
+    tAngle -= (2 * PI) * (int) (tAngle / (2 * PI));
+    float32_t tRotationCos = arm_cos_f32(tAngle);
+    float32_t tRotationSin = arm_sin_f32(tAngle);
+    *aRealPtr = (tReal * tRotationCos) + (tImaginary * tRotationSin);
+    *aImaginaryPtr = (tImaginary * tRotationCos) - (tReal * tRotationSin);
+}
+
+/*
+ * @return number of samples of the maximum integer number of periods or 0 if not even one period fits
+ */
+static int getIntegerPeriodsCount(int aCount, float32_t aCyclesPerSample) {
+    int tPeriods = aCount * aCyclesPerSample;
+    if (tPeriods < 1 || aCyclesPerSample >= 0.5) {
+        return 0;
+    }
+    int tCount = (tPeriods / aCyclesPerSample) + 0.5;
+    if (tCount > aCount) {
+        tCount = aCount;
+    }
+    return tCount;
+}
+
+static int getMean(uint16_t * aDataBufferPointer, int aCount) {
+    uint32_t tSum = 0;
+    for (int i = 0; i < aCount; ++i) {
+        tSum += aDataBufferPointer[i];
+    }
+    return tSum / aCount;
+}
+
+/**
+ * Computes amplitude and phase of the fundamental and THD up to the HARMONICS_NUMBER - 1. harmonic.
+ * The fundamental is seeded with MeasurementControl.FrequencyHertz and refined by the phase advance between
+ * the first and the second half of the samples, since the measured frequency is only an integer.
+ * Only an integer number of periods of the refined frequency is used, so no window is needed.
+ * Invisible values of a not yet filled pre trigger area at start or of a stopped acquisition at end are skipped.
+ * @param aDataBufferPointer raw values with TIMING_GRID_WIDTH samples per division
+ */
+void computeHarmonics(uint16_t * aDataBufferPointer, int aCount) {
+    HarmonicsInfo.Valid = false;
+    if (MeasurementControl.FrequencyHertz == 0 || MeasurementControl.TimebaseIndex == TIMEBASE_INDEX_EQUIVALENT_TIME) {
+        return;
+    }
+    // use only the contiguous visible values
+    while (aCount > 0 && *aDataBufferPointer == DATABUFFER_INVISIBLE_RAW_VALUE) {
+        aDataBufferPointer++;
+        aCount--;
+    }
+    while (aCount > 0 && aDataBufferPointer[aCount - 1] == DATABUFFER_INVISIBLE_RAW_VALUE) {
+        aCount--;
+    }
+    float32_t tMicrosPerSample = getTimebaseExactValueMicros(MeasurementControl.TimebaseIndex) / TIMING_GRID_WIDTH;
+    float32_t tCyclesPerSample = MeasurementControl.FrequencyHertz * tMicrosPerSample / 1000000;
+    int tCount = getIntegerPeriodsCount(aCount, tCyclesPerSample);
+    if (tCount == 0) {
+        return;
+    }
+    int tMean = getMean(aDataBufferPointer, tCount);
+
+    // refine fundamental by the phase advance between first and second half of samples
+    float32_t tOmega = 2 * PI * tCyclesPerSample;
+    int tHalfCount = tCount / 2;
+    float32_t tReal, tImaginary;
+    computeGoertzel(aDataBufferPointer, tHalfCount, tMean, tOmega, &tReal, &tImaginary);
+    float32_t tPhaseFirstHalf = atan2f(tImaginary, tReal);
+    computeGoertzel(aDataBufferPointer + tHalfCount, tHalfCount, tMean, tOmega, &tReal, &tImaginary);
+    float32_t tPhaseDeviation = atan2f(tImaginary, tReal) - tPhaseFirstHalf - (tOmega * tHalfCount);
+    tPhaseDeviation -= (2 * PI) * floorf((tPhaseDeviation + PI) / (2 * PI));
+    tOmega += tPhaseDeviation / tHalfCount;
+    // use integer number of periods of refined frequency
+    tCount = getIntegerPeriodsCount(aCount, tOmega / (2 * PI));
+    if (tCount == 0) {
+        return;
+    }
+    tMean = getMean(aDataBufferPointer, tCount);
+    HarmonicsInfo.FrequencyHertz = tOmega * 1000000 / (2 * PI * tMicrosPerSample);
+
+    // amplitude of a sine is 2 * DFT magnitude / number of samples
+    float32_t tVoltFactor = 2 * actualDSORawToVoltFactor / tCount;
+    float32_t tHarmonicsPowerSum = 0.0;
+    HarmonicsInfo.HarmonicsUsed = 0;
+    for (int i = 0; i < HARMONICS_NUMBER; ++i) {
+        float32_t tHarmonicOmega = tOmega * (i + 1);
+        if (tHarmonicOmega >= PI) {
+            // above half of sample frequency
+            HarmonicsInfo.Amplitude[i] = 0.0;
+            continue;
+        }
+        HarmonicsInfo.HarmonicsUsed++;
+        computeGoertzel(aDataBufferPointer, tCount, tMean, tHarmonicOmega, &tReal, &tImaginary);
+        float32_t tAmplitude = sqrtf((tReal * tReal) + (tImaginary * tImaginary)) * tVoltFactor;
+        HarmonicsInfo.Amplitude[i] = tAmplitude;
+        if (i == 0) {
+            // phase of cosine at first sample
+            HarmonicsInfo.PhaseDegree = atan2f(tImaginary, tReal) * (180 / PI);
+        } else {
+            tHarmonicsPowerSum += tAmplitude * tAmplitude;
+        }
+    }
+    if (HarmonicsInfo.Amplitude[0] > 0.0) {
+        HarmonicsInfo.THDPercent = sqrtf(tHarmonicsPowerSum) * 100 / HarmonicsInfo.Amplitude[0];
+        HarmonicsInfo.Valid = true;
+    }
+}
+
+/************************************************************************
+ * Filter section
+ ************************************************************************/
+/*
+ * The filters work on a copy of the values to be displayed, so switching the filter needs no new acquisition.
+ * Raw values are shifted to q15 range and filtered in blocks by the CMSIS-DSP fixed point functions.
+ * The CMSIS instances are initialized by initFilter() when the filter is selected.
+ * Filter state is initialized with the first value and the group delay is compensated
+ * by skipping the first outputs and feeding the last value again at the end.
+ */
+#define FILTER_RAW_TO_Q15_SHIFT 3 // 12 bit ADC values -> 15 bit
+#define FILTER_BLOCK_SIZE 32
+
+#define FILTER_MOVING_AVERAGE_SHIFT 3
+#define FILTER_MOVING_AVERAGE_SIZE (1 << FILTER_MOVING_AVERAGE_SHIFT)
+#define FILTER_MOVING_AVERAGE_DELAY (FILTER_MOVING_AVERAGE_SIZE / 2)
+
+// 2. order Butterworth low pass at 0.05 * sample rate. CMSIS order b0, 0, b1, b2, -a1, -a2 - all scaled by 0.5
+#define FILTER_BIQUAD_POST_SHIFT 1
+#define FILTER_BIQUAD_DELAY 4 // group delay for frequencies well below cutoff
+static q15_t FilterBiquadCoefficients[6] = { 329, 0, 658, 329, 25576, -10508 };
+
+// 16 taps Hamming window low pass at 0.1 * sample rate
+#define FILTER_FIR_NUMBER_OF_TAPS 16
+#define FILTER_FIR_DELAY (FILTER_FIR_NUMBER_OF_TAPS / 2)
+static q15_t FilterFIRCoefficients[FILTER_FIR_NUMBER_OF_TAPS] = { -114, -159, -139, 291, 1450, 3284, 5246, 6524, 6524, 5246, 3284,
+        1450, 291, -139, -159, -114 };
+
+static arm_fir_instance_q15 sFilterFIRInstance;
+static q15_t FilterFIRState[FILTER_FIR_NUMBER_OF_TAPS + FILTER_BLOCK_SIZE];
+static arm_biquad_casd_df1_inst_q15 sFilterBiquadInstance;
+static q15_t FilterBiquadState[4];
+
+static uint16_t FilterViewBuffer[FILTER_VIEW_BUFFER_SIZE];
+
+/**
+ * Initializes the CMSIS instance of the filter selected by DisplayControl.FilterType
+ */
+void initFilter(void) {
+    if (DisplayControl.FilterType == FILTER_TYPE_IIR) {
+        arm_biquad_cascade_df1_init_q15(&sFilterBiquadInstance, 1, FilterBiquadCoefficients, FilterBiquadState,
+                FILTER_BIQUAD_POST_SHIFT);
+    } else if (DisplayControl.FilterType == FILTER_TYPE_FIR) {
+        arm_fir_init_q15(&sFilterFIRInstance, FILTER_FIR_NUMBER_OF_TAPS, FilterFIRCoefficients, FilterFIRState,
+                FILTER_BLOCK_SIZE);
+    }
+}
+
+/**
+ * Filters aCount valid raw values from aSourcePointer to aDestinationPointer according to DisplayControl.FilterType
+ */
+static void filterValues(uint16_t * aSourcePointer, uint16_t * aDestinationPointer, int aCount) {
+    q15_t tInputBlock[FILTER_BLOCK_SIZE];
+    q15_t tOutputBlock[FILTER_BLOCK_SIZE];
+    q15_t tFirstValue = aSourcePointer[0] << FILTER_RAW_TO_Q15_SHIFT;
+    q15_t tLastValue = aSourcePointer[aCount - 1] << FILTER_RAW_TO_Q15_SHIFT;
+
+    // moving average state
+    q15_t tMovingAverageRing[FILTER_MOVING_AVERAGE_SIZE];
+    int tMovingAverageIndex = 0;
+    int32_t tMovingAverageSum = tFirstValue * FILTER_MOVING_AVERAGE_SIZE;
+
+    int tDelay;
+    if (DisplayControl.FilterType == FILTER_TYPE_MOVING_AVERAGE) {
+        tDelay = FILTER_MOVING_AVERAGE_DELAY;
+        for (int i = 0; i < FILTER_MOVING_AVERAGE_SIZE; ++i) {
+            tMovingAverageRing[i] = tFirstValue;
+        }
+    } else if (DisplayControl.FilterType == FILTER_TYPE_IIR) {
+        tDelay = FILTER_BIQUAD_DELAY;
+        // x[n-1], x[n-2], y[n-1], y[n-2] -> steady state
+        for (int i = 0; i < 4; ++i) {
+            FilterBiquadState[i] = tFirstValue;
+        }
+    } else {
+        tDelay = FILTER_FIR_DELAY;
+        // previous inputs -> steady state
+        for (int i = 0; i < FILTER_FIR_NUMBER_OF_TAPS - 1; ++i) {
+            FilterFIRState[i] = tFirstValue;
+        }
+    }
+
+    // output index is behind input index by group delay
+    for (int tInputIndex = 0; tInputIndex < aCount + tDelay; tInputIndex += FILTER_BLOCK_SIZE) {
+        for (int i = 0; i < FILTER_BLOCK_SIZE; ++i) {
+            if (tInputIndex + i < aCount) {
+                tInputBlock[i] = aSourcePointer[tInputIndex + i] << FILTER_RAW_TO_Q15_SHIFT;
+            } else {
+                tInputBlock[i] = tLastValue;
+            }
+        }
+
+        if (DisplayControl.FilterType == FILTER_TYPE_MOVING_AVERAGE) {
+            for (int i = 0; i < FILTER_BLOCK_SIZE; ++i) {
+                tMovingAverageSum += tInputBlock[i] - tMovingAverageRing[tMovingAverageIndex];
+                tMovingAverageRing[tMovingAverageIndex] = tInputBlock[i];
+                tMovingAverageIndex = (tMovingAverageIndex + 1) & (FILTER_MOVING_AVERAGE_SIZE - 1);
+                // sum is never negative, so shift is the same as division
+                tOutputBlock[i] = tMovingAverageSum >> FILTER_MOVING_AVERAGE_SHIFT;
+            }
+        } else if (DisplayControl.FilterType == FILTER_TYPE_IIR) {
+            arm_biquad_cascade_df1_q15(&sFilterBiquadInstance, tInputBlock, tOutputBlock, FILTER_BLOCK_SIZE);
+        } else {
+            arm_fir_q15(&sFilterFIRInstance, tInputBlock, tOutputBlock, FILTER_BLOCK_SIZE);
+        }
+
+        int tOutputIndex = tInputIndex - tDelay;
+        for (int i = 0; i < FILTER_BLOCK_SIZE; ++i, ++tOutputIndex) {
+            if (tOutputIndex >= 0 && tOutputIndex < aCount) {
+                // clip undershoot of FIR and IIR
+                int tValue = tOutputBlock[i];
+                if (tValue < 0) {
+                    tValue = 0;
+                }
+                aDestinationPointer[tOutputIndex] = tValue >> FILTER_RAW_TO_Q15_SHIFT;
+            }
+        }
+    }
+}
+
+/**
+ * @param aCount - number of values read by drawDataBuffer() or FFT
+ * @return aDataBufferPointer if filter is off or aCount > FILTER_VIEW_BUFFER_SIZE, else pointer to filtered copy.
+ * Invisible values of pre trigger area at start and end are copied unchanged.
+ */
+uint16_t * getFilteredDataBufferPointer(uint16_t * aDataBufferPointer, int aCount) {
+    if (DisplayControl.FilterType == FILTER_TYPE_NONE || aCount > FILTER_VIEW_BUFFER_SIZE) {
+        return aDataBufferPointer;
+    }
+    int tStart = 0;
+    while (tStart < aCount && aDataBufferPointer[tStart] == DATABUFFER_INVISIBLE_RAW_VALUE) {
+        FilterViewBuffer[tStart++] = DATABUFFER_INVISIBLE_RAW_VALUE;
+    }
+    int tEnd = aCount;
+    while (tEnd > tStart && aDataBufferPointer[tEnd - 1] == DATABUFFER_INVISIBLE_RAW_VALUE) {
+        FilterViewBuffer[--tEnd] = DATABUFFER_INVISIBLE_RAW_VALUE;
+    }
+    if (tEnd > tStart) {
+        filterValues(&aDataBufferPointer[tStart], &FilterViewBuffer[tStart], tEnd - tStart);
+    }
+    return FilterViewBuffer;
+}
+
+/**
+ * Clips aCount values to data buffer, unpacks them to FilterViewBuffer if needed and filters them in place.
+ * @return pointer to aCount linear and filtered values for FFT of stopped data
+ */
+uint16_t * getFFTDataBufferPointer(uint16_t * aDataBufferPointer, int aCount) {
+    if (aDataBufferPointer + aCount > DataBufferControl.DataBufferEndPointer + 1) {
+        // take the last aCount values
+        aDataBufferPointer = (uint16_t *) DataBufferControl.DataBufferEndPointer + 1 - aCount;
+    }
+    if (aDataBufferPointer < &DataBufferControl.DataBuffer[0]) {
+        aDataBufferPointer = &DataBufferControl.DataBuffer[0];
+    }
+    return getFilteredDataBufferPointer(getLinearDataBufferPointer(aDataBufferPointer, FilterViewBuffer, aCount), aCount);
+}
+
+/************************************************************************
+ * Serial decoder section
+ ************************************************************************/
+SerialDecoderStruct SerialDecoder;
+
+/**
+ * Resets frame state and results, takes thresholds from trigger level and hysteresis.
+ * The bit width is kept, but is taken from this screen if the pulses of last screen were all longer than 1.5 bits.
+ */
+void startSerialDecoder(void) {
+    SerialDecoderStruct * tDecoder = &SerialDecoder;
+    if (MeasurementControl.RawTriggerLevel > MeasurementControl.RawTriggerLevelHysteresis) {
+        tDecoder->HighThreshold = MeasurementControl.RawTriggerLevel;
+        tDecoder->LowThreshold = MeasurementControl.RawTriggerLevelHysteresis;
+    } else {
+        tDecoder->HighThreshold = MeasurementControl.RawTriggerLevelHysteresis;
+        tDecoder->LowThreshold = MeasurementControl.RawTriggerLevel;
+    }
+    if (tDecoder->ShortestPulseOfScreen != 0 && tDecoder->ShortestPulseOfScreen > (tDecoder->ShortestPulse * 3) / 2) {
+        // baud rate or timebase changed to slower
+        tDecoder->ShortestPulse = 0;
+        tDecoder->BitWidthShift4 = 0;
+    }
+    tDecoder->ShortestPulseOfScreen = 0;
+    tDecoder->LineStateKnown = false;
+    tDecoder->SampleIndex = 0;
+    tDecoder->LastEdgeIndex = -1;
+    tDecoder->BitIndex = -1;
+    tDecoder->ByteCount = 0;
+}
+
+/*
+ * Adds one pulse to bit width estimation
+ */
+static void addPulseToBitWidth(SerialDecoderStruct * aDecoder, int aPulseLength) {
+    if (aPulseLength < DECODER_MIN_SAMPLES_PER_BIT) {
+        return;
+    }
+    if (aDecoder->ShortestPulseOfScreen == 0 || aPulseLength < aDecoder->ShortestPulseOfScreen) {
+        aDecoder->ShortestPulseOfScreen = aPulseLength;
+    }
+    if (aDecoder->ShortestPulse == 0 || aPulseLength < (aDecoder->ShortestPulse * 3) / 4) {
+        // new shortest pulse -> start new estimation
+        aDecoder->ShortestPulse = aPulseLength;
+        aDecoder->PulseSamplesSum = 0;
+        aDecoder->PulseBitsSum = 0;
+        aDecoder->BitWidthShift4 = aPulseLength << 4;
+    }
+    // round to number of bits
+    int tBits = ((aPulseLength << 4) + (aDecoder->BitWidthShift4 / 2)) / aDecoder->BitWidthShift4;
+    if (tBits > DECODER_MAX_BITS_PER_PULSE) {
+        return;
+    }
+    if (aDecoder->PulseBitsSum > 1000) {
+        // keep sums in range and let new values have more weight
+        aDecoder->PulseSamplesSum >>= 1;
+        aDecoder->PulseBitsSum >>= 1;
+    }
+    aDecoder->PulseSamplesSum += aPulseLength;
+    aDecoder->PulseBitsSum += tBits;
+    // average over all pulses gives sub sample resolution
+    aDecoder->BitWidthShift4 = (aDecoder->PulseSamplesSum << 4) / aDecoder->PulseBitsSum;
+}
+
+/**
+ * Processes next value of the stream
+ * @return true if a byte was completed
+ */
+bool decodeSerialValue(uint16_t aRawValue) {
+    SerialDecoderStruct * tDecoder = &SerialDecoder;
+    int tSampleIndex = tDecoder->SampleIndex++;
+    if (aRawValue == DATABUFFER_INVISIBLE_RAW_VALUE) {
+        return false;
+    }
+    if (!tDecoder->LineStateKnown) {
+        // first visible value
+        tDecoder->LineStateKnown = true;
+        tDecoder->LineIsHigh = (aRawValue > tDecoder->LowThreshold);
+    }
+
+    /*
+     * Bit level with hysteresis
+     */
+    bool tFallingEdge = false;
+    bool tEdge = false;
+    if (tDecoder->LineIsHigh) {
+        if (aRawValue < tDecoder->LowThreshold) {
+            tDecoder->LineIsHigh = false;
+            tFallingEdge = true;
+            tEdge = true;
+        }
+    } else if (aRawValue > tDecoder->HighThreshold) {
+        tDecoder->LineIsHigh = true;
+        tEdge = true;
+    }
+    if (tEdge) {
+        if (tDecoder->LastEdgeIndex >= 0) {
+            addPulseToBitWidth(tDecoder, tSampleIndex - tDecoder->LastEdgeIndex);
+        }
+        tDecoder->LastEdgeIndex = tSampleIndex;
+    }
+
+    /*
+     * Frame level - sample in the middle of each bit
+     */
+    if (tDecoder->BitIndex < 0) {
+        if (tFallingEdge && tDecoder->BitWidthShift4 >= (DECODER_MIN_SAMPLES_PER_BIT << 4)) {
+            tDecoder->BitIndex = 0;
+            tDecoder->FrameStartIndex = tSampleIndex;
+            tDecoder->NextBitIndexShift4 = (tSampleIndex << 4) + (tDecoder->BitWidthShift4 / 2);
+        }
+        return false;
+    }
+    if ((tSampleIndex << 4) < tDecoder->NextBitIndexShift4) {
+        return false;
+    }
+    tDecoder->NextBitIndexShift4 += tDecoder->BitWidthShift4;
+    if (tDecoder->BitIndex == 0) {
+        if (tDecoder->LineIsHigh) {
+            // glitch, no start bit
+            tDecoder->BitIndex = -1;
+            return false;
+        }
+    } else if (tDecoder->BitIndex <= 8) {
+        // LSB first
+        tDecoder->ShiftRegister >>= 1;
+        if (tDecoder->LineIsHigh) {
+            tDecoder->ShiftRegister |= 0x80;
+        }
+    } else {
+        // stop bit
+        tDecoder->BitIndex = -1;
+        if (tDecoder->ByteCount >= DECODER_MAX_BYTES) {
+            return false;
+        }
+        tDecoder->Bytes[tDecoder->ByteCount] = tDecoder->ShiftRegister;
+        tDecoder->BytePositions[tDecoder->ByteCount] = tDecoder->FrameStartIndex;
+        tDecoder->FrameError[tDecoder->ByteCount] = !tDecoder->LineIsHigh;
+        tDecoder->ByteCount++;
+        return true;
+    }
+    tDecoder->BitIndex++;
+    return false;
+}
+
+/**
+ * Decodes a whole screen in one linear pass.
+ * Only if bit width was not known at start, a second pass is done with the bit width found by the first one.
+ */
+void decodeSerialValues(uint16_t * aDataBufferPointer, int aCount) {
+    startSerialDecoder();
+    bool tBitWidthWasUnknown = (SerialDecoder.ShortestPulse == 0);
+    for (int i = 0; i < aCount; ++i) {
+        decodeSerialValue(aDataBufferPointer[i]);
+    }
+    if (tBitWidthWasUnknown && SerialDecoder.ShortestPulse != 0) {
+        startSerialDecoder();
+        for (int i = 0; i < aCount; ++i) {
+            decodeSerialValue(aDataBufferPointer[i]);
+        }
+    }
+}
+
+/************************************************************************
+ * Equivalent time sampling section
+ ************************************************************************/
+EquivalentTimeStruct EquivalentTime;
+
+void resetEquivalentTime(void) {
+    for (int i = 0; i < DSO_DISPLAY_WIDTH; ++i) {
+        EquivalentTime.ReconstructionBuffer[i] = DATABUFFER_INVISIBLE_RAW_VALUE;
+    }
+    EquivalentTime.ValidCount = 0;
+}
+
+/**
+ * Places the samples of the last acquisition around the trigger in the reconstruction buffer.
+ * Must be called before the next acquisition is started.
+ * Uses the trigger position of the DMA acquisition, which is DatabufferPreTriggerDisplaySize after DataBufferDisplayStart for XScale 0.
+ */
+void foldEquivalentTimeSamples(void) {
+    EquivalentTime.AcquisitionCount++;
+    if (MeasurementControl.TriggerMode == TRIGGER_MODE_OFF || MeasurementControl.TriggerStatus != TRIGGER_OK) {
+        return;
+    }
+    int tPreTriggerPixel = DisplayControl.DatabufferPreTriggerDisplaySize;
+    // first value behind trigger level
+    uint16_t * tTriggerPointer = DataBufferControl.DataBufferDisplayStart + tPreTriggerPixel;
+    if (tTriggerPointer <= &DataBufferControl.DataBuffer[0]) {
+        return;
+    }
+    int tValueBefore = tTriggerPointer[-1];
+    int tDelta = *tTriggerPointer - tValueBefore;
+    if (tDelta == 0) {
+        return;
+    }
+    // position of trigger crossing between the 2 samples in 1/256 sample
+    int tCrossingFractionShift8 = ((MeasurementControl.RawTriggerLevel - tValueBefore) << 8) / tDelta;
+    if (tCrossingFractionShift8 < 0) {
+        tCrossingFractionShift8 = 0;
+    } else if (tCrossingFractionShift8 > 0xFF) {
+        tCrossingFractionShift8 = 0xFF;
+    }
+
+    // samples before and behind trigger, which fall into display
+    int tFirstIndex = -(tPreTriggerPixel / EQUIVALENT_TIME_PIXEL_PER_SAMPLE) - 1;
+    int tLastIndex = (DSO_DISPLAY_WIDTH - tPreTriggerPixel) / EQUIVALENT_TIME_PIXEL_PER_SAMPLE + 1;
+    for (int i = tFirstIndex; i <= tLastIndex; ++i) {
+        uint16_t * tSamplePointer = tTriggerPointer - 1 + i;
+        if (tSamplePointer < &DataBufferControl.DataBuffer[0] || tSamplePointer > DataBufferControl.DataBufferEndPointer) {
+            continue;
+        }
+        // time of sample relative to trigger crossing in pixel, rounded
+        int tX = tPreTriggerPixel
+                + ((((i << 8) - tCrossingFractionShift8) * EQUIVALENT_TIME_PIXEL_PER_SAMPLE + 0x80) >> 8);
+        if (tX >= 0 && tX < DSO_DISPLAY_WIDTH) {
+            EquivalentTime.ReconstructionBuffer[tX] = *tSamplePointer;
+            EquivalentTime.SampleAge[tX] = EquivalentTime.AcquisitionCount;
+        }
+    }
+}
+
+/**
+ * Copies the valid samples of the reconstruction buffer and interpolates linear between them.
+ * Pixel before the first and after the last valid sample are invisible.
+ */
+void getEquivalentTimeValues(uint16_t * aDestinationPointer) {
+    int tLastValidX = -1;
+    int tValidCount = 0;
+    for (int x = 0; x < DSO_DISPLAY_WIDTH; ++x) {
+        uint16_t tValue = EquivalentTime.ReconstructionBuffer[x];
+        aDestinationPointer[x] = DATABUFFER_INVISIBLE_RAW_VALUE;
+        if (tValue == DATABUFFER_INVISIBLE_RAW_VALUE
+                || (uint8_t) (EquivalentTime.AcquisitionCount - EquivalentTime.SampleAge[x]) >= EQUIVALENT_TIME_MAX_AGE) {
+            continue;
+        }
+        tValidCount++;
+        aDestinationPointer[x] = tValue;
+        if (tLastValidX >= 0 && x - tLastValidX > 1) {
+            // fill gap
+            int tLastValue = aDestinationPointer[tLastValidX];
+            int tGap = x - tLastValidX;
+            for (int i = 1; i < tGap; ++i) {
+                aDestinationPointer[tLastValidX + i] = tLastValue + (((int) tValue - tLastValue) * i) / tGap;
+            }
+        }
+        tLastValidX = x;
+    }
+    EquivalentTime.ValidCount = tValidCount;
+}
+
+/************************************************************************
+ * Mask test section
+ ************************************************************************/
+MaskTestStruct MaskTest;
+const uint8_t MaskToleranceDisplayValues[MASK_TEST_TOLERANCE_NUMBER] = { 0, 4, 8, 16 };
+
+/**
+ * Builds the limits from the displayed region of the stopped capture and resets the counters.
+ * Limits are raw values, so they do not depend on display range and offset.
+ * @param aToleranceIndex index into MaskToleranceDisplayValues, MASK_TEST_TOLERANCE_OFF switches mask test off
+ */
+void initMaskTest(uint8_t aToleranceIndex) {
+    MaskTest.ToleranceIndex = aToleranceIndex;
+    MaskTest.PassCount = 0;
+    MaskTest.FailCount = 0;
+    MaskTest.FirstFailureIndex = -1;
+    if (aToleranceIndex == MASK_TEST_TOLERANCE_OFF) {
+        return;
+    }
+    MaskTest.InputRangeIndex = DataBufferControl.InputRangeIndexUsed;
+    MaskTest.TimebaseIndex = MeasurementControl.TimebaseIndex;
+    int tTolerance = MaskToleranceDisplayValues[aToleranceIndex];
+
+    uint16_t * tReferencePointer = getLinearDataBufferPointer(DataBufferControl.DataBufferDisplayStart, FourDisplayLinesBuffer,
+            DSO_DISPLAY_WIDTH);
+    for (int i = 0; i < DSO_DISPLAY_WIDTH; ++i) {
+        // min and max display value of sample and its neighbors to allow 1 sample jitter
+        int tMinDisplayValue = DISPLAYBUFFER_INVISIBLE_VALUE;
+        int tMaxDisplayValue = -1;
+        for (int j = i - 1; j <= i + 1; ++j) {
+            if (j >= 0 && j < DSO_DISPLAY_WIDTH && tReferencePointer[j] != DATABUFFER_INVISIBLE_RAW_VALUE) {
+                int tDisplayValue = RawToDisplayTable[tReferencePointer[j]];
+                if (tDisplayValue < tMinDisplayValue) {
+                    tMinDisplayValue = tDisplayValue;
+                }
+                if (tDisplayValue > tMaxDisplayValue) {
+                    tMaxDisplayValue = tDisplayValue;
+                }
+            }
+        }
+        // no reference or limit outside display -> no limit
+        MaskTest.RawUpperLimit[i] = 0xFFFF;
+        MaskTest.RawLowerLimit[i] = 0;
+        if (tMaxDisplayValue >= 0) {
+            // small display value means high voltage
+            tMinDisplayValue -= tTolerance;
+            tMaxDisplayValue += tTolerance;
+            if (tMinDisplayValue > 0) {
+                MaskTest.RawUpperLimit[i] = getInputRawFromDisplayValue(tMinDisplayValue);
+            }
+            if (tMaxDisplayValue < DISPLAY_VALUE_FOR_ZERO) {
+                MaskTest.RawLowerLimit[i] = getInputRawFromDisplayValue(tMaxDisplayValue);
+            }
+        }
+    }
+}
+
+/**
+ * Checks DSO_DISPLAY_WIDTH values against the limits and counts the result.
+ * The loop has no branches, the first failure is searched only for failed acquisitions.
+ * Acquisitions with other input range or timebase than the reference are not checked.
+ * @return false if any value is outside the limits
+ */
+bool checkMask(uint16_t * aDataBufferPointer) {
+    if (DisplayDataBufferControl.InputRangeIndexUsed != MaskTest.InputRangeIndex
+            || MeasurementControl.TimebaseIndex != MaskTest.TimebaseIndex) {
+        return true;
+    }
+    unsigned int tFailures = 0;
+    for (int i = 0; i < DSO_DISPLAY_WIDTH; ++i) {
+        unsigned int tValue = aDataBufferPointer[i];
+        tFailures |= (tValue > MaskTest.RawUpperLimit[i]) | (tValue < MaskTest.RawLowerLimit[i]);
+    }
+    if (tFailures == 0) {
+        MaskTest.PassCount++;
+        return true;
+    }
+    MaskTest.FailCount++;
+    for (int i = 0; i < DSO_DISPLAY_WIDTH; ++i) {
+        if (aDataBufferPointer[i] > MaskTest.RawUpperLimit[i] || aDataBufferPointer[i] < MaskTest.RawLowerLimit[i]) {
+            MaskTest.FirstFailureIndex = i;
+            break;
+        }
+    }
+    return false;
+}
+
+/************************************************************************
+ * Autoset section
+ ************************************************************************/
+
+/**
+ * Computes min, max, average and period of the whole autoset capture.
+ * The period is taken from the rising crossings of the middle value with a hysteresis of 1/8 peak to peak.
+ * Sets MeasurementControl.RawValueMin, Max and Average as well as AutosetInfo.PeriodSamples and CrossingCount.
+ */
+void analyzeAutosetCapture(void) {
+    uint16_t * tDataBufferPointer = &DataBufferControl.DataBuffer[0];
+    int tCount = (uint16_t *) DataBufferControl.DataBufferEndPointer + 1 - tDataBufferPointer;
+    uint16_t tMin = 0xFFFF;
+    uint16_t tMax = 0;
+    uint32_t tSum = 0;
+    for (int i = 0; i < tCount; ++i) {
+        uint16_t tValue = tDataBufferPointer[i];
+        if (tValue > tMax) {
+            tMax = tValue;
+        }
+        if (tValue < tMin) {
+            tMin = tValue;
+        }
+        tSum += tValue;
+    }
+    MeasurementControl.RawValueMin = tMin;
+    MeasurementControl.RawValueMax = tMax;
+    MeasurementControl.RawValueAverage = (tSum + (tCount / 2)) / tCount;
+
+    int tPeakToPeak = tMax - tMin;
+    int tLowerThreshold = tMin + (tPeakToPeak / 2) - (tPeakToPeak / 8);
+    int tUpperThreshold = tMin + (tPeakToPeak / 2) + (tPeakToPeak / 8);
+    bool tIsBelow = false;
+    int tCrossingCount = 0;
+    int tFirstCrossingIndex = 0;
+    int tLastCrossingIndex = 0;
+    for (int i = 0; i < tCount; ++i) {
+        uint16_t tValue = tDataBufferPointer[i];
+        if (tValue < tLowerThreshold) {
+            tIsBelow = true;
+        } else if (tIsBelow && tValue > tUpperThreshold) {
+            tIsBelow = false;
+            if (tCrossingCount == 0) {
+                tFirstCrossingIndex = i;
+            }
+            tLastCrossingIndex = i;
+            tCrossingCount++;
+        }
+    }
+    AutosetInfo.CrossingCount = tCrossingCount;
+    AutosetInfo.PeriodSamples = 0;
+    if (tPeakToPeak >= AUTOSET_MIN_PEAK_TO_PEAK && tCrossingCount > 2) {
+        // at least 2 entire periods
+        AutosetInfo.PeriodSamples = (tLastCrossingIndex - tFirstCrossingIndex) / (tCrossingCount - 1);
+    }
+}
+
+static uint16_t convertRawValueForAutoset(int aRawValue, int aZeroValue, float aFactor) {
+    int tValue = ((aRawValue - aZeroValue) * aFactor) + aZeroValue;
+    if (tValue < 0) {
+        tValue = 0;
+    } else if (tValue > ADC_MAX_CONVERSION_VALUE) {
+        tValue = ADC_MAX_CONVERSION_VALUE;
+    }
+    return tValue;
+}
+
+/**
+ * Sets input range for min and max of the last autoset capture in one step.
+ * Unlike computeAutoInputRange() there is no delay for switching to a higher resolution,
+ * but the same 80% margin is used, so that the automatic range of the running loop does not switch back.
+ * Min, max and average are converted to the new range for the following computations.
+ * @return true if range was not changed
+ */
+bool setAutosetInputRange(void) {
+    int tOldRangeIndex = MeasurementControl.InputRangeIndex;
+    int tNewRangeIndex = tOldRangeIndex + 1;
+    int tZeroValue = 0;
+    if (MeasurementControl.isACMode) {
+        tZeroValue = MeasurementControl.RawDSOReadingACZero;
+    }
+    if (MeasurementControl.RawValueMax != ADC_MAX_CONVERSION_VALUE
+            && !(MeasurementControl.isACMode && MeasurementControl.RawValueMin == 0)) {
+        // no clipping -> get virtual peak to peak value like computeAutoInputRange()
+        int tPeakToPeak = MeasurementControl.RawValueMax;
+        if (MeasurementControl.isACMode) {
+            tPeakToPeak = tZeroValue - MeasurementControl.RawValueMin;
+            if (MeasurementControl.RawValueMax - tZeroValue > tPeakToPeak) {
+                tPeakToPeak = MeasurementControl.RawValueMax - tZeroValue;
+            }
+            tPeakToPeak *= 2;
+        }
+        tPeakToPeak = ((tPeakToPeak * 10) / 8) * RawAttenuationFactor[tOldRangeIndex];
+        for (tNewRangeIndex = 0; tNewRangeIndex < NUMBER_OF_RANGES - 1; ++tNewRangeIndex) {
+            if (tPeakToPeak <= MaxPeakToPeakValue[tNewRangeIndex]) {
+                break;
+            }
+        }
+    }
+    if (!isAttenuatorAvailable) {
+        if (tNewRangeIndex > NO_ATTENUATOR_MAX_RANGE_INDEX) {
+            tNewRangeIndex = NO_ATTENUATOR_MAX_RANGE_INDEX;
+        } else if (tNewRangeIndex < NO_ATTENUATOR_MIN_RANGE_INDEX) {
+            tNewRangeIndex = NO_ATTENUATOR_MIN_RANGE_INDEX;
+        }
+    }
+    MeasurementControl.TimestampLastRangeChange = getMillisSinceBoot();
+    if (!changeInputRange(tNewRangeIndex - tOldRangeIndex)) {
+        return true;
+    }
+
+    // convert values to new range
+    float tFactor = RawAttenuationFactor[tOldRangeIndex] / RawAttenuationFactor[tNewRangeIndex];
+    MeasurementControl.RawValueMin = convertRawValueForAutoset(MeasurementControl.RawValueMin, tZeroValue, tFactor);
+    MeasurementControl.RawValueMax = convertRawValueForAutoset(MeasurementControl.RawValueMax, tZeroValue, tFactor);
+    MeasurementControl.RawValueAverage = convertRawValueForAutoset(MeasurementControl.RawValueAverage, tZeroValue, tFactor);
+    return false;
+}
+
+/**
+ * Computes timebase for the period of the last autoset capture.
+ * If no period could be found in the capture of the actual timebase, a coarse step to a very fast
+ * or a very slow timebase is returned, whose capture then gives the period.
+ * @return new timebase index in range 1 to AUTOSET_TIMEBASE_INDEX_SLOW
+ */
+int computeAutosetTimebaseIndex(void) {
+    int tTimebaseIndex = MeasurementControl.TimebaseIndex;
+    int tPeakToPeak = MeasurementControl.RawValueMax - MeasurementControl.RawValueMin;
+    if (AutosetInfo.PeriodSamples == 0) {
+        if (tPeakToPeak >= AUTOSET_MIN_PEAK_TO_PEAK && AutosetInfo.CrossingCount <= 2
+                && tTimebaseIndex < AUTOSET_TIMEBASE_INDEX_SLOW) {
+            // less than 2 periods in buffer
+            return AUTOSET_TIMEBASE_INDEX_SLOW;
+        }
+        // DC or no reasonable signal -> keep timebase
+        return tTimebaseIndex;
+    }
+    if (AutosetInfo.PeriodSamples < AUTOSET_MIN_SAMPLES_PER_PERIOD && tTimebaseIndex > AUTOSET_TIMEBASE_INDEX_FAST) {
+        // period may be aliased
+        return AUTOSET_TIMEBASE_INDEX_FAST;
+    }
+
+    float tPeriodMicros = (AutosetInfo.PeriodSamples * getTimebaseExactValueMicros(tTimebaseIndex)) / TIMING_GRID_WIDTH;
+    /*
+     * find fastest timebase which shows AUTOSET_PERIODS_PER_SCREEN periods
+     */
+    int tNewTimebaseIndex;
+    for (tNewTimebaseIndex = 1; tNewTimebaseIndex < AUTOSET_TIMEBASE_INDEX_SLOW; ++tNewTimebaseIndex) {
+        float tDivMicros = getTimebaseExactValueMicros(tNewTimebaseIndex);
+        if (tNewTimebaseIndex < TIMEBASE_NUMBER_OF_XSCALE_CORRECTION) {
+            tDivMicros /= xScaleForTimebase[tNewTimebaseIndex];
+        }
+        if (tDivMicros * (DSO_DISPLAY_WIDTH / TIMING_GRID_WIDTH) >= tPeriodMicros * AUTOSET_PERIODS_PER_SCREEN) {
+            break;
+        }
+    }
+    return tNewTimebaseIndex;
+}
+
+/**
+ * Sets display range, offset and trigger level for min and max of the last autoset capture
+ */
+void setAutosetOffsetAndTrigger(void) {
+    if (MeasurementControl.OffsetMode == OFFSET_MODE_AUTOMATIC) {
+        // start with input range, computeAutoDisplayRange() then magnifies
+        setDisplayRange(MeasurementControl.InputRangeIndex, true);
+        computeAutoDisplayRange();
+        computeAutoOffset();
+    }
+    int tPeakToPeak = MeasurementControl.RawValueMax - MeasurementControl.RawValueMin;
+    if (MeasurementControl.TriggerMode == TRIGGER_MODE_AUTOMATIC) {
+        setTriggerLevelAndHysteresis(MeasurementControl.RawValueMin + (tPeakToPeak / 2), tPeakToPeak / 4);
+    } else if (MeasurementControl.TriggerMode == TRIGGER_MODE_MANUAL) {
+        setTriggerLevelAndHysteresis(MeasurementControl.RawValueMin + (tPeakToPeak / 2), TRIGGER_HYSTERESIS_MANUAL);
+    }
+}
+
+/************************************************************************
+ * Acquisition statistics section
+ ************************************************************************/
+
+/**
+ * enables the cycle counter of the core which is used to measure the ISR cycles
+ */
+void initAcquisitionStatistics(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    AcquisitionInfo.isBenchmarkActive = false;
+    resetAcquisitionStatistics();
+}
+
+/**
+ * starts a new measurement interval
+ */
+void resetAcquisitionStatistics(void) {
+    AcquisitionInfo.StartMillis = getMillisSinceBoot();
+    AcquisitionInfo.AcquisitionCount = 0;
+    AcquisitionInfo.TriggerTimeoutCount = 0;
+    AcquisitionInfo.ISRCycles = 0;
+    AcquisitionInfo.ISRSampleCount = 0;
+    AcquisitionInfo.StatisticsCycles = 0;
+    AcquisitionInfo.StatisticsSampleCount = 0;
+}
+
+/**
+ * called by main loop for each full data buffer
+ */
+void countAcquisitionForStatistics(void) {
+    AcquisitionInfo.AcquisitionCount++;
+    if (MeasurementControl.TriggerMode != TRIGGER_MODE_OFF && MeasurementControl.TriggerStatus != TRIGGER_OK) {
+        AcquisitionInfo.TriggerTimeoutCount++;
+    }
+}
+
+/**
+ * computes acquisitions per second, trigger hit rate and cycles per sample for the actual measurement interval
+ */
+void computeAcquisitionStatistics(AcquisitionBenchmarkResultStruct * aResult) {
+    uint32_t tMillis = getMillisSinceBoot() - AcquisitionInfo.StartMillis;
+    aResult->AcquisitionsPerSecond = 0;
+    aResult->TriggerHitPercent = 0;
+    aResult->CyclesPerSample = 0;
+    if (tMillis != 0) {
+        aResult->AcquisitionsPerSecond = (AcquisitionInfo.AcquisitionCount * 1000.0) / tMillis;
+    }
+    if (AcquisitionInfo.AcquisitionCount != 0) {
+        aResult->TriggerHitPercent = ((AcquisitionInfo.AcquisitionCount - AcquisitionInfo.TriggerTimeoutCount) * 100)
+                / AcquisitionInfo.AcquisitionCount;
+    }
+    if (AcquisitionInfo.ISRSampleCount != 0) {
+        uint32_t tCycles = AcquisitionInfo.ISRCycles / AcquisitionInfo.ISRSampleCount;
+        if (tCycles > 0xFFFF) {
+            tCycles = 0xFFFF;
+        }
+        aResult->CyclesPerSample = tCycles;
+    }
+    aResult->StatisticsCyclesPerSample = 0;
+    if (AcquisitionInfo.StatisticsSampleCount != 0) {
+        aResult->StatisticsCyclesPerSample = AcquisitionInfo.StatisticsCycles / AcquisitionInfo.StatisticsSampleCount;
+    }
+}
@@ -28,6 +28,8 @@
  */
 //Line colors
 #define COLOR_MAX_MIN_LINE COLOR_GREEN
+#define COLOR_MASK_LIMITS COLOR_CYAN
+#define COLOR_PERSISTENCE_HISTOGRAM COLOR_GREEN
 #define COLOR_HOR_REF_LINE_LABEL COLOR_BLUE
 #define COLOR_HOR_REF_LINE_LABEL_NEGATIVE COLOR_RED
 #define COLOR_TRIGGER_LINE RGB(0xFF,0x00,0xFF)
@@ -62,6 +64,11 @@ const uint8_t RangePrecision[NUMBER_OF_RANGES] = { 2, 2, 2, 1, 1, 1, 0, 0, 0, 0,
  */
 int ScaleFactorRawToDisplayShift18[NUMBER_OF_RANGES];
 int FactorFromInputToDisplayRangeShift12 = 1 << DSO_INPUT_TO_DISPLAY_SHIFT; // is (attenuation for input range / attenuation for display range)
+/*
+ * Display value for each raw value - one load per drawn sample instead of the computation in computeDisplayFromRawInputValue()
+ * Last entry is for DATABUFFER_INVISIBLE_RAW_VALUE
+ */
+uint8_t RawToDisplayTable[DATABUFFER_INVISIBLE_RAW_VALUE + 1];
 
 float actualDSORawToVoltFactor;
 
@@ -92,6 +99,7 @@ void initRawToDisplayFactors(void) {
     ScaleFactorRawToDisplayShift18[2] = sADCScaleFactorShift18 * (RawAttenuationFactor[2] / (2 * ScaleVoltagePerDiv[2])); // 0,05
     ScaleFactorRawToDisplayShift18[1] = sADCScaleFactorShift18 * (RawAttenuationFactor[1] / (2 * ScaleVoltagePerDiv[1])); // 0,02
     ScaleFactorRawToDisplayShift18[0] = sADCScaleFactorShift18 * (RawAttenuationFactor[0] / (2 * ScaleVoltagePerDiv[0])); // 0,01
+    initRawToDisplayTable();
 }
 
 /************************************************************************
@@ -193,122 +201,352 @@ void drawMinMaxLines(void) {
         BlueDisplay1.drawLineRel(0, tValueDisplay, DSO_DISPLAY_WIDTH, 0, COLOR_MAX_MIN_LINE);
     }
 }
-/**
- * Draws data on screen
- * @param aDataBufferPointer Data is taken from DataBufferPointer.
- *             If DataBufferPointer is NULL, then Data is taken from DisplayBuffer - used for erasing display before switching mode
- * @param aLength
- * @param aColor Draw color. - used for different colors for pretrigger data or different modes
- * @param aClearBeforeColor if > 0 data from DisplayBuffer is drawn(erased) with this color
- *              just before to avoid interfering with display refresh timing. - Color is used for history modes.
- *              DataBufferPointer must not be null then!
- * @note if aClearBeforeColor >0 then DataBufferPointer must not be NULL
- * @note NOT used for drawing while acquiring
+/*
+ * draws lower and upper limit of mask test - x position is sample index
  */
-void drawDataBuffer(uint16_t *aDataBufferPointer, int aLength, uint16_t aColor, uint16_t aClearBeforeColor) {
-    int i;
-    int j = 0;
-    int tValue;
-
-    int tLastValue;
-    int tLastValueClear = DisplayBuffer[0];
+void drawMaskLimits(void) {
+    if (MaskTest.ToleranceIndex == MASK_TEST_TOLERANCE_OFF) {
+        return;
+    }
+    for (int x = 0; x < DSO_DISPLAY_WIDTH; ++x) {
+        if (MaskTest.RawUpperLimit[x] < DATABUFFER_INVISIBLE_RAW_VALUE) {
+            BlueDisplay1.drawPixel(x, RawToDisplayTable[MaskTest.RawUpperLimit[x]], COLOR_MASK_LIMITS);
+        }
+        if (MaskTest.RawLowerLimit[x] != 0) {
+            BlueDisplay1.drawPixel(x, RawToDisplayTable[MaskTest.RawLowerLimit[x]], COLOR_MASK_LIMITS);
+        }
+    }
+}
 
-    uint8_t *ScreenBufferReadPointer = &DisplayBuffer[0];
-    uint8_t *ScreenBufferWritePointer1 = &DisplayBuffer[0];
-    uint8_t *ScreenBufferWritePointer2 = &DisplayBuffer2[0]; // for trigger state line
-    int tXScale = DisplayControl.XScale;
-    int tXScaleCounter = tXScale;
-    int tTriggerValue = getDisplayFrowRawInputValue(MeasurementControl.RawTriggerLevel);
-    if (tXScale <= 0) {
-        tXScaleCounter = -tXScale;
+/*
+ * X scale classes of drawDataBuffer() - each has its own specialized fill function
+ */
+#define XSCALE_CLASS_IDENTITY 0
+#define XSCALE_CLASS_EXPAND_1_5 1 // every second value will be shown 2 times
+#define XSCALE_CLASS_EXPAND 2 // show value several times
+#define XSCALE_CLASS_COMPRESS_1_5 3 // every second value is the average of the next two values
+#define XSCALE_CLASS_COMPRESS 4 // min and max envelope of multiple values
+#define NUMBER_OF_XSCALE_CLASSES 5
+
+static int getXScaleClass(int aXScale) {
+    if (aXScale == 0) {
+        return XSCALE_CLASS_IDENTITY;
+    } else if (aXScale == 1) {
+        return XSCALE_CLASS_EXPAND_1_5;
+    } else if (aXScale > 1) {
+        return XSCALE_CLASS_EXPAND;
+    } else if (aXScale == -1) {
+        return XSCALE_CLASS_COMPRESS_1_5;
     }
+    return XSCALE_CLASS_COMPRESS;
+}
 
-    for (i = 0; i < aLength; ++i) {
-        if (aDataBufferPointer == NULL) {
-            // get data from screen buffer in order to erase it
-            tValue = *ScreenBufferReadPointer++;
-        } else {
-            tValue = getDisplayFrowRawInputValue(*aDataBufferPointer);
+/**
+ * Converts raw values to display values and performs X scaling.
+ * The XScaleClass checks are resolved at compile time, so the loop contains only the code for one scale class.
+ */
+template<int XScaleClass>
+static void fillDisplayBuffer(uint16_t * aDataBufferPointer, uint8_t * aDisplayBuffer, int aLength, int aXScale) {
+    int tXScaleCounter = aXScale;
+    if (aXScale <= 0) {
+        tXScaleCounter = -aXScale;
+    }
+    int tSecondValue = DISPLAYBUFFER_INVISIBLE_VALUE; // for envelope
+    for (int i = 0; i < aLength; ++i) {
+        int tValue;
+        if (XScaleClass == XSCALE_CLASS_IDENTITY) {
+            tValue = RawToDisplayTable[*aDataBufferPointer++];
+        } else if (XScaleClass == XSCALE_CLASS_COMPRESS) {
             /*
-             * get data from data buffer and perform X scaling
+             * Envelope instead of average, which hides spikes.
+             * Min and max of the values of 2 columns are stored in time order like peak detect pairs,
+             * so the line between these columns spans all values. Invisible values are skipped.
              */
-            if (tXScale == 0) {
-                aDataBufferPointer++;
-            } else if (tXScale < -1) {
-                // compress - get average of multiple values
-                tValue = getDisplayFrowMultipleRawValues(aDataBufferPointer, tXScaleCounter);
-                aDataBufferPointer += tXScaleCounter;
-            } else if (tXScale == -1) {
-                // compress by factor 1.5 - every second value is the average of the next two values
-                aDataBufferPointer++;
-                tXScaleCounter--;
-                if (tXScaleCounter < 0) {
-                    if (tValue != DISPLAYBUFFER_INVISIBLE_VALUE) {
-                        // get average of actual and next value
-                        tValue += getDisplayFrowRawInputValue(*aDataBufferPointer++);
-                        tValue /= 2;
+            if ((i & 0x01) == 0) {
+                unsigned int tMin = DATABUFFER_INVISIBLE_RAW_VALUE;
+                unsigned int tMax = 0;
+                bool tMinIsLast = false;
+                for (int j = 2 * tXScaleCounter; j > 0; --j) {
+                    unsigned int tRawValue = *aDataBufferPointer++;
+                    if (tRawValue == DATABUFFER_INVISIBLE_RAW_VALUE) {
+                        continue;
+                    }
+                    if (tRawValue < tMin) {
+                        tMin = tRawValue;
+                        tMinIsLast = true;
+                    }
+                    if (tRawValue >= tMax) {
+                        tMax = tRawValue;
+                        tMinIsLast = false;
                     }
-                    tXScaleCounter = 1;
                 }
-            } else if (tXScale == 1) {
-                aDataBufferPointer++;
-                // expand by factor 1.5 - every second value will be shown 2 times
-                tXScaleCounter--; // starts with 1
-                if (tXScaleCounter < 0) {
-                    aDataBufferPointer--;
-                    tXScaleCounter = 2;
+                if (tMin == DATABUFFER_INVISIBLE_RAW_VALUE) {
+                    // only invisible values
+                    tMax = DATABUFFER_INVISIBLE_RAW_VALUE;
+                }
+                if (tMinIsLast) {
+                    tValue = RawToDisplayTable[tMax];
+                    tSecondValue = RawToDisplayTable[tMin];
+                } else {
+                    tValue = RawToDisplayTable[tMin];
+                    tSecondValue = RawToDisplayTable[tMax];
                 }
             } else {
-                // expand - show value several times
-                if (tXScaleCounter == 0) {
-                    aDataBufferPointer++;
-                    tXScaleCounter = tXScale;
+                tValue = tSecondValue;
+            }
+        } else if (XScaleClass == XSCALE_CLASS_COMPRESS_1_5) {
+            tValue = RawToDisplayTable[*aDataBufferPointer++];
+            tXScaleCounter--;
+            if (tXScaleCounter < 0) {
+                if (tValue != DISPLAYBUFFER_INVISIBLE_VALUE) {
+                    // get average of actual and next value
+                    tValue += RawToDisplayTable[*aDataBufferPointer++];
+                    tValue /= 2;
                 }
-                tXScaleCounter--;
+                tXScaleCounter = 1;
+            }
+        } else if (XScaleClass == XSCALE_CLASS_EXPAND_1_5) {
+            tValue = RawToDisplayTable[*aDataBufferPointer++];
+            tXScaleCounter--; // starts with 1
+            if (tXScaleCounter < 0) {
+                aDataBufferPointer--;
+                tXScaleCounter = 2;
+            }
+        } else {
+            tValue = RawToDisplayTable[*aDataBufferPointer];
+            if (tXScaleCounter == 0) {
+                aDataBufferPointer++;
+                tXScaleCounter = aXScale;
             }
+            tXScaleCounter--;
         }
+        *aDisplayBuffer++ = tValue;
+    }
+}
 
-        // draw trigger state line (aka Digital mode)
-        if (DisplayControl.DisplayBufferDrawMode & DRAW_MODE_TRIGGER) {
-#ifdef LOCAL_DISPLAY_EXISTS
-            if (aClearBeforeColor > 0) {
-                LocalDisplay.drawPixel(i, *ScreenBufferWritePointer2, aClearBeforeColor);
+/*
+ * Min/max pyramid of the display values of a stopped acquisition for compressed X scales.
+ * Level 0 holds min and max of aligned blocks of 4 values, each next level of blocks of double size.
+ * So the envelope of a column pair needs only a few pyramid entries instead of all values behind it,
+ * and zooming and scrolling of stopped data costs nearly the same for all compress factors.
+ * Built on first use after stop, invalidated by a new acquisition, a new raw to display mapping
+ * or by the persistence grid and the waterfall image, which share its buffer.
+ */
+#define MIN_MAX_PYRAMID_LEVELS 3
+#define MIN_MAX_PYRAMID_BASE_SHIFT 2 // level 0 block size is 4
+#define MIN_MAX_PYRAMID_SIZE ((DATABUFFER_SIZE >> MIN_MAX_PYRAMID_BASE_SHIFT) + (DATABUFFER_SIZE >> (MIN_MAX_PYRAMID_BASE_SHIFT + 1)) \
+        + (DATABUFFER_SIZE >> (MIN_MAX_PYRAMID_BASE_SHIFT + 2)))
+struct MinMaxStruct {
+    uint8_t Min; // DISPLAYBUFFER_INVISIBLE_VALUE if block has only invisible values
+    uint8_t Max; // 0 if block has only invisible values
+};
+
+/*
+ * The persistence grid, the waterfall image and the min/max pyramid are never used at the same time,
+ * so they share one buffer of 8000 bytes in the uninitialized CCM RAM section .ccmbss.
+ * The waterfall image and the pyramid alone would take 7 kB of the 40 kB RAM.
+ * Persistence is folded only on the pages of a running acquisition except the waterfall page,
+ * waterfall rows are added only on the waterfall page and the pyramid is only used for stopped data.
+ * Every write to the grid or the image invalidates the pyramid, the grid is cleared at start and on leaving the waterfall page
+ * and the image is reset on entering the waterfall page.
+ * DisplayValues is the temporary copy of the display values for drawDataBuffer(), accumulatePersistence() and drawRollModeValues(),
+ * which would otherwise take 320 bytes of the 1 kB stack.
+ */
+static struct {
+    union {
+        uint8_t PersistenceGrid[DSO_DISPLAY_WIDTH][PERSISTENCE_ROWS / 2]; // 2 cells per byte, low nibble is the even row
+        uint8_t FFTWaterfall[FFT_WATERFALL_ROWS][FFT_WATERFALL_BINS];
+        MinMaxStruct MinMaxPyramid[MIN_MAX_PYRAMID_SIZE];
+    };
+    uint8_t DisplayValues[DSO_DISPLAY_WIDTH];
+} DisplayScratch __attribute__((section(".ccmbss")));
+static const uint16_t MinMaxPyramidLevelStart[MIN_MAX_PYRAMID_LEVELS] = { 0, DATABUFFER_SIZE >> MIN_MAX_PYRAMID_BASE_SHIFT,
+        (DATABUFFER_SIZE >> MIN_MAX_PYRAMID_BASE_SHIFT) + (DATABUFFER_SIZE >> (MIN_MAX_PYRAMID_BASE_SHIFT + 1)) };
+static bool sMinMaxPyramidValid = false;
+
+void invalidateMinMaxPyramid(void) {
+    sMinMaxPyramidValid = false;
+}
+
+/**
+ * app. 150 us
+ */
+static void buildMinMaxPyramid(void) {
+    // level 0 from data buffer
+    uint16_t * tDataBufferPointer = &DataBufferControl.DataBuffer[0];
+    MinMaxStruct * tEntryPointer = &DisplayScratch.MinMaxPyramid[0];
+    for (int i = DATABUFFER_SIZE >> MIN_MAX_PYRAMID_BASE_SHIFT; i > 0; --i) {
+        uint8_t tMin = DISPLAYBUFFER_INVISIBLE_VALUE;
+        uint8_t tMax = 0;
+        for (int j = 1 << MIN_MAX_PYRAMID_BASE_SHIFT; j > 0; --j) {
+            uint8_t tValue = RawToDisplayTable[*tDataBufferPointer++];
+            if (tValue != DISPLAYBUFFER_INVISIBLE_VALUE) {
+                if (tValue < tMin) {
+                    tMin = tValue;
+                }
+                if (tValue > tMax) {
+                    tMax = tValue;
+                }
             }
+        }
+        tEntryPointer->Min = tMin;
+        tEntryPointer->Max = tMax;
+        tEntryPointer++;
+    }
+    // higher levels from the level below
+    MinMaxStruct * tSourcePointer = &DisplayScratch.MinMaxPyramid[0];
+    for (int tLevel = 1; tLevel < MIN_MAX_PYRAMID_LEVELS; ++tLevel) {
+        for (int i = DATABUFFER_SIZE >> (MIN_MAX_PYRAMID_BASE_SHIFT + tLevel); i > 0; --i) {
+            MinMaxStruct tFirst = *tSourcePointer++;
+            MinMaxStruct tSecond = *tSourcePointer++;
+            tEntryPointer->Min = (tFirst.Min < tSecond.Min) ? tFirst.Min : tSecond.Min;
+            tEntryPointer->Max = (tFirst.Max > tSecond.Max) ? tFirst.Max : tSecond.Max;
+            tEntryPointer++;
+        }
+    }
+    sMinMaxPyramidValid = true;
+}
+
+/**
+ * Gets min and max display value of aCount values starting at DataBuffer[aIndex]
+ * by using the biggest aligned pyramid blocks and single values only at the unaligned ends
+ */
+static void getMinMaxFromPyramid(int aIndex, int aCount, uint8_t * aMin, uint8_t * aMax) {
+    int tEndIndex = aIndex + aCount;
+    uint8_t tMin = DISPLAYBUFFER_INVISIBLE_VALUE;
+    uint8_t tMax = 0;
+    while (aIndex < tEndIndex) {
+        int tBlockSize = 1 << MIN_MAX_PYRAMID_BASE_SHIFT;
+        if ((aIndex & (tBlockSize - 1)) == 0 && aIndex + tBlockSize <= tEndIndex) {
+            int tLevel = 0;
+            while (tLevel < MIN_MAX_PYRAMID_LEVELS - 1 && (aIndex & ((2 * tBlockSize) - 1)) == 0
+                    && aIndex + (2 * tBlockSize) <= tEndIndex) {
+                tLevel++;
+                tBlockSize *= 2;
+            }
+            MinMaxStruct * tEntryPointer = &DisplayScratch.MinMaxPyramid[MinMaxPyramidLevelStart[tLevel]
+                    + (aIndex >> (MIN_MAX_PYRAMID_BASE_SHIFT + tLevel))];
+            if (tEntryPointer->Min < tMin) {
+                tMin = tEntryPointer->Min;
+            }
+            if (tEntryPointer->Max > tMax) {
+                tMax = tEntryPointer->Max;
+            }
+            aIndex += tBlockSize;
+        } else {
+            uint8_t tValue = RawToDisplayTable[DataBufferControl.DataBuffer[aIndex]];
+            if (tValue != DISPLAYBUFFER_INVISIBLE_VALUE) {
+                if (tValue < tMin) {
+                    tMin = tValue;
+                }
+                if (tValue > tMax) {
+                    tMax = tValue;
+                }
+            }
+            aIndex++;
+        }
+    }
+    if (tMin == DISPLAYBUFFER_INVISIBLE_VALUE) {
+        // only invisible values
+        tMax = DISPLAYBUFFER_INVISIBLE_VALUE;
+    }
+    *aMin = tMin;
+    *aMax = tMax;
+}
+
+/**
+ * Envelope for XSCALE_CLASS_COMPRESS from the min/max pyramid of stopped data.
+ * Same pairs as fillDisplayBuffer<XSCALE_CLASS_COMPRESS>(), but without time order.
+ * The extreme nearer to the last value is taken first to get short connecting lines.
+ */
+static void fillDisplayBufferFromPyramid(uint16_t * aDataBufferPointer, uint8_t * aDisplayBuffer, int aLength, int aXScale) {
+    int tCount = -2 * aXScale; // values per column pair
+    int tIndex = aDataBufferPointer - &DataBufferControl.DataBuffer[0];
+    int tLastValue = DISPLAYBUFFER_INVISIBLE_VALUE;
+    for (int i = 0; i < aLength; i += 2) {
+        uint8_t tMin, tMax;
+        getMinMaxFromPyramid(tIndex, tCount, &tMin, &tMax);
+        tIndex += tCount;
+        if (tLastValue != DISPLAYBUFFER_INVISIBLE_VALUE && (tLastValue - tMin) > (tMax - tLastValue)) {
+            // last value is nearer to max
+            uint8_t tTemp = tMin;
+            tMin = tMax;
+            tMax = tTemp;
+        }
+        *aDisplayBuffer++ = tMin;
+        if (i + 1 < aLength) {
+            *aDisplayBuffer++ = tMax;
+        }
+        tLastValue = tMax;
+    }
+}
+
+typedef void (*FillDisplayBufferFunction)(uint16_t * aDataBufferPointer, uint8_t * aDisplayBuffer, int aLength, int aXScale);
+// index is XSCALE_CLASS_*
+static const FillDisplayBufferFunction FillDisplayBufferFunctions[NUMBER_OF_XSCALE_CLASSES] = {
+        &fillDisplayBuffer<XSCALE_CLASS_IDENTITY>, &fillDisplayBuffer<XSCALE_CLASS_EXPAND_1_5>,
+        &fillDisplayBuffer<XSCALE_CLASS_EXPAND>, &fillDisplayBuffer<XSCALE_CLASS_COMPRESS_1_5>,
+        &fillDisplayBuffer<XSCALE_CLASS_COMPRESS> };
+
+/*
+ * draw trigger state line (aka Digital mode)
+ */
+static void drawTriggerStateLine(uint8_t * aDisplayValues, int aLength, uint16_t aClearBeforeColor) {
+    int tTriggerValue = getDisplayFrowRawInputValue(MeasurementControl.RawTriggerLevel);
+    uint8_t *ScreenBufferWritePointer2 = &DisplayBuffer2[0];
+    for (int i = 0; i < aLength; ++i) {
+#ifdef LOCAL_DISPLAY_EXISTS
+        if (aClearBeforeColor > 0) {
+            LocalDisplay.drawPixel(i, *ScreenBufferWritePointer2, aClearBeforeColor);
+        }
 #endif
-            if (tValue > tTriggerValue) {
+        if (*aDisplayValues++ > tTriggerValue) {
 #ifdef LOCAL_DISPLAY_EXISTS
-                LocalDisplay.drawPixel(i, tTriggerValue - TRIGGER_HIGH_DISPLAY_OFFSET, COLOR_DATA_TRIGGER);
+            LocalDisplay.drawPixel(i, tTriggerValue - TRIGGER_HIGH_DISPLAY_OFFSET, COLOR_DATA_TRIGGER);
 #endif
-                *ScreenBufferWritePointer2++ = tTriggerValue - TRIGGER_HIGH_DISPLAY_OFFSET;
-            }
+            *ScreenBufferWritePointer2++ = tTriggerValue - TRIGGER_HIGH_DISPLAY_OFFSET;
         }
+    }
+}
+
+#ifdef LOCAL_DISPLAY_EXISTS
+/**
+ * Draws the display values on the local display. The DrawLine and ClearBefore checks are resolved at compile time.
+ * @param aDisplayValues new values
+ * @param aRestoreGrid draw grid pixel instead of value at grid positions - used for erasing the chart
+ * @note the old values to clear are read from DisplayBuffer, so aDisplayValues must not be DisplayBuffer if ClearBefore is true
+ */
+template<bool DrawLine, bool ClearBefore>
+static void drawDisplayValues(uint8_t * aDisplayValues, int aLength, uint16_t aColor, uint16_t aClearBeforeColor,
+        bool aRestoreGrid) {
+    int j = 0;
+    int tLastValue = DISPLAYBUFFER_INVISIBLE_VALUE;
+    int tLastValueClear = DisplayBuffer[0];
+    uint8_t *ScreenBufferReadPointer = &DisplayBuffer[0];
 
-        if (!(DisplayControl.DisplayBufferDrawMode & DRAW_MODE_LINE) || i == 0) {
+    for (int i = 0; i < aLength; ++i) {
+        int tValue = *aDisplayValues++;
+        if (!DrawLine || i == 0) {
             /*
              * Pixel Mode or first value of chart
              */
-            if (aDataBufferPointer == NULL && j == TIMING_GRID_WIDTH) {
+            if (aRestoreGrid && j == TIMING_GRID_WIDTH) {
                 // Restore grid pixel instead of clearing it
                 j = 0;
-#ifdef LOCAL_DISPLAY_EXISTS
                 if (tValue != DISPLAYBUFFER_INVISIBLE_VALUE) {
                     LocalDisplay.drawPixel(i, tValue, COLOR_GRID_LINES);
                 }
-#endif
             } else {
                 j++;
-                if (aClearBeforeColor > 0) {
+                if (ClearBefore) {
                     int tValueClear = *ScreenBufferReadPointer++;
-#ifdef LOCAL_DISPLAY_EXISTS
                     if (tValueClear != DISPLAYBUFFER_INVISIBLE_VALUE) {
                         LocalDisplay.drawPixel(i, tValueClear, aClearBeforeColor);
                     }
-#endif
-                    if (DisplayControl.DisplayBufferDrawMode & DRAW_MODE_LINE) {
+                    if (DrawLine) {
                         // erase first line in advance and set pointer
                         tLastValueClear = tValueClear;
                         tValueClear = *ScreenBufferReadPointer++;
-#ifdef LOCAL_DISPLAY_EXISTS
                         if (tValueClear != DISPLAYBUFFER_INVISIBLE_VALUE) {
                             if (tLastValueClear != DISPLAYBUFFER_INVISIBLE_VALUE) {
                                 // Normal mode - clear line
@@ -318,36 +556,25 @@ void drawDataBuffer(uint16_t *aDataBufferPointer, int aLength, uint16_t aColor,
                                 LocalDisplay.drawPixel(i, tValueClear, aClearBeforeColor);
                             }
                         }
-#endif
                         tLastValueClear = tValueClear;
                     }
                 }
-#ifdef LOCAL_DISPLAY_EXISTS
                 if (tValue != DISPLAYBUFFER_INVISIBLE_VALUE) {
                     LocalDisplay.drawPixel(i, tValue, aColor);
                 }
-#endif
             }
         } else {
             /*
              * Line mode here
              */
-            if (aClearBeforeColor > 0 && i != DSO_DISPLAY_WIDTH - 1) {
+            if (ClearBefore && i != DSO_DISPLAY_WIDTH - 1) {
                 // erase one x value in advance in order not to overwrite the x+1 part of line just drawn before
                 int tValueClear = *ScreenBufferReadPointer++;
-#ifdef LOCAL_DISPLAY_EXISTS
                 if (tLastValueClear != DISPLAYBUFFER_INVISIBLE_VALUE && tValueClear != DISPLAYBUFFER_INVISIBLE_VALUE) {
                     LocalDisplay.drawLineFastOneX(i, tLastValueClear, tValueClear, aClearBeforeColor);
                 }
-#endif
                 tLastValueClear = tValueClear;
             }
-#ifdef LOCAL_DISPLAY_EXISTS
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wpragmas"
-#pragma GCC diagnostic ignored "-Wuninitialized"
-#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
-            // is initialized on i == 0
             if (tValue != DISPLAYBUFFER_INVISIBLE_VALUE) {
                 if (tLastValue != DISPLAYBUFFER_INVISIBLE_VALUE) {
                     // Normal mode - draw line
@@ -362,17 +589,269 @@ void drawDataBuffer(uint16_t *aDataBufferPointer, int aLength, uint16_t aColor,
                     LocalDisplay.drawPixel(i, tValue, aColor);
                 }
             }
-#pragma GCC diagnostic pop
-#endif
         }
         tLastValue = tValue;
+    }
+}
+
+typedef void (*DrawDisplayValuesFunction)(uint8_t * aDisplayValues, int aLength, uint16_t aColor, uint16_t aClearBeforeColor,
+        bool aRestoreGrid);
+// index is (DrawLine * 2) + ClearBefore
+static const DrawDisplayValuesFunction DrawDisplayValuesFunctions[4] = { &drawDisplayValues<false, false>, &drawDisplayValues<
+        false, true>, &drawDisplayValues<true, false>, &drawDisplayValues<true, true> };
+#endif
+
+/**
+ * Draws data on screen
+ * The specialized fill and draw functions for the actual X scale and draw mode are chosen once per call,
+ * so the per column loops contain no mode checks.
+ * @param aDataBufferPointer Data is taken from DataBufferPointer.
+ *             If DataBufferPointer is NULL, then Data is taken from DisplayBuffer - used for erasing display before switching mode
+ * @param aLength
+ * @param aColor Draw color. - used for different colors for pretrigger data or different modes
+ * @param aClearBeforeColor if > 0 data from DisplayBuffer is drawn(erased) with this color
+ *              just before to avoid interfering with display refresh timing. - Color is used for history modes.
+ *              DataBufferPointer must not be null then!
+ * @note if aClearBeforeColor >0 then DataBufferPointer must not be NULL
+ * @note NOT used for drawing while acquiring
+ */
+void drawDataBuffer(uint16_t *aDataBufferPointer, int aLength, uint16_t aColor, uint16_t aClearBeforeColor) {
+    uint8_t * tDisplayValues = &DisplayBuffer[0];
+#ifdef LOCAL_DISPLAY_EXISTS
+    // old values in DisplayBuffer are needed for clearing
+    if (aClearBeforeColor > 0 && aDataBufferPointer != NULL) {
+        tDisplayValues = &DisplayScratch.DisplayValues[0];
+    }
+#endif
+    if (aDataBufferPointer != NULL) {
+        FillDisplayBufferFunction tFillFunction = FillDisplayBufferFunctions[getXScaleClass(DisplayControl.XScale)];
+        if (DisplayControl.XScale < -1 && !MeasurementControl.isRunning && DataBufferControl.DataBufferFull
+                && !DataBufferControl.isPacked && aDataBufferPointer >= &DataBufferControl.DataBuffer[0]
+                && aDataBufferPointer < &DataBufferControl.DataBuffer[DATABUFFER_SIZE]) {
+            // stopped data - use min/max pyramid
+            if (!sMinMaxPyramidValid) {
+                buildMinMaxPyramid();
+            }
+            tFillFunction = &fillDisplayBufferFromPyramid;
+        }
+        tFillFunction(aDataBufferPointer, tDisplayValues, aLength, DisplayControl.XScale);
+    }
+
+    if (DisplayControl.DisplayBufferDrawMode & DRAW_MODE_TRIGGER) {
+        drawTriggerStateLine(tDisplayValues, aLength, aClearBeforeColor);
+    }
+
+#ifdef LOCAL_DISPLAY_EXISTS
+    // peak detect and envelope min/max pairs must be connected by lines in order to show them as vertical spans
+    bool tDrawLine = (DisplayControl.DisplayBufferDrawMode & DRAW_MODE_LINE) || MeasurementControl.PeakDetectActive
+            || DisplayControl.XScale < -1;
+    DrawDisplayValuesFunctions[(tDrawLine * 2) + (aClearBeforeColor > 0)](tDisplayValues, aLength, aColor, aClearBeforeColor,
+            aDataBufferPointer == NULL);
+    if (tDisplayValues != &DisplayBuffer[0]) {
         // store data in screen buffer
-        *ScreenBufferWritePointer1++ = tValue;
+        memcpy(&DisplayBuffer[0], tDisplayValues, aLength);
     }
+#endif
     // draw on external screen
     if (USART_isBluetoothPaired()) {
         sendUSART5ArgsAndByteBuffer(FUNCTION_TAG_DRAW_CHART, 0, 0, aColor, aClearBeforeColor, 0, &DisplayBuffer[0], aLength);
     }
+
+    if (aDataBufferPointer == NULL) {
+        clearDecodedBytes();
+    } else if (DisplayControl.DisplayBufferDrawMode & DRAW_MODE_DECODE) {
+        int tCount = adjustIntWithScaleFactor(aLength, DisplayControl.XScale);
+        decodeSerialValues(aDataBufferPointer, tCount);
+        clearDecodedBytes();
+        drawDecodedBytes(tCount, 0);
+    }
+}
+
+/*
+ * Persistence
+ * The grid is DisplayScratch.PersistenceGrid in the uninitialized CCM RAM section, it is cleared by clearPersistence().
+ */
+PersistenceInfoStruct PersistenceInfo;
+// color for hit count / 4
+static const uint16_t PersistenceColors[4] = { RGB(0xA0,0xA0,0xFF), COLOR_BLUE, COLOR_MAGENTA, COLOR_RED };
+
+void clearPersistence(void) {
+    invalidateMinMaxPyramid();
+    memset(DisplayScratch.PersistenceGrid, 0, sizeof(DisplayScratch.PersistenceGrid));
+    memset(PersistenceInfo.Histogram, 0, sizeof(PersistenceInfo.Histogram));
+    PersistenceInfo.FramesFolded = 0;
+    PersistenceInfo.DrawCount = 0;
+}
+
+static inline void incrementPersistenceCell(uint8_t * aColumn, int aRow) {
+    uint8_t * tCellPointer = &aColumn[aRow >> 1];
+    if (aRow & 0x01) {
+        if ((*tCellPointer & 0xF0) != (PERSISTENCE_MAX_COUNT << 4)) {
+            *tCellPointer += 0x10;
+        }
+    } else if ((*tCellPointer & 0x0F) != PERSISTENCE_MAX_COUNT) {
+        *tCellPointer += 0x01;
+    }
+}
+
+/**
+ * Folds one acquisition into the grid - no drawing.
+ * Cells between the rows of two adjacent values are incremented too, like the line would be drawn.
+ */
+void accumulatePersistence(uint16_t * aDataBufferPointer) {
+    invalidateMinMaxPyramid();
+    uint8_t * tDisplayValues = &DisplayScratch.DisplayValues[0];
+    FillDisplayBufferFunctions[getXScaleClass(DisplayControl.XScale)](aDataBufferPointer, tDisplayValues, DSO_DISPLAY_WIDTH,
+            DisplayControl.XScale);
+    int tLastRow = -1;
+    for (int x = 0; x < DSO_DISPLAY_WIDTH; ++x) {
+        int tValue = tDisplayValues[x];
+        if (tValue == DISPLAYBUFFER_INVISIBLE_VALUE) {
+            tLastRow = -1;
+            continue;
+        }
+        int tRow = tValue / PERSISTENCE_ROW_HEIGHT;
+        if (tRow >= PERSISTENCE_ROWS) {
+            tRow = PERSISTENCE_ROWS - 1;
+        }
+        PersistenceInfo.Histogram[tRow]++;
+        uint8_t * tColumn = &DisplayScratch.PersistenceGrid[x][0];
+        if (tLastRow < 0 || tLastRow == tRow) {
+            incrementPersistenceCell(tColumn, tRow);
+        } else {
+            // rows from last to actual value without the row of last value
+            int tStep = (tRow > tLastRow) ? 1 : -1;
+            for (int tSpanRow = tLastRow + tStep; tSpanRow != tRow + tStep; tSpanRow += tStep) {
+                incrementPersistenceCell(tColumn, tSpanRow);
+            }
+        }
+        tLastRow = tRow;
+    }
+    PersistenceInfo.FramesFolded++;
+}
+
+/**
+ * Draws all cells with hit count > 0 and the voltage histogram of the frames folded since last draw.
+ * Decay decrements all counts, so a cell is cleared when its count changes from 1 to 0.
+ */
+void drawPersistence(void) {
+    PersistenceInfo.LastDrawMillis = getMillisSinceBoot();
+    bool tDoDecay = false;
+    if (++PersistenceInfo.DrawCount >= PERSISTENCE_DECAY_DRAWS) {
+        PersistenceInfo.DrawCount = 0;
+        tDoDecay = true;
+    }
+    // histogram area
+    BlueDisplay1.fillRectRel(DSO_DISPLAY_WIDTH - PERSISTENCE_HISTOGRAM_WIDTH, 0, PERSISTENCE_HISTOGRAM_WIDTH, DSO_DISPLAY_HEIGHT,
+            COLOR_BACKGROUND_DSO);
+
+    for (int x = 0; x < DSO_DISPLAY_WIDTH; ++x) {
+        uint8_t * tCellPointer = &DisplayScratch.PersistenceGrid[x][0];
+        for (int tRow = 0; tRow < PERSISTENCE_ROWS; tRow += 2) {
+            uint8_t tCells = *tCellPointer;
+            if (tCells == 0) {
+                tCellPointer++;
+                continue;
+            }
+            if (tDoDecay) {
+                // decrement both nibbles if not zero
+                uint8_t tDecayedCells = tCells;
+                if (tCells & 0x0F) {
+                    tDecayedCells -= 0x01;
+                }
+                if (tCells & 0xF0) {
+                    tDecayedCells -= 0x10;
+                }
+                *tCellPointer = tDecayedCells;
+            }
+            for (int i = 0; i < 2; ++i) {
+                int tCount = (*tCellPointer >> (i * 4)) & 0x0F;
+                int tOldCount = (tCells >> (i * 4)) & 0x0F;
+                uint16_t tY = (tRow + i) * PERSISTENCE_ROW_HEIGHT;
+                if (tCount != 0) {
+                    BlueDisplay1.fillRectRel(x, tY, 1, PERSISTENCE_ROW_HEIGHT, PersistenceColors[tCount >> 2]);
+                } else if (tOldCount != 0) {
+                    BlueDisplay1.fillRectRel(x, tY, 1, PERSISTENCE_ROW_HEIGHT, COLOR_BACKGROUND_DSO);
+                }
+            }
+            tCellPointer++;
+        }
+    }
+
+    // histogram bars from right border
+    uint16_t tMaxCount = 1;
+    for (int tRow = 0; tRow < PERSISTENCE_ROWS; ++tRow) {
+        if (PersistenceInfo.Histogram[tRow] > tMaxCount) {
+            tMaxCount = PersistenceInfo.Histogram[tRow];
+        }
+    }
+    for (int tRow = 0; tRow < PERSISTENCE_ROWS; ++tRow) {
+        int tLength = (PersistenceInfo.Histogram[tRow] * PERSISTENCE_HISTOGRAM_WIDTH) / tMaxCount;
+        if (tLength > 0) {
+            BlueDisplay1.fillRectRel(DSO_DISPLAY_WIDTH - tLength, tRow * PERSISTENCE_ROW_HEIGHT, tLength,
+                    PERSISTENCE_ROW_HEIGHT - 1, COLOR_PERSISTENCE_HISTOGRAM);
+        }
+    }
+    memset(PersistenceInfo.Histogram, 0, sizeof(PersistenceInfo.Histogram));
+    PersistenceInfo.FramesFolded = 0;
+}
+
+/*
+ * Serial decoder overlay - bytes are printed as hex above the trigger state line at the position of their start bit
+ */
+#define DECODER_TEXT_WIDTH (2 * TEXT_SIZE_11_WIDTH + 2)
+static uint16_t sDecodedBytesDrawnX[DECODER_MAX_BYTES];
+static uint8_t sDecodedBytesDrawn[DECODER_MAX_BYTES];
+static uint8_t sDecodedBytesDrawnCount = 0;
+static uint16_t sDecodedBytesDrawnY;
+
+static void drawHexByte(uint16_t aX, uint16_t aY, uint8_t aByte, uint16_t aColor) {
+    static const char tHexDigits[] = "0123456789ABCDEF";
+    char tString[3];
+    tString[0] = tHexDigits[aByte >> 4];
+    tString[1] = tHexDigits[aByte & 0x0F];
+    tString[2] = '\0';
+    BlueDisplay1.drawText(aX, aY, tString, TEXT_SIZE_11, aColor, COLOR_NO_BACKGROUND);
+}
+
+/**
+ * Draws bytes from SerialDecoder starting at aStartByteIndex. Bytes overlapping the last drawn one are skipped.
+ * @param aSamplesPerScreen number of decoded samples spanning the display width
+ */
+void drawDecodedBytes(int aSamplesPerScreen, int aStartByteIndex) {
+    if (sDecodedBytesDrawnCount == 0) {
+        int tY = getDisplayFrowRawInputValue(MeasurementControl.RawTriggerLevel) - TRIGGER_HIGH_DISPLAY_OFFSET - 1;
+        if (tY < TEXT_SIZE_11_ASCEND) {
+            tY = TEXT_SIZE_11_ASCEND;
+        }
+        sDecodedBytesDrawnY = tY;
+    }
+    for (int i = aStartByteIndex; i < SerialDecoder.ByteCount; ++i) {
+        int tX = (SerialDecoder.BytePositions[i] * DSO_DISPLAY_WIDTH) / aSamplesPerScreen;
+        if (tX > DSO_DISPLAY_WIDTH - DECODER_TEXT_WIDTH) {
+            break;
+        }
+        if (sDecodedBytesDrawnCount > 0 && tX < sDecodedBytesDrawnX[sDecodedBytesDrawnCount - 1] + DECODER_TEXT_WIDTH) {
+            continue;
+        }
+        uint16_t tColor = COLOR_DATA_TRIGGER;
+        if (SerialDecoder.FrameError[i]) {
+            tColor = COLOR_RED;
+        }
+        drawHexByte(tX, sDecodedBytesDrawnY, SerialDecoder.Bytes[i], tColor);
+        sDecodedBytesDrawnX[sDecodedBytesDrawnCount] = tX;
+        sDecodedBytesDrawn[sDecodedBytesDrawnCount++] = SerialDecoder.Bytes[i];
+    }
+}
+
+/**
+ * Erases the bytes drawn by drawDecodedBytes() by drawing them with background color
+ */
+void clearDecodedBytes(void) {
+    for (int i = 0; i < sDecodedBytesDrawnCount; ++i) {
+        drawHexByte(sDecodedBytesDrawnX[i], sDecodedBytesDrawnY, sDecodedBytesDrawn[i], COLOR_BACKGROUND_DSO);
+    }
+    sDecodedBytesDrawnCount = 0;
 }
 
 /**
@@ -380,6 +859,8 @@ void drawDataBuffer(uint16_t *aDataBufferPointer, int aLength, uint16_t aColor,
  * @param aDrawColor
  */
 void drawRemainingDataBufferValues(uint16_t aDrawColor) {
+    // peak detect min/max pairs must be connected by lines in order to show them as vertical spans
+    bool tDrawLine = (DisplayControl.DisplayBufferDrawMode & DRAW_MODE_LINE) || MeasurementControl.PeakDetectActive;
     // needed for last acquisition which uses the whole data buffer
     while (DataBufferControl.DataBufferNextDrawPointer < DataBufferControl.DataBufferNextInPointer
             && DataBufferControl.DataBufferNextDrawPointer <= &DataBufferControl.DataBuffer[DATABUFFER_DISPLAY_END]
@@ -389,7 +870,9 @@ void drawRemainingDataBufferValues(uint16_t aDrawColor) {
         if (DataBufferControl.DataBufferNextDrawPointer
                 == &DataBufferControl.DataBuffer[DATABUFFER_PRE_TRIGGER_SIZE + FFT_SIZE - 1]) {
             // now data buffer is filled with more than 256 samples -> show fft
-            draw128FFTValuesFast(COLOR_FFT_DATA, &DataBufferControl.DataBuffer[DATABUFFER_DISPLAY_START]);
+            draw128FFTValuesFast(COLOR_FFT_DATA,
+                    getLinearDataBufferPointer(&DataBufferControl.DataBuffer[DATABUFFER_DISPLAY_START],
+                            &DisplayDataBufferControl.DataBuffer[0], FFT_SIZE));
         }
 
         // wrap around in display buffer
@@ -397,6 +880,11 @@ void drawRemainingDataBufferValues(uint16_t aDrawColor) {
             tDisplayX = 0;
         }
         DataBufferControl.NextDrawXValue = tDisplayX + 1;
+        if (tDisplayX == 0 && (DisplayControl.DisplayBufferDrawMode & DRAW_MODE_DECODE)) {
+            // new sweep
+            clearDecodedBytes();
+            startSerialDecoder();
+        }
 
         uint8_t * tDisplayBufferPointer = &DisplayBuffer[tDisplayX];
         // unsigned is faster
@@ -407,7 +895,7 @@ void drawRemainingDataBufferValues(uint16_t aDrawColor) {
         /*
          * clear old pixel / line
          */
-        if (!(DisplayControl.DisplayBufferDrawMode & DRAW_MODE_LINE)) {
+        if (!tDrawLine) {
             // new values in data buffer => draw one pixel
             // clear pixel or restore grid
             int tColor = DisplayControl.EraseColor;
@@ -436,10 +924,14 @@ void drawRemainingDataBufferValues(uint16_t aDrawColor) {
         /*
          * get new value
          */
-        tValue = getDisplayFrowRawInputValue(*DataBufferControl.DataBufferNextDrawPointer);
+        unsigned int tRawValue = getDataBufferValue((uint16_t *) DataBufferControl.DataBufferNextDrawPointer);
+        tValue = RawToDisplayTable[tRawValue];
         *tDisplayBufferPointer = tValue;
+        if ((DisplayControl.DisplayBufferDrawMode & DRAW_MODE_DECODE) && decodeSerialValue(tRawValue)) {
+            drawDecodedBytes(DSO_DISPLAY_WIDTH, SerialDecoder.ByteCount - 1);
+        }
 
-        if (!(DisplayControl.DisplayBufferDrawMode & DRAW_MODE_LINE)) {
+        if (!tDrawLine) {
             if (tValue != DISPLAYBUFFER_INVISIBLE_VALUE) {
                 //draw new pixel
                 BlueDisplay1.drawPixel(tDisplayX, tValue, aDrawColor);
@@ -463,16 +955,145 @@ void drawRemainingDataBufferValues(uint16_t aDrawColor) {
     }
 }
 
+/*
+ * Draws the line segment from aX to aX + 1 of a display buffer
+ */
+static void drawDisplayBufferSegment(uint8_t * aDisplayBuffer, int aX, uint16_t aColor) {
+    int tValue = aDisplayBuffer[aX];
+    int tNextValue = aDisplayBuffer[aX + 1];
+    if (tNextValue != DISPLAYBUFFER_INVISIBLE_VALUE) {
+        if (tValue != DISPLAYBUFFER_INVISIBLE_VALUE) {
+            BlueDisplay1.drawLineFastOneX(aX, tValue, tNextValue, aColor);
+        } else {
+            // first visible value, draw only end pixel
+            BlueDisplay1.drawPixel(aX + 1, tNextValue, aColor);
+        }
+    }
+}
+
+/**
+ * Roll mode - new values from the ring in DataBuffer enter at the right edge and the existing trace is shifted left.
+ * The chart is not cleared, only columns whose pixel or line segment changed by the shift are erased and redrawn,
+ * so a flat or slowly drifting signal costs only a few draw commands per new sample.
+ */
+void drawRollModeValues(uint16_t aDrawColor) {
+    uint16_t * tNextInPointer = DataBufferControl.DataBufferNextInPointer;
+    if (tNextInPointer >= &DataBufferControl.DataBuffer[DATABUFFER_SIZE]) {
+        tNextInPointer = &DataBufferControl.DataBuffer[0];
+    }
+    int tCount = tNextInPointer - DataBufferControl.DataBufferNextDrawPointer;
+    if (tCount < 0) {
+        tCount += DATABUFFER_SIZE;
+    }
+    if (tCount == 0) {
+        return;
+    }
+    uint16_t * tDataBufferPointer = (uint16_t *) DataBufferControl.DataBufferNextDrawPointer;
+    if (tCount > DSO_DISPLAY_WIDTH) {
+        // more new values than display width -> skip the ones shifted out immediately
+        tDataBufferPointer += tCount - DSO_DISPLAY_WIDTH;
+        if (tDataBufferPointer >= &DataBufferControl.DataBuffer[DATABUFFER_SIZE]) {
+            tDataBufferPointer -= DATABUFFER_SIZE;
+        }
+        tCount = DSO_DISPLAY_WIDTH;
+    }
+
+    uint8_t * tOldDisplayBuffer = &DisplayScratch.DisplayValues[0];
+    memcpy(tOldDisplayBuffer, DisplayBuffer, sizeof(DisplayBuffer));
+    // shift and append new values
+    memmove(&DisplayBuffer[0], &DisplayBuffer[tCount], DSO_DISPLAY_WIDTH - tCount);
+    for (int i = DSO_DISPLAY_WIDTH - tCount; i < DSO_DISPLAY_WIDTH; ++i) {
+        DisplayBuffer[i] = RawToDisplayTable[*tDataBufferPointer++];
+        if (tDataBufferPointer >= &DataBufferControl.DataBuffer[DATABUFFER_SIZE]) {
+            tDataBufferPointer = &DataBufferControl.DataBuffer[0];
+        }
+    }
+    DataBufferControl.DataBufferNextDrawPointer = tDataBufferPointer;
+
+    if (!((DisplayControl.DisplayBufferDrawMode & DRAW_MODE_LINE) || MeasurementControl.PeakDetectActive)) {
+        for (int x = 0; x < DSO_DISPLAY_WIDTH; ++x) {
+            int tOldValue = tOldDisplayBuffer[x];
+            int tValue = DisplayBuffer[x];
+            if (tOldValue != tValue) {
+                // clear pixel or restore grid
+                if (tOldValue != DISPLAYBUFFER_INVISIBLE_VALUE) {
+                    int tColor = DisplayControl.EraseColor;
+                    if (x % TIMING_GRID_WIDTH == TIMING_GRID_WIDTH - 1) {
+                        tColor = COLOR_GRID_LINES;
+                    }
+                    BlueDisplay1.drawPixel(x, tOldValue, tColor);
+                }
+                if (tValue != DISPLAYBUFFER_INVISIBLE_VALUE) {
+                    BlueDisplay1.drawPixel(x, tValue, aDrawColor);
+                }
+            }
+        }
+        return;
+    }
+
+    /*
+     * Line mode - segment x connects x and x + 1.
+     * First erase all changed segments, then draw changed segments and their neighbors,
+     * since erasing a segment also clears the shared end pixels of its neighbors.
+     */
+    for (int x = 0; x < DSO_DISPLAY_WIDTH - 1; ++x) {
+        if (tOldDisplayBuffer[x] != DisplayBuffer[x] || tOldDisplayBuffer[x + 1] != DisplayBuffer[x + 1]) {
+            drawDisplayBufferSegment(tOldDisplayBuffer, x, DisplayControl.EraseColor);
+        }
+    }
+    bool tLastSegmentChanged = false;
+    for (int x = 0; x < DSO_DISPLAY_WIDTH - 1; ++x) {
+        bool tSegmentChanged = (tOldDisplayBuffer[x] != DisplayBuffer[x] || tOldDisplayBuffer[x + 1] != DisplayBuffer[x + 1]);
+        bool tNextSegmentChanged = (x < DSO_DISPLAY_WIDTH - 2
+                && (tOldDisplayBuffer[x + 1] != DisplayBuffer[x + 1] || tOldDisplayBuffer[x + 2] != DisplayBuffer[x + 2]));
+        if (tLastSegmentChanged || tSegmentChanged || tNextSegmentChanged) {
+            drawDisplayBufferSegment(DisplayBuffer, x, aDrawColor);
+        }
+        tLastSegmentChanged = tSegmentChanged;
+    }
+}
+
 void clearDiplayedChart(void) {
     BlueDisplay1.drawChartByteBuffer(0, 0, COLOR_BACKGROUND_DSO, COLOR_NO_BACKGROUND, &DisplayBuffer[0], sizeof(DisplayBuffer));
 }
 
+/*
+ * 20 * log10(2) = 6.02 dB per log2 step
+ */
+#define FFT_DB_PER_LOG2 6.0206
+/**
+ * Converts FFT values in place to dB relative to aMaxValue with the fast log2 approximation.
+ * Values below -FFT_DB_RANGE are clipped.
+ */
+static void convertFFTValuesToDB(float * aValuePointer, int aCount, float aMaxValue) {
+    // values relative to max are converted to 16 bit integer for getLog2Shift8()
+    float tFactor = 0x10000 / aMaxValue;
+    for (int i = 0; i < aCount; ++i) {
+        uint32_t tValue = *aValuePointer * tFactor;
+        float tDB = -FFT_DB_RANGE;
+        if (tValue > 0) {
+            tDB = (getLog2Shift8(tValue) - (16 << 8)) * (float) (FFT_DB_PER_LOG2 / 256);
+            if (tDB < -FFT_DB_RANGE) {
+                tDB = -FFT_DB_RANGE;
+            }
+        }
+        *aValuePointer++ = tDB;
+    }
+}
+
 void drawFFT(void) {
     // compute and draw FFT
     BlueDisplay1.clearDisplay(COLOR_BACKGROUND_DSO);
-    computeFFT(DataBufferControl.DataBufferDisplayStart, (float32_t*) (FourDisplayLinesBuffer)); // enough space for 640 floats);
+    computeFFT(getFFTDataBufferPointer(DataBufferControl.DataBufferDisplayStart, DisplayControl.FFTSize),
+            (float32_t*) (FourDisplayLinesBuffer), DisplayControl.FFTSize); // enough space for 640 floats);
     // init and draw chart 12 milliseconds with -O0
-    // display with Xscale = 2
+    // display 128 bins with Xscale = 2 or 256 bins with Xscale = 0 - both have the same frequency range
+    int tXScaleFactor = 0;
+    if (FFTInfo.Size == FFT_SIZE) {
+        tXScaleFactor = FFT_DISPLAY_SCALE_FACTOR_X;
+    }
+    // bin spacing relative to FFT_SIZE
+    float tBinFactor = (float) FFT_SIZE / FFTInfo.Size;
     ChartFFT.initChart(4 * TEXT_SIZE_11_WIDTH, DSO_DISPLAY_HEIGHT - 2 * TEXT_SIZE_11_HEIGHT, FFT_SIZE, 32 * 5, 2, true, 64, 32);
     ChartFFT.initChartColors(COLOR_FFT_DATA, COLOR_RED, RGB(0xC0,0xC0,0xC0), COLOR_RED, COLOR_BACKGROUND_DSO);
     // compute Label for x Frequency axis
@@ -485,18 +1106,29 @@ void drawFFT(void) {
         tFreqAtBin32 /= 1000;
         tFreqUnitString[0] = 'k'; // kHz
     }
-    ChartFFT.initXLabelInt(0, tFreqAtBin32 * FFT_DISPLAY_SCALE_FACTOR_X, FFT_DISPLAY_SCALE_FACTOR_X, 5);
+    if (tXScaleFactor != 0) {
+        ChartFFT.initXLabelInt(0, tFreqAtBin32 * tXScaleFactor, tXScaleFactor, 5);
+    } else {
+        ChartFFT.initXLabelInt(0, tFreqAtBin32, 0, 5);
+    }
     ChartFFT.setXTitleText(tFreqUnitString);
-    // display 1.0 for input value of tMaxValue
-    ChartFFT.initYLabelFloat(0, 0.2, 1.0 / FFTInfo.MaxValue, 3, 1);
+    if (DisplayControl.FFTShowDB) {
+        convertFFTValuesToDB((float *) FourDisplayLinesBuffer, FFTInfo.Size / 2, FFTInfo.MaxValue);
+        // 0 dB for tMaxValue at top of chart
+        ChartFFT.initYLabelFloat(-FFT_DB_RANGE, FFT_DB_RANGE / 5, 1.0, 3, 0);
+    } else {
+        // display 1.0 for input value of tMaxValue
+        ChartFFT.initYLabelFloat(0, 0.2, 1.0 / FFTInfo.MaxValue, 3, 1);
+    }
     ChartFFT.drawAxesAndGrid();
     ChartFFT.drawXAxisTitle();
     // show chart
-    ChartFFT.drawChartDataFloat((float *) FourDisplayLinesBuffer, (float *) &FourDisplayLinesBuffer[2 * FFT_SIZE], CHART_MODE_AREA);
+    ChartFFT.drawChartDataFloat((float *) FourDisplayLinesBuffer, (float *) &FourDisplayLinesBuffer[2 * FFTInfo.Size],
+            CHART_MODE_AREA);
     // print max bin frequency information
     // compute frequency of max bin
     tFreqUnitString[0] = ' '; // Hz
-    float tFreqAtMaxBin = FFTInfo.MaxIndex * 125000 / tTimebaseExactValue;
+    float tFreqAtMaxBin = FFTInfo.MaxIndex * tBinFactor * 125000 / tTimebaseExactValue;
     if (tFreqAtMaxBin >= 10000) {
         tFreqAtMaxBin /= 1000;
         tFreqUnitString[0] = 'k'; // Hz
@@ -505,23 +1137,44 @@ void drawFFT(void) {
     BlueDisplay1.drawText(140, 4 * TEXT_SIZE_11_HEIGHT + TEXT_SIZE_22_ASCEND, StringBuffer, TEXT_SIZE_22, COLOR_RED,
             COLOR_BACKGROUND_DSO);
     tFreqUnitString[0] = ' '; // Hz
-    float tFreqDeltaHalf = 62.5 / tTimebaseExactValue; // = tFreqAtBin32 / 64;
+    float tFreqDeltaHalf = tBinFactor * 62.5 / tTimebaseExactValue; // = tFreqAtBin32 / 64 for FFT_SIZE
     snprintf(StringBuffer, sizeof(StringBuffer), "[\xF1%0.1f%s]", tFreqDeltaHalf, tFreqUnitString);
     BlueDisplay1.drawText(140, 6 * TEXT_SIZE_11_HEIGHT + TEXT_SIZE_11_ASCEND, StringBuffer, TEXT_SIZE_11, COLOR_RED,
             COLOR_BACKGROUND_DSO);
 }
 
+/*
+ * Scales a FFT magnitude to 0 to aFullScale - linear or FFT_DB_RANGE dB below max value according to DisplayControl.FFTShowDB
+ * @param aLinearScaleFactorShift16 (aFullScale << 16) / max value
+ * @param aLog2MaxValue getLog2Shift8(max value)
+ */
+static int scaleFFTValue(int aValue, int aFullScale, uint32_t aLinearScaleFactorShift16, int aLog2MaxValue) {
+    if (!DisplayControl.FFTShowDB) {
+        return (aValue * aLinearScaleFactorShift16) >> 16;
+    }
+    if (aValue == 0) {
+        return 0;
+    }
+    // 602 = 100 * FFT_DB_PER_LOG2
+    int tScaledValue = aFullScale
+            + ((getLog2Shift8(aValue) - aLog2MaxValue) * (aFullScale * 602)) / (FFT_DB_RANGE * 100 * 256);
+    if (tScaledValue < 0) {
+        tScaledValue = 0;
+    }
+    return tScaledValue;
+}
+
 /**
  * Draws area chart for fft values. 3 pixel for each value (for a 320 pixel screen)
- * Data is scaled to max = 32 pixel high and drawn at bottom of screen
+ * Data is scaled to max = HORIZONTAL_GRID_HEIGHT pixel high and drawn at bottom of screen
+ * Uses the fixed point FFT, since it runs for every acquisition
  */
 void draw128FFTValuesFast(uint16_t aColor, uint16_t * aDataBufferPointer) {
     if (DisplayControl.ShowFFT) {
-        float *tFFTDataPointer = (float32_t *) FourDisplayLinesBuffer; // enough space for 640 floats
-        computeFFT(DataBufferControl.DataBufferDisplayStart, tFFTDataPointer);
+        // display buffer contains only DSO_DISPLAY_WIDTH values
+        q15_t *tFFTDataPointer = computeFFTQ15(aDataBufferPointer, (q15_t *) FourDisplayLinesBuffer);
 
         uint8_t *tDisplayBufferPtr = &DisplayBufferFFT[0];
-        float tInputValue;
         uint16_t tDisplayY, DisplayYOld;
 
         MeasurementControl.MaxFFTValue = FFTInfo.MaxValue;
@@ -529,15 +1182,19 @@ void draw128FFTValuesFast(uint16_t aColor, uint16_t * aDataBufferPointer) {
         MeasurementControl.FrequencyHertzAtMaxFFTBin = FFTInfo.MaxIndex * 125000
                 / getTimebaseExactValueMicros(MeasurementControl.TimebaseIndex);
 
-        //compute scale factor
-        float tYDisplayScaleFactor = HORIZONTAL_GRID_HEIGHT / FFTInfo.MaxValue;
+        //compute scale factor - shift 16
+        int tMaxValue = tFFTDataPointer[FFTInfo.MaxIndex];
+        if (tMaxValue == 0) {
+            tMaxValue = 1;
+        }
+        uint32_t tYDisplayScaleFactor = (HORIZONTAL_GRID_HEIGHT << 16) / tMaxValue;
+        int tLog2MaxValue = getLog2Shift8(tMaxValue);
         for (int tDisplayX = 0; tDisplayX < DSO_DISPLAY_WIDTH; tDisplayX += 3) {
             /*
              *  get data and perform scaling
              */
-            tInputValue = *tFFTDataPointer++;
-            tDisplayY = tYDisplayScaleFactor * tInputValue;
-            // tDisplayY now from 0 to 32
+            tDisplayY = scaleFFTValue(*tFFTDataPointer++, HORIZONTAL_GRID_HEIGHT, tYDisplayScaleFactor, tLog2MaxValue);
+            // tDisplayY now from 0 to HORIZONTAL_GRID_HEIGHT
             tDisplayY = DSO_DISPLAY_HEIGHT - tDisplayY;
             DisplayYOld = *tDisplayBufferPtr;
             if (tDisplayY < DisplayYOld) {
@@ -552,6 +1209,99 @@ void draw128FFTValuesFast(uint16_t aColor, uint16_t * aDataBufferPointer) {
     }
 }
 
+/************************************************************************
+ * Waterfall section
+ ************************************************************************/
+// the image is DisplayScratch.FFTWaterfall
+static uint8_t sWaterfallNextRow; // row and display slot for the next FFT, the oldest row if ring buffer is full
+static uint8_t sWaterfallRowCount; // valid rows - image grows until FFT_WATERFALL_ROWS
+// black -> blue -> magenta -> red -> yellow for level / 8
+static const uint16_t WaterfallColors[32] = { RGB(0x00,0x00,0x00), RGB(0x00,0x00,0x3C), RGB(0x00,0x00,0x58),
+        RGB(0x00,0x00,0x74), RGB(0x00,0x00,0x90), RGB(0x00,0x00,0xAC), RGB(0x00,0x00,0xC8), RGB(0x00,0x00,0xE4),
+        RGB(0x20,0x00,0xFF), RGB(0x3C,0x00,0xFF), RGB(0x58,0x00,0xFF), RGB(0x74,0x00,0xFF), RGB(0x90,0x00,0xFF),
+        RGB(0xAC,0x00,0xFF), RGB(0xC8,0x00,0xFF), RGB(0xE4,0x00,0xFF), RGB(0xFF,0x00,0xDF), RGB(0xFF,0x00,0xC3),
+        RGB(0xFF,0x00,0xA7), RGB(0xFF,0x00,0x8B), RGB(0xFF,0x00,0x6F), RGB(0xFF,0x00,0x53), RGB(0xFF,0x00,0x37),
+        RGB(0xFF,0x00,0x1B), RGB(0xFF,0x20,0x00), RGB(0xFF,0x3C,0x00), RGB(0xFF,0x58,0x00), RGB(0xFF,0x74,0x00),
+        RGB(0xFF,0x90,0x00), RGB(0xFF,0xAC,0x00), RGB(0xFF,0xC8,0x00), RGB(0xFF,0xE4,0x00) };
+
+void resetWaterfall(void) {
+    sWaterfallNextRow = 0;
+    sWaterfallRowCount = 0;
+}
+
+/*
+ * Each row is drawn at its fixed slot with one setArea burst.
+ * Only available for local display, since remote display has no indexed color image function.
+ */
+static void drawWaterfallRow(int aRow) {
+#ifdef LOCAL_DISPLAY_EXISTS
+    LocalDisplay.drawIndexedLines(0, FFT_WATERFALL_Y_START + (aRow * FFT_WATERFALL_ROW_HEIGHT),
+            &DisplayScratch.FFTWaterfall[aRow][0], FFT_WATERFALL_BINS, 3, FFT_WATERFALL_ROW_HEIGHT, WaterfallColors, 3);
+#endif
+}
+
+/*
+ * marks the slot of the oldest row, where the next row will be drawn
+ */
+static void drawWaterfallMarker(void) {
+    BlueDisplay1.drawLineRel(0, FFT_WATERFALL_Y_START + (sWaterfallNextRow * FFT_WATERFALL_ROW_HEIGHT),
+            (FFT_WATERFALL_BINS * 3) - 1, 0, COLOR_BACKGROUND_DSO);
+}
+
+/**
+ * Draws all valid rows and the frequency labels - for the waterfall page
+ */
+void drawWaterfall(void) {
+    for (int i = 0; i < sWaterfallRowCount; ++i) {
+        drawWaterfallRow(i);
+    }
+    drawWaterfallMarker();
+
+    // frequency of first and last bin - see FrequencyHertzAtMaxFFTBin
+    float tMaxHertz = (FFT_WATERFALL_BINS - 1) * 125000.0 / getTimebaseExactValueMicros(MeasurementControl.TimebaseIndex);
+    uint16_t tYPos = FFT_WATERFALL_Y_START + (FFT_WATERFALL_ROWS * FFT_WATERFALL_ROW_HEIGHT) + 2 + TEXT_SIZE_11_ASCEND;
+    BlueDisplay1.drawText(0, tYPos, "0Hz", TEXT_SIZE_11, COLOR_BLACK, COLOR_BACKGROUND_DSO);
+    int tCount;
+    if (tMaxHertz >= 1000) {
+        tCount = snprintf(StringBuffer, sizeof StringBuffer, "%0.1fkHz", tMaxHertz / 1000);
+    } else {
+        tCount = snprintf(StringBuffer, sizeof StringBuffer, "%0.0fHz", tMaxHertz);
+    }
+    BlueDisplay1.drawText(DSO_DISPLAY_WIDTH - (tCount * TEXT_SIZE_11_WIDTH), tYPos, StringBuffer, TEXT_SIZE_11, COLOR_BLACK,
+            COLOR_BACKGROUND_DSO);
+}
+
+/**
+ * Computes the fixed point FFT and adds its values as a new row to the waterfall.
+ * Only the new row and the marker are drawn, so cost per acquisition is independent of the number of rows.
+ */
+void addFFTWaterfallRow(uint16_t * aDataBufferPointer) {
+    q15_t *tFFTDataPointer = computeFFTQ15(aDataBufferPointer, (q15_t *) FourDisplayLinesBuffer);
+    int tMaxValue = tFFTDataPointer[FFTInfo.MaxIndex];
+    if (tMaxValue == 0) {
+        tMaxValue = 1;
+    }
+    // same scale as the FFT bars, but mapped to 8 bit level
+    uint32_t tScaleFactor = (0xFF << 16) / tMaxValue;
+    int tLog2MaxValue = getLog2Shift8(tMaxValue);
+
+    invalidateMinMaxPyramid();
+    int tRow = sWaterfallNextRow;
+    uint8_t * tRowPointer = &DisplayScratch.FFTWaterfall[tRow][0];
+    for (int i = 0; i < FFT_WATERFALL_BINS; ++i) {
+        *tRowPointer++ = scaleFFTValue(*tFFTDataPointer++, 0xFF, tScaleFactor, tLog2MaxValue);
+    }
+    if (sWaterfallRowCount < FFT_WATERFALL_ROWS) {
+        sWaterfallRowCount++;
+    }
+    sWaterfallNextRow++;
+    if (sWaterfallNextRow >= FFT_WATERFALL_ROWS) {
+        sWaterfallNextRow = 0;
+    }
+    drawWaterfallRow(tRow);
+    drawWaterfallMarker();
+}
+
 void clearFFTValuesOnDisplay(void) {
     uint8_t *tDisplayBufferPtr = &DisplayBufferFFT[0];
     uint16_t DisplayYOld;
@@ -568,7 +1318,19 @@ void clearFFTValuesOnDisplay(void) {
 
 void clearInfo(void) {
     BlueDisplay1.fillRectRel(INFO_LEFT_MARGIN, 0, DSO_DISPLAY_WIDTH,
-            3 * TEXT_SIZE_11_HEIGHT + (INFO_UPPER_MARGIN - TEXT_SIZE_11_ASCEND), COLOR_BACKGROUND_DSO);
+            4 * TEXT_SIZE_11_HEIGHT + (INFO_UPPER_MARGIN - TEXT_SIZE_11_ASCEND), COLOR_BACKGROUND_DSO);
+}
+
+/**
+ * @return unit char for TimebaseDivValues[aTimebaseIndex]
+ */
+char getTimebaseUnitChar(int aTimebaseIndex) {
+    if (aTimebaseIndex >= TIMEBASE_INDEX_MILLIS) {
+        return 'm';
+    } else if (aTimebaseIndex >= TIMEBASE_INDEX_MICROS) {
+        return 0xB5; // micro
+    }
+    return 'n'; // nano
 }
 
 /*
@@ -615,13 +1377,7 @@ void printInfo(void) {
         tPeriodUnitChar = 'm'; // milli
     }
     int tUnitsPerGrid;
-    if (MeasurementControl.TimebaseIndex >= TIMEBASE_INDEX_MILLIS) {
-        tTimebaseUnitChar = 'm';
-    } else if (MeasurementControl.TimebaseIndex >= TIMEBASE_INDEX_MICROS) {
-        tTimebaseUnitChar = 0xB5; // micro
-    } else {
-        tTimebaseUnitChar = 'n'; // nano
-    }
+    tTimebaseUnitChar = getTimebaseUnitChar(MeasurementControl.TimebaseIndex);
     tUnitsPerGrid = TimebaseDivValues[MeasurementControl.TimebaseIndex];
 // number of digits to be printed after the decimal point
     int tPrecision = 3;
@@ -633,7 +1389,8 @@ void printInfo(void) {
     }
 
 // render period + frequency
-    char tBufferForPeriodAndFrequency[20];
+    // also used for the harmonics string of the third line, which needs up to 25 characters
+    char tBufferForPeriodAndFrequency[28];
 
     int tPeriodStringLength = 7;
     int tFreqStringSize = 6;
@@ -735,12 +1492,35 @@ void printInfo(void) {
 
         // Third line
         // Trigger: Slope + Mode + Level + FFT max frequency - Empty space after string is needed for voltage picker value
-        if (DisplayControl.ShowFFT) {
-            snprintf(tBufferForPeriodAndFrequency, sizeof tBufferForPeriodAndFrequency, " %6.0fHz %4.1f",
+        if (DisplayControl.ShowHarmonics) {
+            // amplitude and phase of fundamental + THD
+            if (HarmonicsInfo.Valid) {
+                snprintf(tBufferForPeriodAndFrequency, sizeof tBufferForPeriodAndFrequency, " %5.3fV %4.0f\xF8 %4.1f%%",
+                        HarmonicsInfo.Amplitude[0], HarmonicsInfo.PhaseDegree, HarmonicsInfo.THDPercent);
+            } else {
+                snprintf(tBufferForPeriodAndFrequency, sizeof tBufferForPeriodAndFrequency, " THD   -  ");
+            }
+        } else if (DisplayControl.ShowFFT) {
+            snprintf(tBufferForPeriodAndFrequency, sizeof tBufferForPeriodAndFrequency, " %6.0fHz %5.3f",
                     MeasurementControl.FrequencyHertzAtMaxFFTBin, MeasurementControl.MaxFFTValue);
             if (MeasurementControl.FrequencyHertzAtMaxFFTBin >= 1000) {
                 formatThousandSeparator(&tBufferForPeriodAndFrequency[0], &tBufferForPeriodAndFrequency[3]);
             }
+        } else if (MaskTest.ToleranceIndex != MASK_TEST_TOLERANCE_OFF) {
+            // failed and checked acquisitions of mask test
+            snprintf(tBufferForPeriodAndFrequency, sizeof tBufferForPeriodAndFrequency, " F%lu/%lu", MaskTest.FailCount,
+                    MaskTest.FailCount + MaskTest.PassCount);
+        } else if (MeasurementControl.isRunning && MeasurementControl.TimebaseIndex == TIMEBASE_INDEX_EQUIVALENT_TIME) {
+            // percentage of pixel with valid equivalent time sample
+            snprintf(tBufferForPeriodAndFrequency, sizeof tBufferForPeriodAndFrequency, " ET%3u%%",
+                    (EquivalentTime.ValidCount * 100) / DSO_DISPLAY_WIDTH);
+        } else if (AutosetInfo.MillisToStable != 0) {
+            // time of last autoset
+            uint16_t tMillis = AutosetInfo.MillisToStable;
+            if (tMillis > 9999) {
+                tMillis = 9999;
+            }
+            snprintf(tBufferForPeriodAndFrequency, sizeof tBufferForPeriodAndFrequency, " As%4ums", tMillis);
         } else {
             memset(tBufferForPeriodAndFrequency, ' ', 9);
             tBufferForPeriodAndFrequency[9] = '\0';
@@ -750,6 +1530,19 @@ void printInfo(void) {
         BlueDisplay1.drawText(INFO_LEFT_MARGIN, INFO_UPPER_MARGIN + (2 * TEXT_SIZE_11_HEIGHT), StringBuffer, TEXT_SIZE_11,
                 COLOR_BLACK, COLOR_INFO_BACKGROUND);
 
+        // Fourth line
+        // RMS + positive / negative duty cycle + rise and fall time + overshoot + number of pulses
+        int tNegativeDutyCycle = 0;
+        if (MeasurementControl.DutyCyclePercent != 0) {
+            tNegativeDutyCycle = 100 - MeasurementControl.DutyCyclePercent;
+        }
+        snprintf(StringBuffer, sizeof StringBuffer, "RMS%6.*fV D%2u/%2u%% R%6.1f F%6.1f%cs O%3u%% P%3u", tPrecision,
+                getFloatFromRawValue(MeasurementControl.RawValueRMS), MeasurementControl.DutyCyclePercent, tNegativeDutyCycle,
+                MeasurementControl.RiseMicros, MeasurementControl.FallMicros, 0xB5, MeasurementControl.OvershootPercent,
+                MeasurementControl.PulseCount);
+        BlueDisplay1.drawText(INFO_LEFT_MARGIN, INFO_UPPER_MARGIN + (3 * TEXT_SIZE_11_HEIGHT), StringBuffer, TEXT_SIZE_11,
+                COLOR_BLACK, COLOR_INFO_BACKGROUND);
+
         // Debug infos
 //		char tTriggerTimeoutChar = 0x20; // space
 //		if (MeasurementControl.TriggerStatus < 2) {
@@ -792,6 +1585,45 @@ void printTriggerInfo(void) {
     }
 }
 
+/**
+ * Shows table of acquisitions per second, trigger hit rate and cycles per sample for each timebase of benchmark
+ */
+void drawAcquisitionBenchmarkResults(void) {
+    BlueDisplay1.clearDisplay(COLOR_BACKGROUND_DSO);
+    int tYPos = INFO_UPPER_MARGIN;
+    BlueDisplay1.drawText(INFO_LEFT_MARGIN, tYPos, "Timebase   Acq/s Trigger Cycles/Sample Packed Stat", TEXT_SIZE_11,
+            COLOR_BLACK, COLOR_INFO_BACKGROUND);
+    for (int i = 1; i < BENCHMARK_TIMEBASE_INDEX_END; ++i) {
+        tYPos += TEXT_SIZE_11_HEIGHT;
+        snprintf(StringBuffer, sizeof StringBuffer, "%4u%cs %10.1f %6u%% %8u %11u %4u", TimebaseDivValues[i],
+                getTimebaseUnitChar(i), AcquisitionBenchmarkResults[i].AcquisitionsPerSecond,
+                AcquisitionBenchmarkResults[i].TriggerHitPercent, AcquisitionBenchmarkResults[i].CyclesPerSample,
+                AcquisitionBenchmarkResults[i].PackedCyclesPerSample, AcquisitionBenchmarkResults[i].StatisticsCyclesPerSample);
+        BlueDisplay1.drawText(INFO_LEFT_MARGIN, tYPos, StringBuffer, TEXT_SIZE_11, COLOR_BLACK, COLOR_BACKGROUND_DSO);
+    }
+}
+
+/**
+ * Draws chart of one segment captured in segment mode and its number and trigger time relative to the first segment
+ */
+void drawSegment(int aSegmentIndex) {
+    BlueDisplay1.clearDisplay(COLOR_BACKGROUND_DSO);
+    drawGridLinesWithHorizLabelsAndTriggerLine(COLOR_GRID_LINES);
+    uint16_t * tSegmentStart = &DataBufferControl.DataBuffer[aSegmentIndex * DATABUFFER_SEGMENT_SIZE];
+    if (MeasurementControl.TriggerMode != TRIGGER_MODE_OFF) {
+        tSegmentStart += DATABUFFER_DISPLAY_START;
+    }
+    drawDataBuffer(tSegmentStart, DSO_DISPLAY_WIDTH, COLOR_DATA_HOLD, 0);
+
+    const char * tTimeoutString = "";
+    if (MeasurementControl.TriggerMode != TRIGGER_MODE_OFF && SegmentInfo[aSegmentIndex].TriggerStatus != TRIGGER_OK) {
+        tTimeoutString = " timeout";
+    }
+    snprintf(StringBuffer, sizeof StringBuffer, "Segment %d/%d +%lums%s", aSegmentIndex + 1, DataBufferControl.SegmentIndex + 1,
+            (unsigned long) (SegmentInfo[aSegmentIndex].TriggerMillis - SegmentInfo[0].TriggerMillis), tTimeoutString);
+    BlueDisplay1.drawText(INFO_LEFT_MARGIN, INFO_UPPER_MARGIN, StringBuffer, TEXT_SIZE_11, COLOR_BLACK, COLOR_INFO_BACKGROUND);
+}
+
 /*******************************
  * RAW to display value section
  *******************************/
@@ -800,7 +1632,7 @@ void printTriggerInfo(void) {
  * @param aAdcValue raw ADC value
  * @return Display value (0 to 240-DISPLAY_VALUE_FOR_ZERO) or 0 if raw value to high
  */
-int getDisplayFrowRawInputValue(int aAdcValue) {
+static int computeDisplayFromRawInputValue(int aAdcValue) {
     if (aAdcValue == DATABUFFER_INVISIBLE_RAW_VALUE) {
         return DISPLAYBUFFER_INVISIBLE_VALUE;
     }
@@ -835,18 +1667,26 @@ int getDisplayFrowRawInputValue(int aAdcValue) {
 }
 
 /**
- *
- * @param aAdcValuePtr Data pointer
- * @param aCount number of samples for oversampling
- * @return average of count values from data pointer
+ * Fills RawToDisplayTable with the display values for all raw values including DATABUFFER_INVISIBLE_RAW_VALUE.
+ * Must be called if display range, offset, AC mode or AC zero value changes.
+ * app. 0.6 ms
  */
-int getDisplayFrowMultipleRawValues(uint16_t * aAdcValuePtr, int aCount) {
-//
-    int tAdcValue = 0;
-    for (int i = 0; i < aCount; ++i) {
-        tAdcValue += *aAdcValuePtr++;
+void initRawToDisplayTable(void) {
+    for (int i = 0; i <= DATABUFFER_INVISIBLE_RAW_VALUE; ++i) {
+        RawToDisplayTable[i] = computeDisplayFromRawInputValue(i);
+    }
+    invalidateMinMaxPyramid();
+}
+
+/**
+ * @param aAdcValue raw ADC value
+ * @return Display value (0 to 240-DISPLAY_VALUE_FOR_ZERO) or 0 if raw value to high
+ */
+int getDisplayFrowRawInputValue(int aAdcValue) {
+    if ((unsigned int) aAdcValue <= DATABUFFER_INVISIBLE_RAW_VALUE) {
+        return RawToDisplayTable[aAdcValue];
     }
-    return getDisplayFrowRawInputValue(tAdcValue / aCount);
+    return computeDisplayFromRawInputValue(aAdcValue);
 }
 
 int getRawOffsetValueFromGridCount(int aCount) {
@@ -914,6 +1754,7 @@ void testDSOConversions(void) {
     initRawToDisplayFactors();
     FactorFromInputToDisplayRangeShift12 = (RawAttenuationFactor[MeasurementControl.InputRangeIndex]
             * (1 << DSO_INPUT_TO_DISPLAY_SHIFT)) / RawAttenuationFactor[MeasurementControl.DisplayRangeIndex];
+    initRawToDisplayTable();
 
 // Tests of raw <-> display conversion routines
     int tValue;
@@ -924,6 +1765,7 @@ void testDSOConversions(void) {
 
     MeasurementControl.InputRangeIndexOtherThanDisplayRange = true;
     MeasurementControl.isACMode = true;
+    initRawToDisplayTable();
 
     tValue = getDisplayFrowRawInputValue(2200);    // since it is AC range
     tValue = getInputRawFromDisplayValue(tValue);
@@ -68,6 +68,14 @@ const char AutoTriggerButtonStringAuto[] = "Trigger auto";
 const char AutoTriggerButtonStringManual[] = "Trigger man";
 const char AutoTriggerButtonStringOff[] = "Trigger off";
 
+const char * const FilterButtonStrings[FILTER_TYPE_NUMBER] = { "Filter off", "Filter avg", "Filter IIR", "Filter FIR" };
+const char * const MaskButtonStrings[MASK_TEST_TOLERANCE_NUMBER] = { "Mask off", "Mask 4px", "Mask 8px", "Mask 16px" };
+const char * const MaskFailureButtonStrings[MASK_FAILURE_NUMBER] = { "F:cnt", "F:stop", "F:save" };
+const char * const FFTWindowButtonStrings[FFT_WINDOW_NUMBER] = { "Rectangle", "Hann", "Hamming", "Flat top" };
+const char * const FFTAverageButtonStrings[FFT_AVERAGE_NUMBER] = { "Avg off", "Avg exp", "Avg 8", "Peak hold" };
+const char FFTScaleButtonStringLinear[] = "Linear";
+const char FFTScaleButtonStringDB[] = "dB";
+
 static TouchButton * TouchButtonAutoRangeOnOff;
 const char AutoRangeButtonStringAuto[] = "Range auto";
 const char AutoRangeButtonStringManual[] = "Range man";
@@ -84,8 +92,11 @@ const char DrawModeButtonStringPixel[] = "Pixel";
 // still experimental
 static TouchButton * TouchButtonDrawModeTriggerLine;
 const char DrawModeTriggerLineButtonString[] = "Trigg. line";
+const char DrawModeDecodeButtonString[] = "Trigg. UART";
 
 static TouchButton * TouchButtonSingleshot;
+const char FFTButtonString[] = "FFT";
+const char FFTButtonStringMax[] = "FFT 512";
 #define SINGLESHOT_PPRINT_VALUE_X (DISPLAY_WIDTH - TEXT_SIZE_11_WIDTH - 1)
 
 static TouchButton * TouchButtonSlope;
@@ -103,7 +114,7 @@ char SettingsButtonStringInfoSize[] = "Info      ";
 static TouchButton *TouchButtonChartHistory;
 char ChartHistoryButtonString[] = "Hist     ";
 #define ChartHistoryButtonStringChangeIndex 5
-const char * const ChartHistoryButtonStrings[DRAW_HISTORY_LEVELS] = { StringOff, StringLow, StringMid, StringHigh };
+const char * const ChartHistoryButtonStrings[DRAW_HISTORY_LEVELS + 1] = { StringOff, StringLow, StringMid, StringHigh, "pers" };
 
 static TouchButton * TouchButtonLoad;
 static TouchButton * TouchButtonStore;
@@ -123,12 +134,40 @@ static TouchButton * TouchButtonACRangeOnOff;
 
 static TouchButton * TouchButtonShowPretriggerValuesOnOff;
 
+static TouchButton * TouchButtonAcquisitionBenchmark;
+
+static TouchButton * TouchButtonPeakDetectOnOff;
+
+static TouchButton * TouchButtonSegmentCapture;
+
+static TouchButton * TouchButtonDeepMemoryOnOff;
+
+static TouchButton * TouchButtonStreamingStatisticsOnOff;
+
+static TouchButton * TouchButtonRollModeOnOff;
+
+static TouchButton * TouchButtonAutoset;
+static TouchButton * TouchButtonFilter;
+static TouchButton * TouchButtonMask;
+static TouchButton * TouchButtonMaskFailure;
+static TouchButton * TouchButtonFFTSettings;
+static TouchButton * TouchButtonFFTWindow;
+static TouchButton * TouchButtonFFTAverage;
+static TouchButton * TouchButtonFFTScale;
+static TouchButton * TouchButtonFFTWaterfall;
+static TouchButton * TouchButtonHarmonics;
+
 static TouchButton ** TouchButtonsDSO[] = { &TouchButtonBack, &TouchButtonStartStopDSOMeasurement, &TouchButtonAutoTriggerOnOff,
         &TouchButtonAutoRangeOnOff, &TouchButtonAutoOffsetOnOff, &TouchButtonChannelSelect, &TouchButtonDrawModeLinePixel,
         &TouchButtonDrawModeTriggerLine, &TouchButtonDSOSettings, &TouchButtonDSOMoreSettings, &TouchButtonSingleshot,
         &TouchButtonSlope, &TouchButtonADS7846TestOnOff, &TouchButtonInfoSize, &TouchButtonChartHistory, &TouchButtonLoad,
         &TouchButtonStore, &TouchButtonFFT, &TouchButtonCalibrateVoltage, &TouchButtonACRangeOnOff,
-        &TouchButtonShowPretriggerValuesOnOff };
+        &TouchButtonShowPretriggerValuesOnOff, &TouchButtonAcquisitionBenchmark,
+        &TouchButtonPeakDetectOnOff, &TouchButtonSegmentCapture,
+        &TouchButtonDeepMemoryOnOff, &TouchButtonStreamingStatisticsOnOff, &TouchButtonRollModeOnOff,
+        &TouchButtonAutoset, &TouchButtonFilter, &TouchButtonMask, &TouchButtonMaskFailure, &TouchButtonFFTSettings,
+        &TouchButtonFFTWindow, &TouchButtonFFTAverage, &TouchButtonFFTScale, &TouchButtonFFTWaterfall,
+        &TouchButtonHarmonics };
 
 static TouchSlider TouchSliderTriggerLevel;
 
@@ -170,6 +209,8 @@ void drawAnalysisOnlyPartOfGui(void);
 //void drawRunningOnlyPartOfGui(void);
 void drawDSOSettingsPageGui(void);
 void drawDSOMoreSettingsPageGui(void);
+void drawDSOFFTSettingsPageGui(void);
+void drawDSOWaterfallPageGui(void);
 void showDSOSettingsPage(void);
 void redrawDisplay(bool doClearbefore);
 void redrawDisplay(void);
@@ -190,7 +231,7 @@ void TouchUpHandler(struct XYPosition * const aTochPosition);
 //void doStartStopDSO(TouchButton * const aTheTouchedButton, int16_t aValue);
 //void doChartHistory(TouchButton * const aTheTouchedButton, int16_t aValue);
 //void doADS7846Test(TouchButton * const aTheTouchedButton, int16_t aValue);
-//static void doStoreLoadAcquisitionData(TouchButton * const aTheTouchedButton, int16_t aMode);
+void doStoreLoadAcquisitionData(TouchButton * const aTheTouchedButton, int16_t aMode);
 //void doRangeMode(TouchButton * const aTheTouchedButton, int16_t aValue);
 
 //uint16_t doTriggerLevel(TouchSlider * const aTheTouchedSlider, const uint16_t aValue);
@@ -208,6 +249,12 @@ void initDSO(void) {
     DisplayControl.EraseColors[2] = COLOR_DATA_ERASE_MID;
     DisplayControl.EraseColors[3] = COLOR_DATA_ERASE_HIGH;
     DisplayControl.ShowFFT = false;
+    DisplayControl.FFTSize = FFT_SIZE;
+    DisplayControl.FFTWindowType = FFT_WINDOW_HANN;
+    DisplayControl.FFTAverageMode = FFT_AVERAGE_OFF;
+    DisplayControl.FFTShowDB = false;
+    DisplayControl.ShowHarmonics = false;
+    DisplayControl.FilterType = FILTER_TYPE_NONE;
     DisplayControl.DatabufferPreTriggerDisplaySize = (2 * DATABUFFER_DISPLAY_RESOLUTION);
     initAcquisition();
 }
@@ -278,6 +325,28 @@ void stopDSO(void) {
 #endif
 }
 
+/*
+ * do stop handling here (in thread mode)
+ */
+static void switchToAnalysisMode(void) {
+    MeasurementControl.StopRequested = false;
+    MeasurementControl.isRunning = false;
+    if (MeasurementControl.TimebaseIndex == TIMEBASE_INDEX_EQUIVALENT_TIME) {
+        // stopped data are the real samples of the last acquisition
+        DisplayControl.XScale = xScaleForTimebase[TIMEBASE_INDEX_EQUIVALENT_TIME];
+    }
+    // analysis, FFT and storage of stopped data work on a linear buffer
+    linearizePreTriggerBuffer();
+    MeasurementControl.isSingleShotMode = false;
+    DisplayControl.showInfoMode = LONG_INFO;
+    TouchButtonFFT->setRedGreenButtonColor(false); // leads to DisplayControl.ShowFFT = false;
+    TouchButtonFFT->setCaption(FFTButtonString);
+
+    DisplayControl.DisplayBufferDrawMode = DRAW_MODE_LINE;
+    // draw grid lines and gui
+    redrawDisplay();
+}
+
 /************************************************************************
  * main loop - 32 microseconds
  ************************************************************************/
@@ -304,10 +373,15 @@ void loopDSO(void) {
             /*
              * Data (from InterruptServiceRoutine or DMA) is ready
              */
+            if (MeasurementControl.RollModeActive) {
+                // roll mode was stopped -> make ring linear and show last screen
+                linearizeRollBuffer();
+            }
             computeMinMaxAverageAndPeriodFrequency();
+            countAcquisitionForStatistics();
             if (!(MeasurementControl.TimebaseFastDMAMode || DataBufferControl.DrawWhileAcquire)) {
-                // align pre trigger buffer after acquisition
-                adjustPreTriggerBuffer(FourDisplayLinesBuffer);
+                // resolve cyclic pre trigger buffer after acquisition - no data is moved
+                setPreTriggerRing();
             }
             if (MeasurementControl.StopRequested) {
                 if (DataBufferControl.DataBufferEndPointer == &DataBufferControl.DataBuffer[DATABUFFER_DISPLAY_END]
@@ -316,51 +390,86 @@ void loopDSO(void) {
                     // -> start new last acquisition
                     startAcquisition();
                 } else {
-                    /*
-                     * do stop handling here (in thread mode)
-                     */
-                    MeasurementControl.StopRequested = false;
-                    MeasurementControl.isRunning = false;
-                    MeasurementControl.isSingleShotMode = false;
                     // delayed tone for stop
                     FeedbackToneOK();
-                    DisplayControl.showInfoMode = LONG_INFO;
-                    TouchButtonFFT->setRedGreenButtonColor(false); // leads to DisplayControl.ShowFFT = false;
-
-                    DisplayControl.DisplayBufferDrawMode = DRAW_MODE_LINE;
-                    // draw grid lines and gui
-                    redrawDisplay();
+                    switchToAnalysisMode();
                 }
             } else {
                 if (MeasurementControl.ChangeRequestedFlags & CHANGE_REQUESTED_TIMEBASE) {
                     changeTimeBase(false);
                     MeasurementControl.ChangeRequestedFlags = 0;
+                    resetAcquisitionStatistics();
                 }
                 /*
-                 * Normal loop-> process data, draw new chart, and start next acquisition
+                 * Normal loop-> process data, start next acquisition and draw new chart while acquiring
+                 * Trigger and input range (attenuator) must be set before start of acquisition.
                  */
                 int tLastTriggerDisplayValue = DisplayControl.TriggerLevelDisplayValue;
                 computeAutoTrigger();
                 computeAutoInputRange();
+                if (!DataBufferControl.DrawWhileAcquire) {
+                    // keep data for drawing, since DataBuffer is overwritten by next acquisition
+                    copyDataBufferDisplayRegion();
+                    if (MeasurementControl.TimebaseIndex == TIMEBASE_INDEX_EQUIVALENT_TIME) {
+                        // show reconstructed signal instead of the few samples of the last acquisition
+                        foldEquivalentTimeSamples();
+                        getEquivalentTimeValues(&DisplayDataBufferControl.DataBuffer[0]);
+                    }
+                    if (MaskTest.ToleranceIndex != MASK_TEST_TOLERANCE_OFF
+                            && !checkMask(&DisplayDataBufferControl.DataBuffer[0])
+                            && MaskTest.FailureAction != MASK_FAILURE_COUNT) {
+                        // stop without new acquisition in order to keep the failing one
+                        FeedbackTone(FEEDBACK_TONE_LONG_ERROR);
+                        switchToAnalysisMode();
+                        if (MaskTest.FailureAction == MASK_FAILURE_SAVE) {
+                            doStoreLoadAcquisitionData(NULL, MODE_STORE);
+                        }
+                        return;
+                    }
+                } else if (DisplayControl.DisplayPage == WATERFALL) {
+                    // draw while acquire is suppressed on waterfall page, so keep data for the waterfall row
+                    copyDataBufferDisplayRegion();
+                }
+                startAcquisition();
+
                 computeAutoDisplayRange();
                 // handle trigger line
                 DisplayControl.TriggerLevelDisplayValue = getDisplayFrowRawInputValue(MeasurementControl.RawTriggerLevel);
                 if (tLastTriggerDisplayValue
-                        != DisplayControl.TriggerLevelDisplayValue&& MeasurementControl.TriggerMode != TRIGGER_MODE_OFF) {
+                        != DisplayControl.TriggerLevelDisplayValue&& MeasurementControl.TriggerMode != TRIGGER_MODE_OFF
+                        && DisplayControl.DisplayPage != WATERFALL) {
                     clearTriggerLine(tLastTriggerDisplayValue);
                     drawTriggerLine();
                 }
 
-                if (!DataBufferControl.DrawWhileAcquire) {
+                // Do not draw data with the display factors of a new input range
+                if ((!DataBufferControl.DrawWhileAcquire || DisplayControl.DisplayPage == WATERFALL)
+                        && DisplayDataBufferControl.InputRangeIndexUsed == MeasurementControl.InputRangeIndex) {
                     // normal mode => clear old chart and draw new data
-                    drawDataBuffer(DataBufferControl.DataBufferDisplayStart, DSO_DISPLAY_WIDTH, COLOR_DATA_RUN,
-                            DisplayControl.EraseColor);
-                    draw128FFTValuesFast(COLOR_FFT_DATA, DataBufferControl.DataBufferDisplayStart);
+                    uint16_t * tDisplayDataPointer = getFilteredDataBufferPointer(&DisplayDataBufferControl.DataBuffer[0],
+                            DSO_DISPLAY_WIDTH);
+                    if (DisplayControl.DisplayPage == WATERFALL) {
+                        // only the spectrogram is shown
+                        addFFTWaterfallRow(tDisplayDataPointer);
+                    } else {
+                        if (DisplayControl.EraseColorIndex == DRAW_HISTORY_PERSISTENCE) {
+                            // fold all acquisitions, but draw only every PERSISTENCE_DRAW_MILLIS
+                            accumulatePersistence(tDisplayDataPointer);
+                            if (tMillis - PersistenceInfo.LastDrawMillis > PERSISTENCE_DRAW_MILLIS) {
+                                drawPersistence();
+                            }
+                        } else {
+                            drawDataBuffer(tDisplayDataPointer, DSO_DISPLAY_WIDTH, COLOR_DATA_RUN, DisplayControl.EraseColor);
+                        }
+                        draw128FFTValuesFast(COLOR_FFT_DATA, tDisplayDataPointer);
+                    }
+                    if (DisplayControl.ShowHarmonics) {
+                        computeHarmonics(tDisplayDataPointer, DSO_DISPLAY_WIDTH);
+                    }
                 }
-                startAcquisition();
             }
         }
-        if (DataBufferControl.DrawWhileAcquire) {
+        if (DataBufferControl.DrawWhileAcquire && MeasurementControl.isRunning) {
             /*
              * Draw while acquire mode
              */
@@ -369,27 +478,42 @@ void loopDSO(void) {
                 ADC_StopConversion(DSO_ADC_ID );
                 changeTimeBase(false);
                 MeasurementControl.ChangeRequestedFlags = 0;
+                resetAcquisitionStatistics();
                 clearDiplayedChart();
-                ADC_StartConversion(DSO_ADC_ID );
-            }
-            // detect end of pre trigger phase and adjust pre trigger buffer during acquisition
-            if (MeasurementControl.TriggerPhaseJustEnded) {
-                MeasurementControl.TriggerPhaseJustEnded = false;
-                adjustPreTriggerBuffer(FourDisplayLinesBuffer);
-                DataBufferControl.DataBufferNextDrawPointer = &DataBufferControl.DataBuffer[DATABUFFER_DISPLAY_START];
-                DataBufferControl.NextDrawXValue = 0;
+                if (MeasurementControl.RollModeActive || MeasurementControl.isRollMode) {
+                    // restart to enter or leave roll mode with new timebase
+                    startAcquisition();
+                } else {
+                    ADC_StartConversion(DSO_ADC_ID );
+                }
             }
-            // check if new data available and draw in corresponding color
-            if (MeasurementControl.TriggerActualPhase < PHASE_POST_TRIGGER) {
-                if (DataBufferControl.DataBufferPreTriggerAreaWrapAround) {
-                    // wrap while searching trigger -> start from beginning of buffer
-                    DataBufferControl.DataBufferPreTriggerAreaWrapAround = false;
-                    DataBufferControl.NextDrawXValue = 0;
-                    DataBufferControl.DataBufferNextDrawPointer = &DataBufferControl.DataBuffer[0];
+            if (MeasurementControl.RollModeActive) {
+                // roll mode has no end of acquisition and therefore adds no waterfall rows
+                if (DisplayControl.DisplayPage != WATERFALL) {
+                    drawRollModeValues(COLOR_DATA_RUN);
                 }
-                drawRemainingDataBufferValues(COLOR_DATA_PRETRIGGER);
             } else {
-                drawRemainingDataBufferValues(COLOR_DATA_RUN);
+                // detect end of pre trigger phase and resolve pre trigger ring during acquisition
+                if (MeasurementControl.TriggerPhaseJustEnded) {
+                    MeasurementControl.TriggerPhaseJustEnded = false;
+                    setPreTriggerRing();
+                    DataBufferControl.DataBufferNextDrawPointer = &DataBufferControl.DataBuffer[DATABUFFER_DISPLAY_START];
+                    DataBufferControl.NextDrawXValue = 0;
+                }
+                // check if new data available and draw in corresponding color - no trace on waterfall page
+                if (DisplayControl.DisplayPage == WATERFALL) {
+                    // the row is added after end of acquisition
+                } else if (MeasurementControl.TriggerActualPhase < PHASE_POST_TRIGGER) {
+                    if (DataBufferControl.DataBufferPreTriggerAreaWrapAround) {
+                        // wrap while searching trigger -> start from beginning of buffer
+                        DataBufferControl.DataBufferPreTriggerAreaWrapAround = false;
+                        DataBufferControl.NextDrawXValue = 0;
+                        DataBufferControl.DataBufferNextDrawPointer = &DataBufferControl.DataBuffer[0];
+                    }
+                    drawRemainingDataBufferValues(COLOR_DATA_PRETRIGGER);
+                } else {
+                    drawRemainingDataBufferValues(COLOR_DATA_RUN);
+                }
             }
         }
         /*
@@ -440,6 +564,9 @@ void loopDSO(void) {
             } else if (DisplayControl.DisplayPage == MORE_SETTINGS) {
                 // refresh buttons
                 drawDSOMoreSettingsPageGui();
+            } else if (DisplayControl.DisplayPage == FFT_SETTINGS) {
+                // refresh buttons
+                drawDSOFFTSettingsPageGui();
             }
 
         } else if (DisplayControl.DisplayPage == CHART && DisplayControl.showInfoMode == LONG_INFO) {
@@ -448,7 +575,7 @@ void loopDSO(void) {
                 showRTCTimeEverySecond(INFO_LEFT_MARGIN, INFO_UPPER_MARGIN + 2 * TEXT_SIZE_11_HEIGHT, COLOR_RED,
                         COLOR_BACKGROUND_DSO);
             } else {
-                showRTCTimeEverySecond(INFO_LEFT_MARGIN, INFO_UPPER_MARGIN + 3 * TEXT_SIZE_11_HEIGHT, COLOR_RED,
+                showRTCTimeEverySecond(INFO_LEFT_MARGIN, INFO_UPPER_MARGIN + 4 * TEXT_SIZE_11_HEIGHT, COLOR_RED,
                         COLOR_BACKGROUND_DSO);
             }
         }
@@ -486,10 +613,10 @@ int changeTimeBaseValue(int aChangeValue) {
     int tOldIndex = MeasurementControl.TimebaseIndex;
     // positive value means increment timebase index!
     int tNewIndex = tOldIndex + aChangeValue;
-    // do not decrement below 1 or increment above TIMEBASE_NUMBER_OF_ENTRIES -1
-    // skip 1. entry because it makes no sense yet (wait until interleaving acquisition is implemented :-))
-    if (tNewIndex < 1) {
-        tNewIndex = 1;
+    // do not decrement below 0 or increment above TIMEBASE_NUMBER_OF_ENTRIES -1
+    // 1. entry is realized by equivalent time sampling
+    if (tNewIndex < TIMEBASE_INDEX_EQUIVALENT_TIME) {
+        tNewIndex = TIMEBASE_INDEX_EQUIVALENT_TIME;
     }
     if (tNewIndex > TIMEBASE_NUMBER_OF_ENTRIES - 1) {
         tNewIndex = TIMEBASE_NUMBER_OF_ENTRIES - 1;
@@ -500,6 +627,8 @@ int changeTimeBaseValue(int aChangeValue) {
         // signal to main loop in thread mode
         MeasurementControl.TimebaseNewIndex = tNewIndex;
         MeasurementControl.ChangeRequestedFlags |= CHANGE_REQUESTED_TIMEBASE;
+        // autoset result is no longer valid
+        AutosetInfo.MillisToStable = 0;
     }
     return tFeedbackType;
 }
@@ -531,9 +660,14 @@ int changeXScale(int aValue) {
     int tFeedbackType = FEEDBACK_TONE_NO_ERROR;
     DisplayControl.XScale += aValue;
 
-    if (DisplayControl.XScale < -DATABUFFER_DISPLAY_RESOLUTION_FACTOR) {
+    int tMinXScale = -DATABUFFER_DISPLAY_RESOLUTION_FACTOR;
+    if (DataBufferControl.isPacked) {
+        // packed data is unpacked to FourDisplayLinesBuffer for drawing
+        tMinXScale = -(SIZEOF_DISPLAYLINE_BUFFER / DSO_DISPLAY_WIDTH);
+    }
+    if (DisplayControl.XScale < tMinXScale) {
         tFeedbackType = FEEDBACK_TONE_SHORT_ERROR;
-        DisplayControl.XScale = -DATABUFFER_DISPLAY_RESOLUTION_FACTOR;
+        DisplayControl.XScale = tMinXScale;
     }
     DisplayControl.DisplayIncrementPixel = adjustIntWithScaleFactor(DATABUFFER_DISPLAY_INCREMENT, DisplayControl.XScale);
     printInfo();
@@ -545,7 +679,7 @@ int changeXScale(int aValue) {
     // do tone before draw
     FeedbackTone(tFeedbackType);
     tFeedbackType = FEEDBACK_TONE_NO_TONE;
-    drawDataBuffer(DataBufferControl.DataBufferDisplayStart, DSO_DISPLAY_WIDTH, COLOR_DATA_HOLD, DisplayControl.EraseColors[0]);
+    drawDataBuffer(getDataBufferDisplayPointer(), DSO_DISPLAY_WIDTH, COLOR_DATA_HOLD, DisplayControl.EraseColors[0]);
 
     return tFeedbackType;
 }
@@ -568,7 +702,7 @@ int scrollDisplay(int aValue) {
             tFeedbackType = FEEDBACK_TONE_SHORT_ERROR;
         }
         // delete old graph and draw new one
-        drawDataBuffer(DataBufferControl.DataBufferDisplayStart, DSO_DISPLAY_WIDTH, COLOR_DATA_HOLD, DisplayControl.EraseColors[0]);
+        drawDataBuffer(getDataBufferDisplayPointer(), DSO_DISPLAY_WIDTH, COLOR_DATA_HOLD, DisplayControl.EraseColors[0]);
     }
     return tFeedbackType;
 }
@@ -706,6 +840,47 @@ void doTriggerMode(TouchButton * const aTheTouchedButton, int16_t aValue) {
     aTheTouchedButton->drawButton();
 }
 
+/*
+ * cycles through filter types for displayed data and FFT
+ */
+void doFilterType(TouchButton * const aTheTouchedButton, int16_t aValue) {
+    FeedbackToneOK();
+    DisplayControl.FilterType++;
+    if (DisplayControl.FilterType >= FILTER_TYPE_NUMBER) {
+        DisplayControl.FilterType = FILTER_TYPE_NONE;
+    }
+    initFilter();
+    aTheTouchedButton->setCaption(FilterButtonStrings[DisplayControl.FilterType]);
+    aTheTouchedButton->drawButton();
+}
+
+/*
+ * cycles through mask tolerances - switching on takes the displayed region of the stopped capture as reference
+ */
+void doMaskTest(TouchButton * const aTheTouchedButton, int16_t aValue) {
+    FeedbackToneOK();
+    uint8_t tToleranceIndex = MaskTest.ToleranceIndex + 1;
+    if (tToleranceIndex >= MASK_TEST_TOLERANCE_NUMBER) {
+        tToleranceIndex = MASK_TEST_TOLERANCE_OFF;
+    }
+    initMaskTest(tToleranceIndex);
+    aTheTouchedButton->setCaption(MaskButtonStrings[tToleranceIndex]);
+    aTheTouchedButton->drawButton();
+}
+
+/*
+ * cycles through actions for failed mask test - count only, stop, stop and store
+ */
+void doMaskFailureAction(TouchButton * const aTheTouchedButton, int16_t aValue) {
+    FeedbackToneOK();
+    MaskTest.FailureAction++;
+    if (MaskTest.FailureAction >= MASK_FAILURE_NUMBER) {
+        MaskTest.FailureAction = MASK_FAILURE_COUNT;
+    }
+    aTheTouchedButton->setCaption(MaskFailureButtonStrings[MaskTest.FailureAction]);
+    aTheTouchedButton->drawButton();
+}
+
 void doRangeMode(TouchButton * const aTheTouchedButton, int16_t aValue) {
     FeedbackToneOK();
     MeasurementControl.RangeAutomatic = !MeasurementControl.RangeAutomatic;
@@ -743,8 +918,7 @@ void doOffsetMode(TouchButton * const aTheTouchedButton, int16_t aValue) {
         MeasurementControl.OffsetMode = OFFSET_MODE_0_VOLT;
         aTheTouchedButton->setCaption(AutoOffsetButtonString0);
         setACMode(MeasurementControl.isACMode);
-        MeasurementControl.DisplayRangeIndex = MeasurementControl.InputRangeIndex;
-        MeasurementControl.InputRangeIndexOtherThanDisplayRange = false;
+        setDisplayRange(MeasurementControl.InputRangeIndex, true);
     } else if (MeasurementControl.OffsetMode == OFFSET_MODE_AUTOMATIC) {
         aTheTouchedButton->setCaption(AutoOffsetButtonStringAuto);
     } else {
@@ -781,6 +955,7 @@ void doChannelSelect(TouchButton * const aTheTouchedButton, int16_t aValue) {
             // wrap to first channel connected to attenuator and restore ACRange
             MeasurementControl.ADCInputMUXChannelIndex = 0;
             MeasurementControl.isACMode = DSO_getACMode();
+            initRawToDisplayTable();
         }
         aTheTouchedButton->setCaption(ADS7846ChannelStrings[MeasurementControl.ADCInputMUXChannelIndex]);
 
@@ -835,23 +1010,85 @@ void doDrawMode(TouchButton * const aTheTouchedButton, int16_t aValue) {
 }
 
 /*
- * Switch trigger line mode on and off (for data chart)
+ * Cycle trigger line mode off -> trigger line -> trigger line with UART decoding (for data chart)
  */
 void doDrawModeTriggerLine(TouchButton * const aTheTouchedButton, int16_t aValue) {
     FeedbackToneOK();
-    aValue = !aValue;
+    aValue++;
+    if (aValue > 2) {
+        aValue = 0;
+    }
 
 // switch mode
-    if (aValue) {
+    if (aValue == 1) {
         // erase old chart in old mode
         drawDataBuffer(NULL, DSO_DISPLAY_WIDTH, DisplayControl.EraseColor, 0);
         DisplayControl.DisplayBufferDrawMode |= DRAW_MODE_TRIGGER;
+        aTheTouchedButton->setCaption(DrawModeTriggerLineButtonString);
+    } else if (aValue == 2) {
+        DisplayControl.DisplayBufferDrawMode |= DRAW_MODE_DECODE;
+        aTheTouchedButton->setCaption(DrawModeDecodeButtonString);
     } else {
-        DisplayControl.DisplayBufferDrawMode &= ~DRAW_MODE_TRIGGER;
+        clearDecodedBytes();
+        DisplayControl.DisplayBufferDrawMode &= ~(DRAW_MODE_TRIGGER | DRAW_MODE_DECODE);
+        aTheTouchedButton->setCaption(DrawModeTriggerLineButtonString);
+    }
+    // setRedGreenButtonColor() maps value to boolean
+    aTheTouchedButton->setRedGreenButtonColor(aValue);
+    aTheTouchedButton->setValue(aValue);
+    aTheTouchedButton->drawButton();
+}
+
+/*
+ * Toggles peak detect mode. It is only active for timebases >= TIMEBASE_INDEX_PEAK_DETECT_START
+ */
+void doPeakDetectOnOff(TouchButton * const aTheTouchedButton, int16_t aValue) {
+    FeedbackToneOK();
+    aValue = !aValue;
+    MeasurementControl.isPeakDetectMode = aValue;
+    if (MeasurementControl.isRunning) {
+        // let main loop set the new sample rate
+        MeasurementControl.ChangeRequestedFlags |= CHANGE_REQUESTED_TIMEBASE;
+    } else {
+        changeTimeBase(false);
     }
     aTheTouchedButton->setRedGreenButtonColorAndDraw(aValue);
 }
 
+/*
+ * Toggles roll mode. It is only active for draw while acquire timebases >= TIMEBASE_INDEX_DRAW_WHILE_ACQUIRE
+ */
+void doRollModeOnOff(TouchButton * const aTheTouchedButton, int16_t aValue) {
+    FeedbackToneOK();
+    aValue = !aValue;
+    MeasurementControl.isRollMode = aValue;
+    if (MeasurementControl.isRunning) {
+        // let main loop restart acquisition
+        MeasurementControl.ChangeRequestedFlags |= CHANGE_REQUESTED_TIMEBASE;
+    }
+    aTheTouchedButton->setRedGreenButtonColorAndDraw(aValue);
+}
+
+/*
+ * Toggles computing of min, max, average and period by the acquisition interrupts instead of a pass after acquisition
+ */
+void doStreamingStatisticsOnOff(TouchButton * const aTheTouchedButton, int16_t aValue) {
+    FeedbackToneOK();
+    aValue = !aValue;
+    MeasurementControl.isStreamingStatisticsMode = aValue;
+    aTheTouchedButton->setRedGreenButtonColorAndDraw(aValue);
+}
+
+/*
+ * Toggles packed storage for the last acquisition after stop or for single shot
+ */
+void doDeepMemoryOnOff(TouchButton * const aTheTouchedButton, int16_t aValue) {
+    FeedbackToneOK();
+    aValue = !aValue;
+    MeasurementControl.isDeepMemoryMode = aValue;
+    aTheTouchedButton->setRedGreenButtonColorAndDraw(aValue);
+}
+
 void doShowPretriggerValuesOnOff(TouchButton * const aTheTouchedButton, int16_t aValue) {
     FeedbackToneOK();
     aValue = !aValue;
@@ -881,6 +1118,15 @@ void doMoreSettings(TouchButton * const aTheTouchedButton, int16_t aValue) {
     drawDSOMoreSettingsPageGui();
 }
 
+/*
+ * show gui of FFT settings screen
+ */
+void doFFTSettings(TouchButton * const aTheTouchedButton, int16_t aValue) {
+    FeedbackToneOK();
+    BlueDisplay1.clearDisplay(COLOR_BACKGROUND_DSO);
+    drawDSOFFTSettingsPageGui();
+}
+
 /*
  * handle back button on settings pages
  */
@@ -891,6 +1137,11 @@ void doSettingsBack(TouchButton * const aTheTouchedButton, int16_t aValue) {
         DisplayControl.DisplayPage = CHART;
         // Back
         redrawDisplay();
+    } else if (DisplayControl.DisplayPage == WATERFALL) {
+        // the waterfall image may have overwritten the persistence grid
+        clearPersistence();
+        BlueDisplay1.clearDisplay(COLOR_BACKGROUND_DSO);
+        drawDSOFFTSettingsPageGui();
     } else {
         // show settings page
         showDSOSettingsPage();
@@ -902,10 +1153,18 @@ void doSettingsBack(TouchButton * const aTheTouchedButton, int16_t aValue) {
  */
 void prepareForStart(void) {
     DisplayControl.showInfoMode = LONG_INFO;
+    resetFFTAverage();
+    resetWaterfall();
+    // the min/max pyramid of the stopped data may have overwritten the persistence grid
+    clearPersistence();
     MeasurementControl.TimestampLastRangeChange = 0; // enable direct range change at start
 
     // reset xScale to regular value
-    if (MeasurementControl.TimebaseIndex < TIMEBASE_NUMBER_OF_XSCALE_CORRECTION) {
+    if (MeasurementControl.TimebaseIndex == TIMEBASE_INDEX_EQUIVALENT_TIME) {
+        // reconstruction buffer has display resolution
+        DisplayControl.XScale = 0;
+        resetEquivalentTime();
+    } else if (MeasurementControl.TimebaseIndex < TIMEBASE_NUMBER_OF_XSCALE_CORRECTION) {
         DisplayControl.XScale = xScaleForTimebase[MeasurementControl.TimebaseIndex];
     } else {
         DisplayControl.XScale = 0;
@@ -944,22 +1203,39 @@ void doStartStopDSO(TouchButton * const aTheTouchedButton, int16_t aValue) {
          * Do this asynchronously to the interrupt routine in order to extend a running or started acquisition
          * stop single shot mode
          */
-        // first extends end marker for ISR to end of buffer instead of end of display
-        DataBufferControl.DataBufferEndPointer = &DataBufferControl.DataBuffer[DATABUFFER_SIZE - 1];
+        if (MeasurementControl.RollModeActive) {
+            // roll mode has no end of acquisition -> stop immediately, ring is made linear by main loop
+            uint16_t * tEndPointer = DataBufferControl.DataBufferNextInPointer;
+            if (tEndPointer > &DataBufferControl.DataBuffer[DATABUFFER_SIZE - 1]) {
+                tEndPointer = &DataBufferControl.DataBuffer[DATABUFFER_SIZE - 1];
+            }
+            DataBufferControl.DataBufferEndPointer = tEndPointer;
+        } else {
+            /*
+             * first extends end marker for ISR to end of buffer instead of end of display
+             * In deep memory mode the running acquisition is not extended, it ends regularly at end of display
+             * and the main loop then starts a new last acquisition which stores its post trigger values packed.
+             */
+            if (!DataBufferControl.isPacked && !isPackedLastAcquisitionPossible()) {
+                DataBufferControl.DataBufferEndPointer = &DataBufferControl.DataBuffer[DATABUFFER_SIZE - 1];
+            }
 //		if (MeasurementControl.SingleShotMode) {
 //			MeasurementControl.ActualPhase = PHASE_POST_TRIGGER;
 //		}
-        // in SingleShotMode stop is directly requested
-        if (MeasurementControl.StopRequested && !MeasurementControl.isSingleShotMode) {
-            // for stop requested 2 times -> stop immediately
-            uint16_t * tEndPointer = DataBufferControl.DataBufferNextInPointer;
-            DataBufferControl.DataBufferEndPointer = tEndPointer;
-            // clear trailing buffer space not used
-            memset(tEndPointer, DATABUFFER_INVISIBLE_RAW_VALUE,
-                    ((uint8_t*) &DataBufferControl.DataBuffer[DATABUFFER_SIZE]) - ((uint8_t*) tEndPointer));
+            // in SingleShotMode stop is directly requested
+            if (MeasurementControl.StopRequested && !MeasurementControl.isSingleShotMode) {
+                // for stop requested 2 times -> stop immediately
+                uint16_t * tEndPointer = DataBufferControl.DataBufferNextInPointer;
+                DataBufferControl.DataBufferEndPointer = tEndPointer;
+                if (!DataBufferControl.isPacked) {
+                    // clear trailing buffer space not used - packed values behind end pointer are returned as invisible
+                    memset(tEndPointer, DATABUFFER_INVISIBLE_RAW_VALUE,
+                            ((uint8_t*) &DataBufferControl.DataBuffer[DATABUFFER_SIZE]) - ((uint8_t*) tEndPointer));
+                }
 //            for (int i = &DataBufferControl.DataBuffer[DATABUFFER_SIZE] - tEndPointer; i > 0; --i) {
 //                *tEndPointer++ = DATABUFFER_INVISIBLE_RAW_VALUE;
 //            }
+            }
         }
         // return to continuous  mode
         MeasurementControl.isSingleShotMode = false;
@@ -985,14 +1261,19 @@ void doChartHistory(TouchButton * const aTheTouchedButton, int16_t aValue) {
 
     FeedbackToneOK();
     DisplayControl.EraseColorIndex++;
-    if (DisplayControl.EraseColorIndex >= DRAW_HISTORY_LEVELS) {
+    if (DisplayControl.EraseColorIndex > DRAW_HISTORY_PERSISTENCE) {
         DisplayControl.EraseColorIndex = 0;
     }
     strlcpy(&ChartHistoryButtonString[ChartHistoryButtonStringChangeIndex],
             ChartHistoryButtonStrings[DisplayControl.EraseColorIndex],
             strlen(ChartHistoryButtonStrings[DisplayControl.EraseColorIndex]) + 1);
     aTheTouchedButton->setCaption(ChartHistoryButtonString);
-    DisplayControl.EraseColor = DisplayControl.EraseColors[DisplayControl.EraseColorIndex];
+    if (DisplayControl.EraseColorIndex == DRAW_HISTORY_PERSISTENCE) {
+        clearPersistence();
+        DisplayControl.EraseColor = DisplayControl.EraseColors[0];
+    } else {
+        DisplayControl.EraseColor = DisplayControl.EraseColors[DisplayControl.EraseColorIndex];
+    }
     if (MeasurementControl.isRunning && DisplayControl.DisplayPage == CHART) {
         // clear history on screen
         redrawDisplay();
@@ -1126,23 +1407,38 @@ uint16_t doVoltagePicker(TouchSlider * const aTheTouchedSlider, uint16_t aValue)
 
 /**
  * 3ms for FFT, 9ms complete with -OS
+ * Cycles through off, FFT_SIZE and FFT_SIZE_MAX. The size applies to the FFT of stopped data,
+ * the running display always uses FFT_SIZE, since only DSO_DISPLAY_WIDTH values are copied for display.
  * @param aTheTouchedButton
  * @param aMode
  */
 void doShowFFT(TouchButton * const aTheTouchedButton, int16_t aValue) {
     FeedbackToneOK();
-    aValue = !aValue;
+    aValue++;
+    if (aValue > 2) {
+        aValue = 0;
+    }
     DisplayControl.ShowFFT = aValue;
+    if (aValue == 2) {
+        DisplayControl.FFTSize = FFT_SIZE_MAX;
+        aTheTouchedButton->setCaption(FFTButtonStringMax);
+    } else {
+        DisplayControl.FFTSize = FFT_SIZE;
+        aTheTouchedButton->setCaption(FFTButtonString);
+    }
+    // setRedGreenButtonColor() maps value to boolean
     aTheTouchedButton->setRedGreenButtonColor(aValue);
+    aTheTouchedButton->setValue(aValue);
 
+    if (DisplayControl.DisplayPage == FFT_SETTINGS) {
+        aTheTouchedButton->drawButton();
+    }
     if (MeasurementControl.isRunning) {
-        if (DisplayControl.DisplayPage == SETTINGS) {
-            aTheTouchedButton->drawButton();
-        }
-        if (aValue) {
+        if (aValue == 1) {
             // initialize FFTDisplayBuffer
             memset(&DisplayBufferFFT[0], DSO_DISPLAY_HEIGHT - 1, sizeof(DisplayBufferFFT));
-        } else {
+            resetFFTAverage();
+        } else if (aValue == 0) {
             clearFFTValuesOnDisplay();
         }
     } else if (DisplayControl.DisplayPage == CHART) {
@@ -1156,6 +1452,70 @@ void doShowFFT(TouchButton * const aTheTouchedButton, int16_t aValue) {
     }
 }
 
+/*
+ * cycles through window types for running and stopped FFT
+ */
+void doFFTWindow(TouchButton * const aTheTouchedButton, int16_t aValue) {
+    FeedbackToneOK();
+    DisplayControl.FFTWindowType++;
+    if (DisplayControl.FFTWindowType >= FFT_WINDOW_NUMBER) {
+        DisplayControl.FFTWindowType = FFT_WINDOW_RECTANGLE;
+    }
+    resetFFTAverage();
+    aTheTouchedButton->setCaption(FFTWindowButtonStrings[DisplayControl.FFTWindowType]);
+    aTheTouchedButton->drawButton();
+}
+
+/*
+ * cycles through averaging modes of running FFT
+ */
+void doFFTAverage(TouchButton * const aTheTouchedButton, int16_t aValue) {
+    FeedbackToneOK();
+    DisplayControl.FFTAverageMode++;
+    if (DisplayControl.FFTAverageMode >= FFT_AVERAGE_NUMBER) {
+        DisplayControl.FFTAverageMode = FFT_AVERAGE_OFF;
+    }
+    resetFFTAverage();
+    aTheTouchedButton->setCaption(FFTAverageButtonStrings[DisplayControl.FFTAverageMode]);
+    aTheTouchedButton->drawButton();
+}
+
+/*
+ * toggles linear and dB scale of FFT
+ */
+void doFFTScale(TouchButton * const aTheTouchedButton, int16_t aValue) {
+    FeedbackToneOK();
+    DisplayControl.FFTShowDB = !DisplayControl.FFTShowDB;
+    if (DisplayControl.FFTShowDB) {
+        aTheTouchedButton->setCaption(FFTScaleButtonStringDB);
+    } else {
+        aTheTouchedButton->setCaption(FFTScaleButtonStringLinear);
+    }
+    aTheTouchedButton->drawButton();
+}
+
+/*
+ * shows waterfall page of running FFT
+ */
+void doFFTWaterfall(TouchButton * const aTheTouchedButton, int16_t aValue) {
+    FeedbackToneOK();
+    // the image shares its buffer with the persistence grid and the min/max pyramid
+    resetWaterfall();
+    BlueDisplay1.clearDisplay(COLOR_BACKGROUND_DSO);
+    drawDSOWaterfallPageGui();
+}
+
+/*
+ * toggles Goertzel analysis of fundamental and harmonics, result is shown in info line
+ */
+void doHarmonics(TouchButton * const aTheTouchedButton, int16_t aValue) {
+    FeedbackToneOK();
+    aValue = !aValue;
+    DisplayControl.ShowHarmonics = aValue;
+    HarmonicsInfo.Valid = false;
+    aTheTouchedButton->setRedGreenButtonColorAndDraw(aValue);
+}
+
 const char sDSODataFileName[] = "DSO-data.bin";
 void doStoreLoadAcquisitionData(TouchButton * const aTheTouchedButton, int16_t aMode) {
     int tFeedbackType = FEEDBACK_TONE_LONG_ERROR;
@@ -1171,6 +1531,8 @@ void doStoreLoadAcquisitionData(TouchButton * const aTheTouchedButton, int16_t a
                 f_read(&tFile, &MeasurementControl, sizeof(MeasurementControl), &tCount);
                 f_read(&tFile, &DataBufferControl, sizeof(DataBufferControl), &tCount);
                 f_close(&tFile);
+                // display range, offset etc. of loaded data
+                initRawToDisplayTable();
                 DisplayControl.showInfoMode = LONG_INFO;
                 // redraw display corresponding to new values
                 redrawDisplay();
@@ -1239,6 +1601,271 @@ void doVoltageCalibration(TouchButton * const aTheTouchedButton, int16_t aValue)
     drawDSOMoreSettingsPageGui();
 }
 
+/**
+ * Blocks until screen is touched and released again
+ */
+static void waitForTouchAndRelease(void) {
+    // wait for touch to become active
+    do {
+        checkAndHandleEvents();
+        delayMillis(10);
+    } while (!sTouchIsStillDown);
+    // wait for touch to end
+    do {
+        delayMillis(10);
+        checkAndHandleEvents();
+    } while (!sNothingTouched);
+    sDisableTouchUpOnce = true;
+    FeedbackToneOK();
+}
+
+// the touch which started the benchmark must end before a new touch can abort it
+static bool sBenchmarkStartTouchReleased;
+
+/**
+ * Runs the acquire, compute and draw cycle of loopDSO() for BENCHMARK_MILLIS_PER_TIMEBASE with the actual timebase
+ * @return true if aborted by touch - acquisition is then stopped
+ */
+static bool runAcquisitionBenchmarkLoop(void) {
+    resetAcquisitionStatistics();
+    startAcquisition();
+    while (true) {
+        checkAndHandleEvents();
+        if (sNothingTouched) {
+            sBenchmarkStartTouchReleased = true;
+        } else if (sTouchIsStillDown && sBenchmarkStartTouchReleased) {
+            ADC_StopConversion(DSO_ADC_ID );
+            ADC_disableEOCInterrupt(DSO_ADC_ID );
+            return true;
+        }
+        if (DataBufferControl.DataBufferFull) {
+            computeMinMaxAverageAndPeriodFrequency();
+            countAcquisitionForStatistics();
+            if (!MeasurementControl.TimebaseFastDMAMode) {
+                setPreTriggerRing();
+            }
+            if (getMillisSinceBoot() - AcquisitionInfo.StartMillis > BENCHMARK_MILLIS_PER_TIMEBASE) {
+                break;
+            }
+            computeAutoTrigger();
+            computeAutoInputRange();
+            copyDataBufferDisplayRegion();
+            startAcquisition();
+            computeAutoDisplayRange();
+            drawDataBuffer(&DisplayDataBufferControl.DataBuffer[0], DSO_DISPLAY_WIDTH, COLOR_DATA_RUN,
+                    DisplayControl.EraseColor);
+        }
+    }
+    return false;
+}
+
+/**
+ * Runs the acquire, compute and draw cycle of loopDSO() for BENCHMARK_MILLIS_PER_TIMEBASE for each timebase
+ * below the draw while acquire timebases and shows acquisitions per second, trigger hit rate
+ * and cycles per sample of acquisition ISR / DMA trigger search.
+ * For the fast interrupt mode timebases the cycles per sample are additionally measured with packed deep memory.
+ * Use a reproducible input signal e.g. from the DAC page. Data of a stopped acquisition is overwritten.
+ * A touch aborts the benchmark, the results of the timebases not measured are shown as 0.
+ */
+void doAcquisitionBenchmark(TouchButton * const aTheTouchedButton, int16_t aValue) {
+    FeedbackToneOK();
+    // stop running acquisition
+    ADC_StopConversion(DSO_ADC_ID );
+    ADC_disableEOCInterrupt(DSO_ADC_ID );
+    MeasurementControl.StopRequested = false;
+    MeasurementControl.isSingleShotMode = false;
+
+    AcquisitionInfo.isBenchmarkActive = true;
+    int tOldTimebaseIndex = MeasurementControl.TimebaseIndex;
+    bool tOldDeepMemoryMode = MeasurementControl.isDeepMemoryMode;
+    DisplayControl.DisplayPage = CHART;
+    DisplayControl.showInfoMode = LONG_INFO;
+    BlueDisplay1.clearDisplay(COLOR_BACKGROUND_DSO);
+    memset(AcquisitionBenchmarkResults, 0, sizeof(AcquisitionBenchmarkResults));
+    sBenchmarkStartTouchReleased = false;
+    bool tAborted = false;
+
+    for (int i = 1; i < BENCHMARK_TIMEBASE_INDEX_END && !tAborted; ++i) {
+        MeasurementControl.TimebaseNewIndex = i;
+        changeTimeBase(false); // prints info with new timebase
+        drawGridLinesWithHorizLabelsAndTriggerLine(COLOR_GRID_LINES);
+        MeasurementControl.isDeepMemoryMode = false;
+        tAborted = runAcquisitionBenchmarkLoop();
+        if (tAborted) {
+            break;
+        }
+        computeAcquisitionStatistics(&AcquisitionBenchmarkResults[i]);
+
+        AcquisitionBenchmarkResults[i].PackedCyclesPerSample = 0;
+        if (i >= TIMEBASE_FAST_MODES && i < BENCHMARK_PACKED_TIMEBASE_INDEX_END) {
+            // packing is only done for the last acquisition
+            AcquisitionBenchmarkResultStruct tPackedResult;
+            MeasurementControl.isDeepMemoryMode = true;
+            MeasurementControl.StopRequested = true;
+            tAborted = runAcquisitionBenchmarkLoop();
+            MeasurementControl.StopRequested = false;
+            if (!tAborted) {
+                computeAcquisitionStatistics(&tPackedResult);
+                AcquisitionBenchmarkResults[i].PackedCyclesPerSample = tPackedResult.CyclesPerSample;
+            }
+        }
+    }
+    MeasurementControl.isDeepMemoryMode = tOldDeepMemoryMode;
+    AcquisitionInfo.isBenchmarkActive = false;
+    linearizePreTriggerBuffer();
+
+    MeasurementControl.TimebaseNewIndex = tOldTimebaseIndex;
+    changeTimeBase(false);
+    resetAcquisitionStatistics();
+    if (tAborted) {
+        // wait for end of aborting touch
+        do {
+            delayMillis(10);
+            checkAndHandleEvents();
+        } while (!sNothingTouched);
+        sDisableTouchUpOnce = true;
+        FeedbackToneOK();
+    }
+    drawAcquisitionBenchmarkResults();
+
+    waitForTouchAndRelease();
+
+    if (MeasurementControl.isRunning) {
+        startAcquisition();
+    }
+    BlueDisplay1.clearDisplay(COLOR_BACKGROUND_DSO);
+    drawDSOMoreSettingsPageGui();
+}
+
+/**
+ * Captures DATABUFFER_NUMBER_OF_SEGMENTS consecutive trigger events into DataBuffer without display work in between
+ * and shows the segments afterwards. Each touch shows the next segment, touch on last segment returns to settings.
+ * Timebase is clipped to the range which supports segment mode and restored afterwards.
+ */
+void doSegmentCapture(TouchButton * const aTheTouchedButton, int16_t aValue) {
+    FeedbackToneOK();
+    // stop running acquisition
+    ADC_StopConversion(DSO_ADC_ID );
+    ADC_disableEOCInterrupt(DSO_ADC_ID );
+    MeasurementControl.StopRequested = false;
+    MeasurementControl.isSingleShotMode = false;
+
+    int tOldTimebaseIndex = MeasurementControl.TimebaseIndex;
+    if (tOldTimebaseIndex < TIMEBASE_INDEX_SEGMENT_START) {
+        MeasurementControl.TimebaseNewIndex = TIMEBASE_INDEX_SEGMENT_START;
+    } else if (tOldTimebaseIndex > TIMEBASE_INDEX_SEGMENT_END) {
+        MeasurementControl.TimebaseNewIndex = TIMEBASE_INDEX_SEGMENT_END;
+    }
+    if (MeasurementControl.TimebaseNewIndex != tOldTimebaseIndex) {
+        changeTimeBase(false);
+    }
+
+    BlueDisplay1.clearDisplay(COLOR_BACKGROUND_DSO);
+    BlueDisplay1.drawText(INFO_LEFT_MARGIN, INFO_UPPER_MARGIN, "Capturing segments", TEXT_SIZE_11, COLOR_BLACK,
+            COLOR_INFO_BACKGROUND);
+
+    MeasurementControl.isSegmentMode = true;
+    startAcquisition();
+    // ends by trigger timeout at the latest
+    while (!DataBufferControl.DataBufferFull) {
+        checkAndHandleEvents();
+    }
+    MeasurementControl.isSegmentMode = false;
+    adjustSegmentsPreTriggerBuffer();
+
+    for (int i = 0; i <= DataBufferControl.SegmentIndex; ++i) {
+        drawSegment(i);
+        waitForTouchAndRelease();
+    }
+
+    if (MeasurementControl.TimebaseIndex != tOldTimebaseIndex) {
+        MeasurementControl.TimebaseNewIndex = tOldTimebaseIndex;
+        changeTimeBase(false);
+    }
+    if (MeasurementControl.isRunning) {
+        startAcquisition();
+    }
+    BlueDisplay1.clearDisplay(COLOR_BACKGROUND_DSO);
+    drawDSOMoreSettingsPageGui();
+}
+
+/**
+ * Captures the whole data buffer with the actual settings for autoset. Trigger must be off.
+ */
+static void captureAutosetBuffer(void) {
+    // use whole data buffer
+    MeasurementControl.StopRequested = true;
+    startAcquisition();
+    while (!DataBufferControl.DataBufferFull) {
+        checkAndHandleEvents();
+    }
+    MeasurementControl.StopRequested = false;
+    AutosetInfo.CaptureCount++;
+}
+
+/**
+ * Sets input range, timebase, offset and trigger level for the signal in a bounded time.
+ * First capture is done with the widest input range, each capture sets range and timebase in one step
+ * and the next capture confirms or corrects them. At most AUTOSET_MAX_CAPTURES captures are taken.
+ * Timebases with draw while acquire are not selected by autoset, since they need seconds for a capture.
+ * The time until the settings are stable is shown in the info line.
+ */
+void doAutoset(TouchButton * const aTheTouchedButton, int16_t aValue) {
+#ifdef LOCAL_DISPLAY_EXISTS
+    if (MeasurementControl.ADS7846ChannelsAsDatasource) {
+        FeedbackTone(FEEDBACK_TONE_SHORT_ERROR);
+        return;
+    }
+#endif
+    FeedbackToneOK();
+    AutosetInfo.StartMillis = getMillisSinceBoot();
+    AutosetInfo.CaptureCount = 0;
+    // stop running acquisition
+    ADC_StopConversion(DSO_ADC_ID );
+    ADC_disableEOCInterrupt(DSO_ADC_ID );
+    MeasurementControl.StopRequested = false;
+    MeasurementControl.isSingleShotMode = false;
+    MeasurementControl.ChangeRequestedFlags = 0;
+
+    // trigger off gives no pre trigger area and needs no trigger timeout
+    uint8_t tOldTriggerMode = MeasurementControl.TriggerMode;
+    MeasurementControl.TriggerMode = TRIGGER_MODE_OFF;
+    if (isAttenuatorAvailable) {
+        setInputRange(NUMBER_OF_RANGES - 1);
+    } else {
+        setInputRange(NO_ATTENUATOR_MAX_RANGE_INDEX);
+    }
+    MeasurementControl.TimebaseNewIndex = AUTOSET_TIMEBASE_INDEX_FIRST;
+    changeTimeBase(false);
+
+    bool tIsStable = false;
+    while (!tIsStable && AutosetInfo.CaptureCount < AUTOSET_MAX_CAPTURES) {
+        captureAutosetBuffer();
+        analyzeAutosetCapture();
+        tIsStable = setAutosetInputRange();
+        int tNewTimebaseIndex = computeAutosetTimebaseIndex();
+        if (tNewTimebaseIndex != MeasurementControl.TimebaseIndex) {
+            tIsStable = false;
+            MeasurementControl.TimebaseNewIndex = tNewTimebaseIndex;
+            changeTimeBase(false);
+        }
+    }
+    MeasurementControl.TriggerMode = tOldTriggerMode;
+    setAutosetOffsetAndTrigger();
+    AutosetInfo.MillisToStable = getMillisSinceBoot() - AutosetInfo.StartMillis;
+    resetAcquisitionStatistics();
+    FeedbackToneOK();
+
+    DisplayControl.DisplayPage = CHART;
+    DisplayControl.showInfoMode = LONG_INFO;
+    if (MeasurementControl.isRunning) {
+        startAcquisition();
+    } else {
+        DataBufferControl.DataBufferDisplayStart = &DataBufferControl.DataBuffer[0];
+    }
+    redrawDisplay();
+}
+
 /***********************************************************************
  * GUI initialisation and drawing stuff
  ***********************************************************************/
@@ -1253,6 +1880,11 @@ void initDSOGUI(void) {
      */
 
     // 1. row
+    // Button for display filter
+    TouchButtonFilter = TouchButton::allocAndInitSimpleButton(0, tPosY, BUTTON_WIDTH_3, BUTTON_HEIGHT_4,
+            COLOR_GUI_DISPLAY_CONTROL, FilterButtonStrings[DisplayControl.FilterType], TEXT_SIZE_11, BUTTON_FLAG_DO_BEEP_ON_TOUCH, 0,
+            &doFilterType);
+
     // Button for Singleshot
     TouchButtonSingleshot = TouchButton::allocAndInitSimpleButton(BUTTON_WIDTH_3_POS_2, tPosY, BUTTON_WIDTH_3, BUTTON_HEIGHT_4,
             COLOR_GUI_CONTROL, "Singleshot", TEXT_SIZE_11, BUTTON_FLAG_DO_BEEP_ON_TOUCH, 0, &doStartSingleshot);
@@ -1268,15 +1900,26 @@ void initDSOGUI(void) {
             COLOR_GUI_SOURCE_TIMEBASE, StringLoad, TEXT_SIZE_11, BUTTON_FLAG_DO_BEEP_ON_TOUCH, MODE_LOAD,
             &doStoreLoadAcquisitionData);
 
+    // Button for action on mask test failure
+    TouchButtonMaskFailure = TouchButton::allocAndInitSimpleButton(BUTTON_WIDTH_5_POS_3, tPosY, BUTTON_WIDTH_5, BUTTON_HEIGHT_4,
+            COLOR_GUI_TRIGGER, MaskFailureButtonStrings[MaskTest.FailureAction], TEXT_SIZE_11, BUTTON_FLAG_DO_BEEP_ON_TOUCH, 0,
+            &doMaskFailureAction);
+
     // big start stop button
     TouchButtonStartStopDSOMeasurement = TouchButton::allocAndInitSimpleButton(BUTTON_WIDTH_3_POS_3, tPosY, BUTTON_WIDTH_3,
             (2 * BUTTON_HEIGHT_4) + BUTTON_DEFAULT_SPACING, COLOR_GUI_CONTROL, "Start/Stop", TEXT_SIZE_11,
             BUTTON_FLAG_DO_BEEP_ON_TOUCH, 0, &doStartStopDSO);
 
+    // 3. row
+    tPosY += BUTTON_HEIGHT_4_LINE_2;
+    // Button for mask test
+    TouchButtonMask = TouchButton::allocAndInitSimpleButton(0, tPosY, BUTTON_WIDTH_3, BUTTON_HEIGHT_4, COLOR_GUI_TRIGGER,
+            MaskButtonStrings[MaskTest.ToleranceIndex], TEXT_SIZE_11, BUTTON_FLAG_DO_BEEP_ON_TOUCH, 0, &doMaskTest);
+
     // 4. row
-    tPosY += 2 * BUTTON_HEIGHT_4_LINE_2;
+    tPosY += BUTTON_HEIGHT_4_LINE_2;
     // Button for show FFT
-    TouchButtonFFT = TouchButton::allocAndInitSimpleButton(0, tPosY, BUTTON_WIDTH_3, BUTTON_HEIGHT_4, COLOR_GREEN, "FFT",
+    TouchButtonFFT = TouchButton::allocAndInitSimpleButton(0, tPosY, BUTTON_WIDTH_3, BUTTON_HEIGHT_4, COLOR_GREEN, FFTButtonString,
             TEXT_SIZE_11, BUTTON_FLAG_DO_BEEP_ON_TOUCH, DisplayControl.ShowFFT, &doShowFFT);
     TouchButtonFFT->setRedGreenButtonColor();
 
@@ -1333,12 +1976,21 @@ void initDSOGUI(void) {
             COLOR_GUI_SOURCE_TIMEBASE, ADCInputMUXChannelStrings[MeasurementControl.ADCInputMUXChannelIndex], TEXT_SIZE_11,
             BUTTON_FLAG_DO_BEEP_ON_TOUCH, MeasurementControl.ADCInputMUXChannelIndex, &doChannelSelect);
 
+    // Button for roll mode
+    TouchButtonRollModeOnOff = TouchButton::allocAndInitSimpleButton(BUTTON_WIDTH_3_POS_3, tPosY, BUTTON_WIDTH_3, BUTTON_HEIGHT_4,
+            COLOR_BLACK, "Roll", TEXT_SIZE_11, BUTTON_FLAG_DO_BEEP_ON_TOUCH, MeasurementControl.isRollMode, &doRollModeOnOff);
+    TouchButtonRollModeOnOff->setRedGreenButtonColor();
+
     // 4. row
     tPosY += BUTTON_HEIGHT_4_LINE_2;
     // Button for chart history (erase color)
     TouchButtonChartHistory = TouchButton::allocAndInitSimpleButton(BUTTON_WIDTH_3_POS_2, tPosY, BUTTON_WIDTH_3, BUTTON_HEIGHT_4,
             COLOR_GUI_DISPLAY_CONTROL, ChartHistoryButtonString, TEXT_SIZE_11, BUTTON_FLAG_DO_BEEP_ON_TOUCH, 0, &doChartHistory);
 
+    // Button for FFT settings page - at the position of the FFT button of start page
+    TouchButtonFFTSettings = TouchButton::allocAndInitSimpleButton(0, tPosY, BUTTON_WIDTH_3, BUTTON_HEIGHT_4, COLOR_GUI_CONTROL,
+            "FFT...", TEXT_SIZE_11, BUTTON_FLAG_DO_BEEP_ON_TOUCH, 0, &doFFTSettings);
+
     // Button for more-settings pages
     TouchButtonDSOMoreSettings = TouchButton::allocAndInitSimpleButton(BUTTON_WIDTH_3_POS_3, tPosY, BUTTON_WIDTH_3, BUTTON_HEIGHT_4,
             COLOR_GUI_CONTROL, StringMore, TEXT_SIZE_11, BUTTON_FLAG_DO_BEEP_ON_TOUCH, 0, &doMoreSettings);
@@ -1366,20 +2018,89 @@ void initDSOGUI(void) {
     // Button for trigger line mode
     TouchButtonDrawModeTriggerLine = TouchButton::allocAndInitSimpleButton(BUTTON_WIDTH_3_POS_2, tPosY, BUTTON_WIDTH_3,
             BUTTON_HEIGHT_4, COLOR_GUI_DISPLAY_CONTROL, DrawModeTriggerLineButtonString, TEXT_SIZE_11, BUTTON_FLAG_DO_BEEP_ON_TOUCH,
-            DisplayControl.DisplayBufferDrawMode & DRAW_MODE_TRIGGER, &doDrawModeTriggerLine);
+            ((DisplayControl.DisplayBufferDrawMode & DRAW_MODE_TRIGGER) != 0)
+                    + ((DisplayControl.DisplayBufferDrawMode & DRAW_MODE_DECODE) != 0), &doDrawModeTriggerLine);
     TouchButtonDrawModeTriggerLine->setRedGreenButtonColor();
 
+    // Button for packed deep memory
+    TouchButtonDeepMemoryOnOff = TouchButton::allocAndInitSimpleButton(BUTTON_WIDTH_3_POS_3, tPosY, BUTTON_WIDTH_3,
+            BUTTON_HEIGHT_4, COLOR_BLACK, "Deep mem", TEXT_SIZE_11, BUTTON_FLAG_DO_BEEP_ON_TOUCH,
+            MeasurementControl.isDeepMemoryMode, &doDeepMemoryOnOff);
+    TouchButtonDeepMemoryOnOff->setRedGreenButtonColor();
+
+    // 3. row
+    tPosY += BUTTON_HEIGHT_4_LINE_2;
+    // Button for acquisition benchmark
+    TouchButtonAcquisitionBenchmark = TouchButton::allocAndInitSimpleButton(0, tPosY, BUTTON_WIDTH_3, BUTTON_HEIGHT_4,
+            COLOR_GUI_SOURCE_TIMEBASE, "Benchmark", TEXT_SIZE_11, BUTTON_FLAG_DO_BEEP_ON_TOUCH, 0, &doAcquisitionBenchmark);
+
+    // Button for peak detect mode
+    TouchButtonPeakDetectOnOff = TouchButton::allocAndInitSimpleButton(BUTTON_WIDTH_3_POS_2, tPosY, BUTTON_WIDTH_3,
+            BUTTON_HEIGHT_4, COLOR_BLACK, "Peak detect", TEXT_SIZE_11, BUTTON_FLAG_DO_BEEP_ON_TOUCH,
+            MeasurementControl.isPeakDetectMode, &doPeakDetectOnOff);
+    TouchButtonPeakDetectOnOff->setRedGreenButtonColor();
+
+    // Button for segment capture
+    TouchButtonSegmentCapture = TouchButton::allocAndInitSimpleButton(BUTTON_WIDTH_3_POS_3, tPosY, BUTTON_WIDTH_3,
+            BUTTON_HEIGHT_4, COLOR_GUI_SOURCE_TIMEBASE, "Segments", TEXT_SIZE_11, BUTTON_FLAG_DO_BEEP_ON_TOUCH, 0,
+            &doSegmentCapture);
+
     TouchSlider::resetDefaults();
 
-#ifdef LOCAL_DISPLAY_EXISTS
     // 4. row
-    tPosY += 2 * BUTTON_HEIGHT_4_LINE_2;
+    tPosY += BUTTON_HEIGHT_4_LINE_2;
+#ifdef LOCAL_DISPLAY_EXISTS
     // Button for ADS7846 channel
     TouchButtonADS7846TestOnOff = TouchButton::allocAndInitSimpleButton(0, tPosY, BUTTON_WIDTH_3, BUTTON_HEIGHT_4, COLOR_BLACK,
             StringSettingsButtonStringADS7846Test, TEXT_SIZE_11, BUTTON_FLAG_DO_BEEP_ON_TOUCH,
             MeasurementControl.ADS7846ChannelsAsDatasource, &doADS7846TestOnOff);
     TouchButtonADS7846TestOnOff->setRedGreenButtonColor();
+#endif
+
+    // Button for statistics computed while acquiring
+    TouchButtonStreamingStatisticsOnOff = TouchButton::allocAndInitSimpleButton(BUTTON_WIDTH_3_POS_2, tPosY, BUTTON_WIDTH_3,
+            BUTTON_HEIGHT_4, COLOR_BLACK, "ISR stats", TEXT_SIZE_11, BUTTON_FLAG_DO_BEEP_ON_TOUCH,
+            MeasurementControl.isStreamingStatisticsMode, &doStreamingStatisticsOnOff);
+    TouchButtonStreamingStatisticsOnOff->setRedGreenButtonColor();
+
+    // Button for autoset
+    TouchButtonAutoset = TouchButton::allocAndInitSimpleButton(BUTTON_WIDTH_3_POS_3, tPosY, BUTTON_WIDTH_3, BUTTON_HEIGHT_4,
+            COLOR_GUI_TRIGGER, "Autoset", TEXT_SIZE_11, BUTTON_FLAG_DO_BEEP_ON_TOUCH, 0, &doAutoset);
 
+    /*
+     * FFT settings page - FFT on off button of start page is also shown at 4. row
+     */
+    // 1. row
+    tPosY = 0;
+    // Button for FFT window
+    TouchButtonFFTWindow = TouchButton::allocAndInitSimpleButton(0, tPosY, BUTTON_WIDTH_3, BUTTON_HEIGHT_4,
+            COLOR_GUI_DISPLAY_CONTROL, FFTWindowButtonStrings[DisplayControl.FFTWindowType], TEXT_SIZE_11,
+            BUTTON_FLAG_DO_BEEP_ON_TOUCH, 0, &doFFTWindow);
+
+    // Button for FFT scale
+    TouchButtonFFTScale = TouchButton::allocAndInitSimpleButton(BUTTON_WIDTH_3_POS_2, tPosY, BUTTON_WIDTH_3, BUTTON_HEIGHT_4,
+            COLOR_GUI_DISPLAY_CONTROL, FFTScaleButtonStringLinear, TEXT_SIZE_11, BUTTON_FLAG_DO_BEEP_ON_TOUCH, 0, &doFFTScale);
+    if (DisplayControl.FFTShowDB) {
+        TouchButtonFFTScale->setCaption(FFTScaleButtonStringDB);
+    }
+
+    // 2. row
+    tPosY += BUTTON_HEIGHT_4_LINE_2;
+    // Button for FFT averaging
+    TouchButtonFFTAverage = TouchButton::allocAndInitSimpleButton(0, tPosY, BUTTON_WIDTH_3, BUTTON_HEIGHT_4,
+            COLOR_GUI_DISPLAY_CONTROL, FFTAverageButtonStrings[DisplayControl.FFTAverageMode], TEXT_SIZE_11,
+            BUTTON_FLAG_DO_BEEP_ON_TOUCH, 0, &doFFTAverage);
+
+    // Button for FFT waterfall
+    TouchButtonFFTWaterfall = TouchButton::allocAndInitSimpleButton(BUTTON_WIDTH_3_POS_2, tPosY, BUTTON_WIDTH_3,
+            BUTTON_HEIGHT_4, COLOR_GUI_CONTROL, "Waterfall", TEXT_SIZE_11, BUTTON_FLAG_DO_BEEP_ON_TOUCH, 0, &doFFTWaterfall);
+
+    // Button for harmonic analysis
+    TouchButtonHarmonics = TouchButton::allocAndInitSimpleButton(BUTTON_WIDTH_3_POS_3, tPosY, BUTTON_WIDTH_3, BUTTON_HEIGHT_4,
+            COLOR_BLACK, "THD", TEXT_SIZE_11, BUTTON_FLAG_DO_BEEP_ON_TOUCH, DisplayControl.ShowHarmonics, &doHarmonics);
+    TouchButtonHarmonics->setRedGreenButtonColor();
+
+#ifdef LOCAL_DISPLAY_EXISTS
     /*
      * Backlight slider
      */
@@ -1422,10 +2143,14 @@ void activateCommonPartOfGui(void) {
  * activate elements active while measurement is stopped and data is shown
  */
 void activateAnalysisOnlyPartOfGui(void) {
+    TouchButtonFilter->activate();
     TouchButtonSingleshot->activate();
 
     TouchButtonStore->activate();
     TouchButtonLoad->activate();
+    TouchButtonMaskFailure->activate();
+
+    TouchButtonMask->activate();
 }
 
 /**
@@ -1457,16 +2182,35 @@ void drawCommonPartOfGui(void) {
     TouchButtonFFT->drawButton();
 }
 
+/*
+ * Spectrogram of the running FFT - no trace, grid or info is drawn on this page
+ */
+void drawDSOWaterfallPageGui(void) {
+    DisplayControl.DisplayPage = WATERFALL;
+    TouchButton::deactivateAllButtons();
+    TouchSlider::deactivateAllSliders();
+
+    BlueDisplay1.drawText(INFO_LEFT_MARGIN, INFO_UPPER_MARGIN + TEXT_SIZE_11_ASCEND, "Waterfall", TEXT_SIZE_11, COLOR_BLACK,
+            COLOR_BACKGROUND_DSO);
+    TouchButtonBack->drawButton();
+    drawWaterfall();
+}
+
 /**
  * draws elements active while measurement is stopped and data is shown
  */
 void drawAnalysisOnlyPartOfGui(void) {
     //1. Row
+    TouchButtonFilter->drawButton();
     TouchButtonSingleshot->drawButton();
 
     //2. Row
     TouchButtonStore->drawButton();
     TouchButtonLoad->drawButton();
+    TouchButtonMaskFailure->drawButton();
+
+    //3. Row
+    TouchButtonMask->drawButton();
 
     BlueDisplay1.drawText(BUTTON_WIDTH_3, BUTTON_HEIGHT_4_LINE_3 + TEXT_SIZE_22_ASCEND, "\xABScale\xBB", TEXT_SIZE_22, COLOR_YELLOW,
             COLOR_BACKGROUND_DSO);
@@ -1521,9 +2265,10 @@ void drawDSOSettingsPageGui(void) {
     //3. Row
     TouchButtonShowPretriggerValuesOnOff->drawButton();
     TouchButtonChannelSelect->drawButton();
+    TouchButtonRollModeOnOff->drawButton();
 
     // 4. Row
-    TouchButtonFFT->drawButton();
+    TouchButtonFFTSettings->drawButton();
     TouchButtonChartHistory->drawButton();
     TouchButtonBack->drawButton();
 
@@ -1550,12 +2295,40 @@ void drawDSOMoreSettingsPageGui(void) {
 
     //2. Row
     TouchButtonCalibrateVoltage->drawButton();
+    TouchButtonDeepMemoryOnOff->drawButton();
+
+    //3. Row
+    TouchButtonAcquisitionBenchmark->drawButton();
+    TouchButtonPeakDetectOnOff->drawButton();
+    TouchButtonSegmentCapture->drawButton();
 
     // 4. Row
+    TouchButtonStreamingStatisticsOnOff->drawButton();
     TouchButtonADS7846TestOnOff->drawButton();
+    TouchButtonAutoset->drawButton();
     TouchButtonBack->drawButton();
 }
 
+void drawDSOFFTSettingsPageGui(void) {
+    DisplayControl.DisplayPage = FFT_SETTINGS;
+    // deactivate all gui and show FFT setting elements
+    TouchButton::deactivateAllButtons();
+    TouchSlider::deactivateAllSliders();
+
+    //1. Row
+    TouchButtonFFTWindow->drawButton();
+    TouchButtonFFTScale->drawButton();
+    TouchButtonBack->drawButton();
+
+    //2. Row
+    TouchButtonFFTAverage->drawButton();
+    TouchButtonFFTWaterfall->drawButton();
+    TouchButtonHarmonics->drawButton();
+
+    // 4. Row
+    TouchButtonFFT->drawButton();
+}
+
 void redrawDisplay(void) {
     redrawDisplay(true);
 }
@@ -1569,6 +2342,10 @@ void redrawDisplay(bool doClearbefore) {
     if (doClearbefore) {
         BlueDisplay1.clearDisplay(COLOR_BACKGROUND_DSO);
     }
+    if (DisplayControl.DisplayPage == WATERFALL) {
+        drawDSOWaterfallPageGui();
+        return;
+    }
     if (MeasurementControl.isRunning) {
         if (DisplayControl.DisplayPage >= SETTINGS) {
             drawDSOSettingsPageGui();
@@ -1580,6 +2357,9 @@ void redrawDisplay(bool doClearbefore) {
         }
         // show grid and labels - not really needed, since after MILLIS_BETWEEN_INFO_OUTPUT it is done by loop
         drawGridLinesWithHorizLabelsAndTriggerLine(COLOR_GRID_LINES);
+        if (DisplayControl.DisplayPage < SETTINGS) {
+            drawMaskLimits();
+        }
         printInfo();
     } else {
         // measurement stopped -> analysis mode
@@ -1593,7 +2373,8 @@ void redrawDisplay(bool doClearbefore) {
             // show grid and labels and chart
             drawGridLinesWithHorizLabelsAndTriggerLine(COLOR_GRID_LINES);
             drawMinMaxLines();
-            drawDataBuffer(DataBufferControl.DataBufferDisplayStart, DSO_DISPLAY_WIDTH, COLOR_DATA_HOLD, 0);
+            drawMaskLimits();
+            drawDataBuffer(getDataBufferDisplayPointer(), DSO_DISPLAY_WIDTH, COLOR_DATA_HOLD, 0);
             printInfo();
         } else {
             drawDSOSettingsPageGui();
@@ -609,6 +609,10 @@ void Chart::clear(void) {
 
     bool tRetValue = true;
     int tDisplayValue;
+    // for envelope of compressed values
+    int tMaxDisplayValue = 0;
+    bool tIsEnvelope = (mXScaleFactor < -1);
+    bool tMaxIsLast = false;
 
 // used only in line mode
     int tLastValue = 0;
@@ -651,12 +655,21 @@ void Chart::clear(void) {
                 tXScaleCounter = 1;
             }
         } else if (mXScaleFactor <= -1) {
-            // compress - get average of multiple values
-            tDisplayValue = 0;
-            for (int i = 0; i < tXScaleCounter; ++i) {
-                tDisplayValue += *aDataPointer++;
+            // compress - get min (to tDisplayValue) and max of multiple values to show them as envelope. No division needed.
+            tDisplayValue = *aDataPointer++;
+            tMaxDisplayValue = tDisplayValue;
+            tMaxIsLast = false;
+            for (int i = 1; i < tXScaleCounter; ++i) {
+                int tValue = *aDataPointer++;
+                if (tValue < tDisplayValue) {
+                    tDisplayValue = tValue;
+                    tMaxIsLast = false;
+                }
+                if (tValue > tMaxDisplayValue) {
+                    tMaxDisplayValue = tValue;
+                    tMaxIsLast = true;
+                }
             }
-            tDisplayValue /= tXScaleCounter;
         } else if (mXScaleFactor == 1) {
             // expand by factor 1.5 - every second value will be shown 2 times
             tDisplayValue = *aDataPointer++;
@@ -679,6 +692,10 @@ void Chart::clear(void) {
             break;
         }
 
+        if (tIsEnvelope && aMode == CHART_MODE_AREA) {
+            // area shows max of envelope
+            tDisplayValue = tMaxDisplayValue;
+        }
         tDisplayValue = tYDisplayFactor * (tDisplayValue - tYOffset);
         // clip to bottom line
         if (tDisplayValue < 0) {
@@ -690,6 +707,31 @@ void Chart::clear(void) {
             tDisplayValue = mHeightY - 1;
             tRetValue = false;
         }
+        if (tIsEnvelope && aMode != CHART_MODE_AREA) {
+            tMaxDisplayValue = tYDisplayFactor * (tMaxDisplayValue - tYOffset);
+            if (tMaxDisplayValue < 0) {
+                tMaxDisplayValue = 0;
+            }
+            if (tMaxDisplayValue > mHeightY - 1) {
+                tMaxDisplayValue = mHeightY - 1;
+                tRetValue = false;
+            }
+            // connect last value with the first of min and max and draw vertical span between min and max
+            int tFirstDisplayValue = tMaxDisplayValue;
+            int tSecondDisplayValue = tDisplayValue;
+            if (tMaxIsLast) {
+                tFirstDisplayValue = tDisplayValue;
+                tSecondDisplayValue = tMaxDisplayValue;
+            }
+            if (aMode == CHART_MODE_LINE && !tFirstValue) {
+                mDisplay->drawLineFastOneX(tXpos - 1, mPositionY - tLastValue, mPositionY - tFirstDisplayValue, mDataColor);
+            }
+            tFirstValue = false;
+            mDisplay->fillRectRel(tXpos, mPositionY - tMaxDisplayValue, 1, tMaxDisplayValue - tDisplayValue + 1, mDataColor);
+            tLastValue = tSecondDisplayValue;
+            tXpos++;
+            continue;
+        }
         // draw first value as pixel only
         if (aMode == CHART_MODE_PIXEL || tFirstValue) {
             tFirstValue = false;
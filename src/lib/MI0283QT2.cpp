@@ -204,6 +204,33 @@ void MI0283QT2::fillRect(uint16_t aXStart, uint16_t aYStart, uint16_t aXEnd, uin
     drawStop();
 }
 
+/**
+ * Draws aHeight equal lines of color indexes with one setArea burst, used for images like the FFT waterfall
+ * @param aIndexes 8 bit values, color is aPalette[value >> aIndexShift]
+ * @param aPixelPerIndex width of each value
+ */
+void MI0283QT2::drawIndexedLines(uint16_t aXStart, uint16_t aYStart, uint8_t *aIndexes, uint16_t aLength,
+        uint8_t aPixelPerIndex, uint16_t aHeight, const uint16_t *aPalette, uint8_t aIndexShift) {
+    uint16_t tXEnd = aXStart + (aLength * aPixelPerIndex) - 1;
+    uint16_t tYEnd = aYStart + aHeight - 1;
+    if (tXEnd >= DISPLAY_WIDTH || tYEnd >= DISPLAY_HEIGHT) {
+        return;
+    }
+    setArea(aXStart, aYStart, tXEnd, tYEnd);
+
+    drawStart();
+    for (int tLine = aHeight; tLine != 0; tLine--) {
+        uint8_t * tIndexPointer = aIndexes;
+        for (int i = aLength; i != 0; i--) {
+            uint16_t tColor = aPalette[*tIndexPointer++ >> aIndexShift];
+            for (int j = aPixelPerIndex; j != 0; j--) {
+                draw(tColor);
+            }
+        }
+    }
+    drawStop();
+}
+
 void MI0283QT2::drawCircle(uint16_t aXCenter, uint16_t aYCenter, uint16_t aRadius, uint16_t aColor) {
     int16_t err, x, y;
 
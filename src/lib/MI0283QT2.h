@@ -47,6 +47,8 @@ public:
     void drawCircle(uint16_t aXCenter, uint16_t aYCenter, uint16_t aRadius, uint16_t aColor);
     void fillCircle(uint16_t aXCenter, uint16_t aYCenter, uint16_t aRadius, uint16_t aColor);
     void fillRect(uint16_t aXStart, uint16_t aYStart, uint16_t aXEnd, uint16_t aYEnd, uint16_t aColor);
+    void drawIndexedLines(uint16_t aXStart, uint16_t aYStart, uint8_t *aIndexes, uint16_t aLength, uint8_t aPixelPerIndex,
+            uint16_t aHeight, const uint16_t *aPalette, uint8_t aIndexShift);
     uint16_t drawChar(uint16_t aPosX, uint16_t aPosY, char aChar, uint8_t aCharSize, uint16_t aFGColor, uint16_t aBGColor);
     uint16_t drawText(uint16_t aXStart, uint16_t aYStart, char *aStringPtr, uint8_t aSize, uint16_t aColor, uint16_t aBGColor);
     void drawTextVertical(uint16_t aXPos, uint16_t aYPos, const char *aStringPointer, uint8_t aSize, uint16_t aColor,
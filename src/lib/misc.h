@@ -136,7 +136,12 @@ extern const char StringPrint[6];
 
 __attribute__( ( always_inline ))        static inline uint32_t getLR14(void) {
     uint32_t result;
+#ifdef __arm__
     asm volatile ("MOV %0, lr" : "=r" (result) );
+#else
+    // host build
+    result = (uint32_t) (uintptr_t) __builtin_return_address(0);
+#endif
     return (result);
 }
 